@@ -61,11 +61,10 @@ public:
             }
             else
             {
-                fx::gltf::BufferView const & bufferView = doc.bufferViews[image.bufferView];
-                fx::gltf::Buffer const & buffer = doc.buffers[bufferView.buffer];
+                fx::gltf::Span<uint8_t const> bufferViewData = fx::gltf::GetData(doc, doc.bufferViews[image.bufferView]);
 
-                m_info.BinaryData = &buffer.data[bufferView.byteOffset];
-                m_info.BinarySize = bufferView.byteLength;
+                m_info.BinaryData = bufferViewData.data();
+                m_info.BinarySize = static_cast<uint32_t>(bufferViewData.size());
             }
         }
     }
@@ -99,57 +99,7 @@ private:
 
     static BufferInfo GetData(fx::gltf::Document const & doc, fx::gltf::Accessor const & accessor)
     {
-        fx::gltf::BufferView const & bufferView = doc.bufferViews[accessor.bufferView];
-        fx::gltf::Buffer const & buffer = doc.buffers[bufferView.buffer];
-
-        const uint32_t dataTypeSize = CalculateDataTypeSize(accessor);
-        return BufferInfo{ &accessor, &buffer.data[static_cast<uint64_t>(bufferView.byteOffset) + accessor.byteOffset], dataTypeSize, accessor.count * dataTypeSize };
-    }
-
-    static uint32_t CalculateDataTypeSize(fx::gltf::Accessor const & accessor) noexcept
-    {
-        uint32_t elementSize = 0;
-        switch (accessor.componentType)
-        {
-        case fx::gltf::Accessor::ComponentType::Byte:
-        case fx::gltf::Accessor::ComponentType::UnsignedByte:
-            elementSize = 1;
-            break;
-        case fx::gltf::Accessor::ComponentType::Short:
-        case fx::gltf::Accessor::ComponentType::UnsignedShort:
-            elementSize = 2;
-            break;
-        case fx::gltf::Accessor::ComponentType::Float:
-        case fx::gltf::Accessor::ComponentType::UnsignedInt:
-            elementSize = 4;
-            break;
-        }
-
-        switch (accessor.type)
-        {
-        case fx::gltf::Accessor::Type::Mat2:
-            return 4 * elementSize;
-            break;
-        case fx::gltf::Accessor::Type::Mat3:
-            return 9 * elementSize;
-            break;
-        case fx::gltf::Accessor::Type::Mat4:
-            return 16 * elementSize;
-            break;
-        case fx::gltf::Accessor::Type::Scalar:
-            return elementSize;
-            break;
-        case fx::gltf::Accessor::Type::Vec2:
-            return 2 * elementSize;
-            break;
-        case fx::gltf::Accessor::Type::Vec3:
-            return 3 * elementSize;
-            break;
-        case fx::gltf::Accessor::Type::Vec4:
-            return 4 * elementSize;
-            break;
-        }
-
-        return 0;
+        const uint32_t dataTypeSize = fx::gltf::GetElementSize(accessor);
+        return BufferInfo{ &accessor, fx::gltf::GetData(doc, accessor).data(), dataTypeSize, accessor.count * dataTypeSize };
     }
 };
@@ -5,15 +5,34 @@
 // ------------------------------------------------------------
 #pragma once
 
+#include <algorithm>
 #include <array>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
 #include <cstring>
+#include <exception>
 #include <fstream>
+#include <functional>
+#include <future>
 #include <istream>
+#include <iterator>
+#include <limits>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <numeric>
 #include <ostream>
 #include <stdexcept>
+#include <streambuf>
 #include <string>
 #include <system_error>
+#include <thread>
+#include <type_traits>
 #include <unordered_map>
+#include <utility>
 #include <vector>
 
 #include <nlohmann/json.hpp>
@@ -23,6 +42,11 @@
     #define FX_GLTF_NODISCARD [[nodiscard]]
     #define FX_GLTF_INLINE_CONSTEXPR inline constexpr
     #include <string_view>
+    #if defined(__has_include)
+        #if __has_include(<charconv>)
+            #include <charconv>
+        #endif
+    #endif
 #else
     #define FX_GLTF_NODISCARD
     #define FX_GLTF_INLINE_CONSTEXPR constexpr
@@ -50,6 +74,52 @@
     #define FX_GLTF_FILESYSTEM std::filesystem
 #endif
 
+// Define FX_GLTF_ENABLE_MMAP for LoadFromTextMapped and LoadFromBinaryMapped to map files through the operating system
+// (which brings in <windows.h> on Windows); otherwise they read each file into a single allocation instead
+#if defined(FX_GLTF_ENABLE_MMAP) && defined(_WIN32)
+    #ifndef WIN32_LEAN_AND_MEAN
+        #define WIN32_LEAN_AND_MEAN
+        #define FX_GLTF_UNDEF_WIN32_LEAN_AND_MEAN
+    #endif
+    #ifndef NOMINMAX
+        #define NOMINMAX
+        #define FX_GLTF_UNDEF_NOMINMAX
+    #endif
+    #include <windows.h>
+    #ifdef FX_GLTF_UNDEF_WIN32_LEAN_AND_MEAN
+        #undef WIN32_LEAN_AND_MEAN
+        #undef FX_GLTF_UNDEF_WIN32_LEAN_AND_MEAN
+    #endif
+    #ifdef FX_GLTF_UNDEF_NOMINMAX
+        #undef NOMINMAX
+        #undef FX_GLTF_UNDEF_NOMINMAX
+    #endif
+#elif defined(FX_GLTF_ENABLE_MMAP)
+    #include <fcntl.h>
+    #include <sys/mman.h>
+    #include <sys/stat.h>
+    #include <unistd.h>
+#endif
+
+// Vector paths are chosen at compile time from the target flags (e.g. -mavx2 or /arch:AVX2); define
+// FX_GLTF_NO_SIMD to always use the portable scalar code
+#if !defined(FX_GLTF_NO_SIMD)
+    #if defined(__AVX2__)
+        #define FX_GLTF_SIMD_AVX2
+        #include <immintrin.h>
+    #elif defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+        #define FX_GLTF_SIMD_SSE2
+        #include <emmintrin.h>
+        #if defined(__SSSE3__) || defined(__AVX__)
+            #define FX_GLTF_SIMD_SSSE3
+            #include <tmmintrin.h>
+        #endif
+    #elif defined(__aarch64__) || defined(_M_ARM64)
+        #define FX_GLTF_SIMD_NEON
+        #include <arm_neon.h>
+    #endif
+#endif
+
 namespace fx
 {
 namespace base64
@@ -87,108 +157,403 @@ namespace base64
         // clang-format on
     } // namespace detail
 
-    inline std::string Encode(std::vector<uint8_t> const & bytes)
+    namespace detail
     {
-        const std::size_t length = bytes.size();
-        if (length == 0)
+        // Translates 12 or 24 bytes at a time (Muła and Lemire, "Faster Base64 Encoding and Decoding Using AVX2
+        // Instructions"). The loads read 4 bytes past the group being encoded so the loops stop early enough to
+        // stay inside the input.
+#if defined(FX_GLTF_SIMD_AVX2)
+        inline std::size_t EncodeBlocks(uint8_t const * bytes, std::size_t length, char * out) noexcept
         {
-            return {};
+            const __m256i shuffle = _mm256_setr_epi8(
+                1, 0, 2, 1, 4, 3, 5, 4, 7, 6, 8, 7, 10, 9, 11, 10,
+                1, 0, 2, 1, 4, 3, 5, 4, 7, 6, 8, 7, 10, 9, 11, 10);
+            const __m256i lut = _mm256_setr_epi8(
+                65, 71, -4, -4, -4, -4, -4, -4, -4, -4, -4, -4, -19, -16, 0, 0,
+                65, 71, -4, -4, -4, -4, -4, -4, -4, -4, -4, -4, -19, -16, 0, 0);
+
+            std::size_t i = 0;
+            std::size_t written = 0;
+            for (; i + 28 <= length; i += 24, written += 32)
+            {
+                const __m128i lo = _mm_loadu_si128(reinterpret_cast<__m128i const *>(bytes + i));
+                const __m128i hi = _mm_loadu_si128(reinterpret_cast<__m128i const *>(bytes + i + 12));
+                const __m256i input = _mm256_shuffle_epi8(_mm256_inserti128_si256(_mm256_castsi128_si256(lo), hi, 1), shuffle);
+
+                // Spread each 24-bit group over four bytes holding 6 bits each
+                const __m256i t0 = _mm256_mulhi_epu16(_mm256_and_si256(input, _mm256_set1_epi32(0x0FC0FC00)), _mm256_set1_epi32(0x04000040));
+                const __m256i t1 = _mm256_mullo_epi16(_mm256_and_si256(input, _mm256_set1_epi32(0x003F03F0)), _mm256_set1_epi32(0x01000010));
+                const __m256i indices = _mm256_or_si256(t0, t1);
+
+                __m256i offsets = _mm256_subs_epu8(indices, _mm256_set1_epi8(51));
+                offsets = _mm256_sub_epi8(offsets, _mm256_cmpgt_epi8(indices, _mm256_set1_epi8(25)));
+                const __m256i text = _mm256_add_epi8(indices, _mm256_shuffle_epi8(lut, offsets));
+                _mm256_storeu_si256(reinterpret_cast<__m256i *>(out + written), text);
+            }
+
+            return i;
         }
+#elif defined(FX_GLTF_SIMD_SSSE3)
+        inline std::size_t EncodeBlocks(uint8_t const * bytes, std::size_t length, char * out) noexcept
+        {
+            const __m128i shuffle = _mm_setr_epi8(1, 0, 2, 1, 4, 3, 5, 4, 7, 6, 8, 7, 10, 9, 11, 10);
+            const __m128i lut = _mm_setr_epi8(65, 71, -4, -4, -4, -4, -4, -4, -4, -4, -4, -4, -19, -16, 0, 0);
 
-        std::string out{};
-        out.reserve(((length * 4 / 3) + 3) & (~3u)); // round up to nearest 4
+            std::size_t i = 0;
+            std::size_t written = 0;
+            for (; i + 16 <= length; i += 12, written += 16)
+            {
+                const __m128i input = _mm_shuffle_epi8(_mm_loadu_si128(reinterpret_cast<__m128i const *>(bytes + i)), shuffle);
+
+                const __m128i t0 = _mm_mulhi_epu16(_mm_and_si128(input, _mm_set1_epi32(0x0FC0FC00)), _mm_set1_epi32(0x04000040));
+                const __m128i t1 = _mm_mullo_epi16(_mm_and_si128(input, _mm_set1_epi32(0x003F03F0)), _mm_set1_epi32(0x01000010));
+                const __m128i indices = _mm_or_si128(t0, t1);
+
+                __m128i offsets = _mm_subs_epu8(indices, _mm_set1_epi8(51));
+                offsets = _mm_sub_epi8(offsets, _mm_cmpgt_epi8(indices, _mm_set1_epi8(25)));
+                const __m128i text = _mm_add_epi8(indices, _mm_shuffle_epi8(lut, offsets));
+                _mm_storeu_si128(reinterpret_cast<__m128i *>(out + written), text);
+            }
 
-        uint32_t value = 0;
-        int32_t bitCount = -6;
-        for (const uint8_t c : bytes)
+            return i;
+        }
+#elif defined(FX_GLTF_SIMD_NEON)
+        inline std::size_t EncodeBlocks(uint8_t const * bytes, std::size_t length, char * out) noexcept
         {
-            value = (value << 8u) + c;
-            bitCount += 8;
-            while (bitCount >= 0)
+            uint8x16x4_t lut;
+            lut.val[0] = vld1q_u8(reinterpret_cast<uint8_t const *>(&EncodeMap[0]));
+            lut.val[1] = vld1q_u8(reinterpret_cast<uint8_t const *>(&EncodeMap[16]));
+            lut.val[2] = vld1q_u8(reinterpret_cast<uint8_t const *>(&EncodeMap[32]));
+            lut.val[3] = vld1q_u8(reinterpret_cast<uint8_t const *>(&EncodeMap[48]));
+
+            std::size_t i = 0;
+            std::size_t written = 0;
+            for (; i + 48 <= length; i += 48, written += 64)
             {
-                const uint32_t shiftOperand = bitCount;
-                out.push_back(detail::EncodeMap.at((value >> shiftOperand) & 0x3fu));
-                bitCount -= 6;
+                // De-interleaving the 3-byte groups makes each output character a few shifts away
+                const uint8x16x3_t input = vld3q_u8(bytes + i);
+                uint8x16x4_t text;
+                text.val[0] = vshrq_n_u8(input.val[0], 2);
+                text.val[1] = vandq_u8(vorrq_u8(vshlq_n_u8(input.val[0], 4), vshrq_n_u8(input.val[1], 4)), vdupq_n_u8(0x3F));
+                text.val[2] = vandq_u8(vorrq_u8(vshlq_n_u8(input.val[1], 2), vshrq_n_u8(input.val[2], 6)), vdupq_n_u8(0x3F));
+                text.val[3] = vandq_u8(input.val[2], vdupq_n_u8(0x3F));
+                for (uint8x16_t & value : text.val)
+                {
+                    value = vqtbl4q_u8(lut, value);
+                }
+
+                vst4q_u8(reinterpret_cast<uint8_t *>(out + written), text);
             }
+
+            return i;
+        }
+#else
+        inline std::size_t EncodeBlocks(uint8_t const *, std::size_t, char *) noexcept
+        {
+            return 0;
+        }
+#endif
+    } // namespace detail
+
+    inline constexpr std::size_t GetEncodedLength(std::size_t length) noexcept
+    {
+        return ((length + 2) / 3) * 4;
+    }
+
+    // Encodes into `out`, which must hold at least GetEncodedLength(length) characters
+    inline void Encode(uint8_t const * bytes, std::size_t length, char * out) noexcept
+    {
+        std::size_t i = detail::EncodeBlocks(bytes, length, out);
+        char * text = out + (i / 3) * 4;
+        for (; i + 3 <= length; i += 3, text += 4)
+        {
+            const uint32_t value = (static_cast<uint32_t>(bytes[i]) << 16u) | (static_cast<uint32_t>(bytes[i + 1]) << 8u) | bytes[i + 2];
+            text[0] = detail::EncodeMap[(value >> 18u) & 0x3fu];
+            text[1] = detail::EncodeMap[(value >> 12u) & 0x3fu];
+            text[2] = detail::EncodeMap[(value >> 6u) & 0x3fu];
+            text[3] = detail::EncodeMap[value & 0x3fu];
         }
 
-        if (bitCount > -6)
+        if (i < length)
         {
-            const uint32_t shiftOperand = bitCount + 8;
-            out.push_back(detail::EncodeMap.at(((value << 8u) >> shiftOperand) & 0x3fu));
+            const bool twoBytes = i + 1 < length;
+            const uint32_t value = (static_cast<uint32_t>(bytes[i]) << 16u) | (twoBytes ? static_cast<uint32_t>(bytes[i + 1]) << 8u : 0u);
+            text[0] = detail::EncodeMap[(value >> 18u) & 0x3fu];
+            text[1] = detail::EncodeMap[(value >> 12u) & 0x3fu];
+            text[2] = twoBytes ? detail::EncodeMap[(value >> 6u) & 0x3fu] : '=';
+            text[3] = '=';
         }
+    }
 
-        while (out.size() % 4 != 0)
+    inline std::string Encode(uint8_t const * bytes, std::size_t length)
+    {
+        std::string out(GetEncodedLength(length), '\0');
+        if (length != 0)
         {
-            out.push_back('=');
+            Encode(bytes, length, &out[0]);
         }
 
         return out;
     }
 
-#if defined(FX_GLTF_HAS_CPP_17)
-    inline bool TryDecode(std::string_view in, std::vector<uint8_t> & out)
-#else
-    inline bool TryDecode(std::string const & in, std::vector<uint8_t> & out)
-#endif
+    inline std::string Encode(std::vector<uint8_t> const & bytes)
     {
-        out.clear();
+        return Encode(bytes.data(), bytes.size());
+    }
 
-        const std::size_t length = in.length();
-        if (length == 0)
+    // Encodes in fixed size chunks so the full text never has to be held in memory
+    inline void Encode(uint8_t const * bytes, std::size_t length, std::ostream & output)
+    {
+        constexpr std::size_t ChunkLength = 12 * 1024;
+        std::array<char, GetEncodedLength(ChunkLength)> text{};
+        for (std::size_t i = 0; i < length; i += ChunkLength)
         {
-            return true;
+            const std::size_t chunk = length - i < ChunkLength ? length - i : ChunkLength;
+            Encode(bytes + i, chunk, text.data());
+            output.write(text.data(), static_cast<std::streamsize>(GetEncodedLength(chunk)));
         }
+    }
 
-        if (length % 4 != 0)
+    namespace detail
+    {
+        inline std::size_t GetPaddingLength(char const * in, std::size_t length) noexcept
         {
-            return false;
+            if (length < 4 || in[length - 1] != '=')
+            {
+                return 0;
+            }
+
+            return in[length - 2] == '=' ? 2 : 1;
         }
 
-        out.reserve((length / 4) * 3);
+        inline std::size_t GetDecodedLength(char const * in, std::size_t length) noexcept
+        {
+            return length % 4 != 0 ? 0 : (length / 4) * 3 - GetPaddingLength(in, length);
+        }
 
-        bool invalid = false;
-        uint32_t value = 0;
-        int32_t bitCount = -8;
-        for (std::size_t i = 0; i < length; i++)
+        // Classifies and translates 16 or 32 characters at a time with nibble lookups (Muła and Lemire, "Faster
+        // Base64 Encoding and Decoding Using AVX2 Instructions"). Blocks with anything outside of the base64
+        // alphabet, including padding, are left to the scalar loop which does the error reporting. Each block
+        // writes a full vector so there must be room for the unused trailing bytes.
+#if defined(FX_GLTF_SIMD_AVX2)
+        inline std::size_t DecodeBlocks(char const * in, std::size_t length, uint8_t * out, std::size_t outLength, std::size_t & written) noexcept
         {
-            const uint8_t c = static_cast<uint8_t>(in[i]);
-            const char map = detail::DecodeMap.at(c);
-            if (map == -1)
+            const __m256i lutLo = _mm256_setr_epi8(
+                0x15, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x13, 0x1A, 0x1B, 0x1B, 0x1B, 0x1A,
+                0x15, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x13, 0x1A, 0x1B, 0x1B, 0x1B, 0x1A);
+            const __m256i lutHi = _mm256_setr_epi8(
+                0x10, 0x10, 0x01, 0x02, 0x04, 0x08, 0x04, 0x08, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10,
+                0x10, 0x10, 0x01, 0x02, 0x04, 0x08, 0x04, 0x08, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10);
+            const __m256i lutRoll = _mm256_setr_epi8(
+                0, 16, 19, 4, -65, -65, -71, -71, 0, 0, 0, 0, 0, 0, 0, 0,
+                0, 16, 19, 4, -65, -65, -71, -71, 0, 0, 0, 0, 0, 0, 0, 0);
+            const __m256i pack = _mm256_setr_epi8(
+                2, 1, 0, 6, 5, 4, 10, 9, 8, 14, 13, 12, -1, -1, -1, -1,
+                2, 1, 0, 6, 5, 4, 10, 9, 8, 14, 13, 12, -1, -1, -1, -1);
+            const __m256i mask2F = _mm256_set1_epi8(0x2F);
+
+            std::size_t i = 0;
+            written = 0;
+            for (; i + 32 <= length && written + 32 <= outLength; i += 32, written += 24)
             {
-                if (c != '=') // Non base64 character
+                __m256i text = _mm256_loadu_si256(reinterpret_cast<__m256i const *>(in + i));
+                const __m256i hiNibbles = _mm256_and_si256(_mm256_srli_epi32(text, 4), mask2F);
+                const __m256i lo = _mm256_shuffle_epi8(lutLo, _mm256_and_si256(text, mask2F));
+                const __m256i hi = _mm256_shuffle_epi8(lutHi, hiNibbles);
+                if (!_mm256_testz_si256(lo, hi))
                 {
-                    invalid = true;
+                    break;
                 }
-                else
+
+                const __m256i roll = _mm256_shuffle_epi8(lutRoll, _mm256_add_epi8(_mm256_cmpeq_epi8(text, mask2F), hiNibbles));
+                text = _mm256_add_epi8(text, roll);
+
+                // Merge the 6-bit values into 24-bit groups, then compact the 12 bytes of each lane together
+                const __m256i merged = _mm256_madd_epi16(_mm256_maddubs_epi16(text, _mm256_set1_epi32(0x01400140)), _mm256_set1_epi32(0x00011000));
+                const __m256i packed = _mm256_permutevar8x32_epi32(_mm256_shuffle_epi8(merged, pack), _mm256_setr_epi32(0, 1, 2, 4, 5, 6, 3, 7));
+                _mm256_storeu_si256(reinterpret_cast<__m256i *>(out + written), packed);
+            }
+
+            return i;
+        }
+#elif defined(FX_GLTF_SIMD_SSSE3)
+        inline std::size_t DecodeBlocks(char const * in, std::size_t length, uint8_t * out, std::size_t outLength, std::size_t & written) noexcept
+        {
+            const __m128i lutLo = _mm_setr_epi8(0x15, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x13, 0x1A, 0x1B, 0x1B, 0x1B, 0x1A);
+            const __m128i lutHi = _mm_setr_epi8(0x10, 0x10, 0x01, 0x02, 0x04, 0x08, 0x04, 0x08, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10);
+            const __m128i lutRoll = _mm_setr_epi8(0, 16, 19, 4, -65, -65, -71, -71, 0, 0, 0, 0, 0, 0, 0, 0);
+            const __m128i pack = _mm_setr_epi8(2, 1, 0, 6, 5, 4, 10, 9, 8, 14, 13, 12, -1, -1, -1, -1);
+            const __m128i mask2F = _mm_set1_epi8(0x2F);
+
+            std::size_t i = 0;
+            written = 0;
+            for (; i + 16 <= length && written + 16 <= outLength; i += 16, written += 12)
+            {
+                __m128i text = _mm_loadu_si128(reinterpret_cast<__m128i const *>(in + i));
+                const __m128i hiNibbles = _mm_and_si128(_mm_srli_epi32(text, 4), mask2F);
+                const __m128i lo = _mm_shuffle_epi8(lutLo, _mm_and_si128(text, mask2F));
+                const __m128i hi = _mm_shuffle_epi8(lutHi, hiNibbles);
+                if (_mm_movemask_epi8(_mm_cmpgt_epi8(_mm_and_si128(lo, hi), _mm_setzero_si128())) != 0)
                 {
-                    // Padding characters not where they should be
-                    const std::size_t remaining = length - i - 1;
-                    if (remaining > 1 || (remaining == 1 ? in[i + 1] != '=' : false))
-                    {
-                        invalid = true;
-                    }
+                    break;
                 }
 
-                break;
+                const __m128i roll = _mm_shuffle_epi8(lutRoll, _mm_add_epi8(_mm_cmpeq_epi8(text, mask2F), hiNibbles));
+                text = _mm_add_epi8(text, roll);
+
+                const __m128i merged = _mm_madd_epi16(_mm_maddubs_epi16(text, _mm_set1_epi32(0x01400140)), _mm_set1_epi32(0x00011000));
+                _mm_storeu_si128(reinterpret_cast<__m128i *>(out + written), _mm_shuffle_epi8(merged, pack));
+            }
+
+            return i;
+        }
+#elif defined(FX_GLTF_SIMD_NEON)
+        inline std::size_t DecodeBlocks(char const * in, std::size_t length, uint8_t * out, std::size_t outLength, std::size_t & written) noexcept
+        {
+            static const uint8_t lutLoData[16] = { 0x15, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x13, 0x1A, 0x1B, 0x1B, 0x1B, 0x1A };
+            static const uint8_t lutHiData[16] = { 0x10, 0x10, 0x01, 0x02, 0x04, 0x08, 0x04, 0x08, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10 };
+            static const uint8_t lutRollData[16] = { 0, 16, 19, 4, 191, 191, 185, 185, 0, 0, 0, 0, 0, 0, 0, 0 };
+            static const uint8_t packData[16] = { 2, 1, 0, 6, 5, 4, 10, 9, 8, 14, 13, 12, 255, 255, 255, 255 };
+
+            const uint8x16_t lutLo = vld1q_u8(lutLoData);
+            const uint8x16_t lutHi = vld1q_u8(lutHiData);
+            const uint8x16_t lutRoll = vld1q_u8(lutRollData);
+            const uint8x16_t pack = vld1q_u8(packData);
+
+            std::size_t i = 0;
+            written = 0;
+            for (; i + 16 <= length && written + 16 <= outLength; i += 16, written += 12)
+            {
+                uint8x16_t text = vld1q_u8(reinterpret_cast<uint8_t const *>(in + i));
+                const uint8x16_t hiNibbles = vshrq_n_u8(text, 4);
+                const uint8x16_t lo = vqtbl1q_u8(lutLo, vandq_u8(text, vdupq_n_u8(0x0F)));
+                const uint8x16_t hi = vqtbl1q_u8(lutHi, hiNibbles);
+                if (vmaxvq_u8(vandq_u8(lo, hi)) != 0)
+                {
+                    break;
+                }
+
+                const uint8x16_t roll = vqtbl1q_u8(lutRoll, vaddq_u8(vceqq_u8(text, vdupq_n_u8(0x2F)), hiNibbles));
+                text = vaddq_u8(text, roll);
+
+                // a | b << 8 becomes a << 6 | b, then ab | cd << 16 becomes ab << 12 | cd
+                const uint16x8_t pairs = vreinterpretq_u16_u8(text);
+                const uint16x8_t merged16 = vorrq_u16(vshlq_n_u16(vandq_u16(pairs, vdupq_n_u16(0x3F)), 6), vshrq_n_u16(pairs, 8));
+                const uint32x4_t quads = vreinterpretq_u32_u16(merged16);
+                const uint32x4_t merged32 = vorrq_u32(vshlq_n_u32(vandq_u32(quads, vdupq_n_u32(0xFFF)), 12), vshrq_n_u32(quads, 16));
+                vst1q_u8(out + written, vqtbl1q_u8(vreinterpretq_u8_u32(merged32), pack));
+            }
+
+            return i;
+        }
+#else
+        inline std::size_t DecodeBlocks(char const *, std::size_t, uint8_t *, std::size_t, std::size_t & written) noexcept
+        {
+            written = 0;
+            return 0;
+        }
+#endif
+
+        inline bool Decode(char const * in, std::size_t length, uint8_t * out, std::size_t outLength) noexcept
+        {
+            if (length % 4 != 0)
+            {
+                return false;
+            }
+
+            if (length == 0)
+            {
+                return true;
+            }
+
+            const std::size_t padding = GetPaddingLength(in, length);
+            if (outLength < (length / 4) * 3 - padding)
+            {
+                return false;
+            }
+
+            // Everything up to the last group containing padding
+            const std::size_t unpaddedLength = padding != 0 ? length - 4 : length;
+
+            std::size_t written = 0;
+            std::size_t i = DecodeBlocks(in, unpaddedLength, out, outLength, written);
+            for (; i < unpaddedLength; i += 4, written += 3)
+            {
+                const int32_t a = static_cast<int8_t>(DecodeMap[static_cast<uint8_t>(in[i])]);
+                const int32_t b = static_cast<int8_t>(DecodeMap[static_cast<uint8_t>(in[i + 1])]);
+                const int32_t c = static_cast<int8_t>(DecodeMap[static_cast<uint8_t>(in[i + 2])]);
+                const int32_t d = static_cast<int8_t>(DecodeMap[static_cast<uint8_t>(in[i + 3])]);
+                if ((a | b | c | d) < 0)
+                {
+                    return false;
+                }
+
+                const uint32_t value = (static_cast<uint32_t>(a) << 18u) | (static_cast<uint32_t>(b) << 12u) | (static_cast<uint32_t>(c) << 6u) | static_cast<uint32_t>(d);
+                out[written] = static_cast<uint8_t>(value >> 16u);
+                out[written + 1] = static_cast<uint8_t>(value >> 8u);
+                out[written + 2] = static_cast<uint8_t>(value);
             }
 
-            value = (value << 6u) + map;
-            bitCount += 6;
-            if (bitCount >= 0)
+            if (padding != 0)
             {
-                const uint32_t shiftOperand = bitCount;
-                out.push_back(static_cast<uint8_t>(value >> shiftOperand));
-                bitCount -= 8;
+                const int32_t a = static_cast<int8_t>(DecodeMap[static_cast<uint8_t>(in[i])]);
+                const int32_t b = static_cast<int8_t>(DecodeMap[static_cast<uint8_t>(in[i + 1])]);
+                const int32_t c = padding == 1 ? static_cast<int8_t>(DecodeMap[static_cast<uint8_t>(in[i + 2])]) : 0;
+                if ((a | b | c) < 0)
+                {
+                    return false;
+                }
+
+                const uint32_t value = (static_cast<uint32_t>(a) << 18u) | (static_cast<uint32_t>(b) << 12u) | (static_cast<uint32_t>(c) << 6u);
+                out[written] = static_cast<uint8_t>(value >> 16u);
+                if (padding == 1)
+                {
+                    out[written + 1] = static_cast<uint8_t>(value >> 8u);
+                }
             }
+
+            return true;
         }
+    } // namespace detail
+
+#if defined(FX_GLTF_HAS_CPP_17)
+    // The exact number of bytes `in` decodes to; 0 when its length is not a multiple of 4
+    inline std::size_t GetDecodedLength(std::string_view in) noexcept
+    {
+        return detail::GetDecodedLength(in.data(), in.length());
+    }
+
+    // Decodes into `out`, which must hold at least GetDecodedLength(in) bytes
+    inline bool TryDecode(std::string_view in, uint8_t * out, std::size_t outLength) noexcept
+    {
+        return detail::Decode(in.data(), in.length(), out, outLength);
+    }
+
+    inline bool TryDecode(std::string_view in, std::vector<uint8_t> & out)
+#else
+    // The exact number of bytes `in` decodes to; 0 when its length is not a multiple of 4
+    inline std::size_t GetDecodedLength(std::string const & in) noexcept
+    {
+        return detail::GetDecodedLength(in.data(), in.length());
+    }
+
+    // Decodes into `out`, which must hold at least GetDecodedLength(in) bytes
+    inline bool TryDecode(std::string const & in, uint8_t * out, std::size_t outLength) noexcept
+    {
+        return detail::Decode(in.data(), in.length(), out, outLength);
+    }
 
-        if (invalid)
+    inline bool TryDecode(std::string const & in, std::vector<uint8_t> & out)
+#endif
+    {
+        out.resize(detail::GetDecodedLength(in.data(), in.length()));
+        if (!detail::Decode(in.data(), in.length(), out.data(), out.size()))
         {
             out.clear();
+            return false;
         }
 
-        return !invalid;
+        return true;
     }
 } // namespace base64
 
@@ -292,1706 +657,8402 @@ namespace gltf
             }
         }
 
-        inline FX_GLTF_FILESYSTEM::path GetDocumentRootPath(FX_GLTF_FILESYSTEM::path const & documentFilePath)
+        // Writes only the members of extensionsAndExtras whose keys sort before `key`, or with `beforeKey` unset the
+        // remaining ones, so they can be placed around other keys starting with "extensions"
+        inline void WriteExtensions(nlohmann::json & json, nlohmann::json const & extensionsAndExtras, char const * key, bool beforeKey)
         {
-            return documentFilePath.parent_path();
+            for (nlohmann::json::const_iterator it = extensionsAndExtras.begin(); it != extensionsAndExtras.end(); ++it)
+            {
+                if ((it.key() < key) == beforeKey)
+                {
+                    json[it.key()] = it.value();
+                }
+            }
         }
 
-        inline FX_GLTF_FILESYSTEM::path CreateBufferUriPath(FX_GLTF_FILESYSTEM::path const & documentRootPath, std::string const & bufferUri)
+        // Formats a finite double into at most 32 characters the way nlohmann::json::dump does: the shortest digits
+        // which read back exactly, laid out like printf("%g") but with a trailing ".0" on integral values
+        inline char * FormatDouble(char * output, double value)
         {
-            // Prevent simple forms of path traversal from malicious uri references...
-            if (bufferUri.empty() || bufferUri.find("..") != std::string::npos || bufferUri.front() == '/' || bufferUri.front() == '\\')
+            if (std::signbit(value))
             {
-                throw invalid_gltf_document("Invalid buffer.uri value", bufferUri);
+                *output++ = '-';
+                value = -value;
             }
 
-            return documentRootPath / bufferUri;
-        }
+            if (value == 0)
+            {
+                std::memcpy(output, "0.0", 3);
+                return output + 3;
+            }
 
-        struct ChunkHeader
-        {
-            uint32_t chunkLength{};
-            uint32_t chunkType{};
-        };
+            std::array<char, 32> scientific{};
+#if defined(__cpp_lib_to_chars)
+            char const * scientificEnd = std::to_chars(scientific.data(), scientific.data() + scientific.size(), value, std::chars_format::scientific).ptr;
+#else
+            // Without std::to_chars take the first of 15, 16 and 17 significant digits which reads back exactly; any
+            // shorter form shows up as trailing zeros
+            int written = 0;
+            for (int precision = 14; precision <= 16; precision++)
+            {
+                written = std::snprintf(scientific.data(), scientific.size(), "%.*e", precision, value);
+                if (precision == 16 || std::strtod(scientific.data(), nullptr) == value)
+                {
+                    break;
+                }
+            }
 
-        struct GLBHeader
-        {
-            uint32_t magic{};
-            uint32_t version{};
-            uint32_t length{};
+            char const * scientificEnd = scientific.data() + written;
+#endif
 
-            ChunkHeader jsonHeader{};
-        };
+            // Split d[.ddd]e<exponent> into its digits and exponent...
+            std::array<char, 17> digits{};
+            int length = 0;
+            char const * position = scientific.data();
+            for (; *position != 'e'; ++position)
+            {
+                if (*position >= '0' && *position <= '9' && length < static_cast<int>(digits.size()))
+                {
+                    digits[length++] = *position;
+                }
+            }
 
-        FX_GLTF_INLINE_CONSTEXPR uint32_t DefaultMaxBufferCount = 8;
-        FX_GLTF_INLINE_CONSTEXPR uint32_t DefaultMaxMemoryAllocation = 32 * 1024 * 1024;
-        FX_GLTF_INLINE_CONSTEXPR std::size_t HeaderSize{ sizeof(GLBHeader) };
-        FX_GLTF_INLINE_CONSTEXPR std::size_t ChunkHeaderSize{ sizeof(ChunkHeader) };
-        FX_GLTF_INLINE_CONSTEXPR uint32_t GLBHeaderMagic = 0x46546c67u;
-        FX_GLTF_INLINE_CONSTEXPR uint32_t GLBChunkJSON = 0x4e4f534au;
-        FX_GLTF_INLINE_CONSTEXPR uint32_t GLBChunkBIN = 0x004e4942u;
+            while (length > 1 && digits[length - 1] == '0')
+            {
+                length--;
+            }
 
-        FX_GLTF_INLINE_CONSTEXPR char const * const MimetypeApplicationOctet = "data:application/octet-stream;base64";
-        FX_GLTF_INLINE_CONSTEXPR char const * const MimetypeGLTFBuffer = "data:application/gltf-buffer;base64";
-        FX_GLTF_INLINE_CONSTEXPR char const * const MimetypeImagePNG = "data:image/png;base64";
-        FX_GLTF_INLINE_CONSTEXPR char const * const MimetypeImageJPG = "data:image/jpeg;base64";
-    } // namespace detail
+            const bool negativeExponent = position[1] == '-';
+            int exponent = 0;
+            for (position += 2; position != scientificEnd; ++position)
+            {
+                exponent = exponent * 10 + (*position - '0');
+            }
 
-    namespace defaults
-    {
-        FX_GLTF_INLINE_CONSTEXPR std::array<float, 16> IdentityMatrix{ 1, 0, 0, 0, 0, 1, 0, 0, 0, 0, 1, 0, 0, 0, 0, 1 };
-        FX_GLTF_INLINE_CONSTEXPR std::array<float, 4> IdentityRotation{ 0, 0, 0, 1 };
-        FX_GLTF_INLINE_CONSTEXPR std::array<float, 4> IdentityVec4{ 1, 1, 1, 1 };
-        FX_GLTF_INLINE_CONSTEXPR std::array<float, 3> IdentityVec3{ 1, 1, 1 };
-        FX_GLTF_INLINE_CONSTEXPR std::array<float, 3> NullVec3{ 0, 0, 0 };
-        FX_GLTF_INLINE_CONSTEXPR float IdentityScalar = 1;
-        FX_GLTF_INLINE_CONSTEXPR float FloatSentinel = 10000;
+            exponent = negativeExponent ? -exponent : exponent;
 
-        FX_GLTF_INLINE_CONSTEXPR bool AccessorNormalized = false;
+            // ...and lay them out with the same limits as dump: fixed notation for decimal points within [-3, 15]
+            const int point = exponent + 1;
+            if (length <= point && point <= 15)
+            {
+                std::memcpy(output, digits.data(), static_cast<std::size_t>(length));
+                std::memset(output + length, '0', static_cast<std::size_t>(point - length));
+                output += point;
+                *output++ = '.';
+                *output++ = '0';
+            }
+            else if (0 < point && point <= 15)
+            {
+                std::memcpy(output, digits.data(), static_cast<std::size_t>(point));
+                output[point] = '.';
+                std::memcpy(output + point + 1, digits.data() + point, static_cast<std::size_t>(length - point));
+                output += length + 1;
+            }
+            else if (-4 < point && point <= 0)
+            {
+                *output++ = '0';
+                *output++ = '.';
+                std::memset(output, '0', static_cast<std::size_t>(-point));
+                std::memcpy(output - point, digits.data(), static_cast<std::size_t>(length));
+                output += length - point;
+            }
+            else
+            {
+                *output++ = digits[0];
+                if (length > 1)
+                {
+                    *output++ = '.';
+                    std::memcpy(output, digits.data() + 1, static_cast<std::size_t>(length - 1));
+                    output += length - 1;
+                }
 
-        FX_GLTF_INLINE_CONSTEXPR float MaterialAlphaCutoff = 0.5f;
-        FX_GLTF_INLINE_CONSTEXPR bool MaterialDoubleSided = false;
-    } // namespace defaults
+                *output++ = 'e';
+                *output++ = exponent < 0 ? '-' : '+';
+                const int magnitude = exponent < 0 ? -exponent : exponent;
+                if (magnitude >= 100)
+                {
+                    *output++ = static_cast<char>('0' + magnitude / 100);
+                }
 
-    using Attributes = std::unordered_map<std::string, uint32_t>;
+                *output++ = static_cast<char>('0' + magnitude / 10 % 10);
+                *output++ = static_cast<char>('0' + magnitude % 10);
+            }
 
-    struct NeverEmpty
-    {
-        FX_GLTF_NODISCARD static bool empty() noexcept
-        {
-            return false;
+            return output;
         }
-    };
 
-    struct Accessor
-    {
-        enum class ComponentType : uint16_t
+        // A SAX style writer emitting the same text as nlohmann::json::dump, with object keys in the order they are
+        // written; the to_json functions write them sorted to match. They are written against both this and
+        // nlohmann::json so a Document can be saved without first building the full json tree. With `countOnly` set
+        // base64 payloads are not encoded, only added to OmittedLength, for measuring the text without producing it
+        class JsonWriter
         {
-            None = 0,
-            Byte = 5120,
-            UnsignedByte = 5121,
-            Short = 5122,
-            UnsignedShort = 5123,
-            UnsignedInt = 5125,
-            Float = 5126
-        };
+        public:
+            JsonWriter(std::ostream & output, int indent, bool countOnly = false)
+                : m_output(output), m_indent(indent), m_countOnly(countOnly)
+            {
+                m_buffer.reserve(BufferCapacity);
+            }
 
-        enum class Type : uint8_t
-        {
-            None,
-            Scalar,
-            Vec2,
-            Vec3,
-            Vec4,
-            Mat2,
-            Mat3,
-            Mat4
-        };
+            JsonWriter(JsonWriter const &) = delete;
+            JsonWriter & operator=(JsonWriter const &) = delete;
 
-        struct Sparse
-        {
-            struct Indices : NeverEmpty
+            void StartObject()
             {
-                uint32_t bufferView{};
-                uint32_t byteOffset{};
-                ComponentType componentType{ ComponentType::None };
+                BeginValue();
+                StartScope('{');
+            }
 
-                nlohmann::json extensionsAndExtras{};
-            };
+            void EndObject()
+            {
+                EndScope('}');
+            }
 
-            struct Values : NeverEmpty
+            void StartArray()
             {
-                uint32_t bufferView{};
-                uint32_t byteOffset{};
+                BeginValue();
+                StartScope('[');
+            }
 
-                nlohmann::json extensionsAndExtras{};
-            };
+            void EndArray()
+            {
+                EndScope(']');
+            }
 
-            int32_t count{};
-            Indices indices{};
-            Values values{};
+            void Key(char const * key)
+            {
+                Key(key, std::char_traits<char>::length(key));
+            }
 
-            nlohmann::json extensionsAndExtras{};
+            void Key(std::string const & key)
+            {
+                Key(key.data(), key.length());
+            }
 
-            FX_GLTF_NODISCARD bool empty() const noexcept
+            void Null()
             {
-                return count == 0;
+                BeginValue();
+                Append("null", 4);
             }
-        };
 
-        int32_t bufferView{ -1 };
-        uint32_t byteOffset{};
-        uint32_t count{};
-        bool normalized{ defaults::AccessorNormalized };
+            void Bool(bool value)
+            {
+                BeginValue();
+                Append(value ? "true" : "false", value ? 4 : 5);
+            }
 
-        ComponentType componentType{ ComponentType::None };
-        Type type{ Type::None };
-        Sparse sparse;
+            void Number(int64_t value)
+            {
+                BeginValue();
+                if (value < 0)
+                {
+                    m_buffer.push_back('-');
+                    AppendUnsigned(0 - static_cast<uint64_t>(value));
+                }
+                else
+                {
+                    AppendUnsigned(static_cast<uint64_t>(value));
+                }
+            }
 
-        std::string name;
-        std::vector<float> max{};
-        std::vector<float> min{};
+            void Number(uint64_t value)
+            {
+                BeginValue();
+                AppendUnsigned(value);
+            }
 
-        nlohmann::json extensionsAndExtras{};
-    };
+            void Number(double value)
+            {
+                BeginValue();
+                if (!std::isfinite(value))
+                {
+                    Append("null", 4);
+                    return;
+                }
 
-    struct Animation
-    {
-        struct Channel
-        {
-            struct Target : NeverEmpty
+                // Use the same shortest round-trip formatting as dump...
+                std::array<char, 32> text{};
+                char const * end = detail::FormatDouble(text.data(), value);
+                Append(text.data(), static_cast<std::size_t>(end - text.data()));
+            }
+
+            void String(std::string const & value)
             {
-                int32_t node{ -1 };
-                std::string path{};
+                BeginValue();
+                AppendString(value.data(), value.length());
+            }
 
-                nlohmann::json extensionsAndExtras{};
-            };
+            void String(char const * value)
+            {
+                BeginValue();
+                AppendString(value, std::char_traits<char>::length(value));
+            }
 
-            int32_t sampler{ -1 };
-            Target target{};
+            // Writes `prefix` followed by the base64 encoding of `bytes`, which is streamed straight into the output
+            void Base64String(std::string const & prefix, uint8_t const * bytes, std::size_t length)
+            {
+                BeginValue();
+                m_buffer.push_back('"');
+                AppendEscaped(prefix.data(), prefix.length());
+                if (m_countOnly)
+                {
+                    m_omittedLength += base64::GetEncodedLength(length);
+                }
+                else
+                {
+                    Flush();
+                    base64::Encode(bytes, length, m_output);
+                }
 
-            nlohmann::json extensionsAndExtras{};
-        };
+                m_buffer.push_back('"');
+            }
 
-        struct Sampler
-        {
-            enum class Type
+            FX_GLTF_NODISCARD std::size_t OmittedLength() const noexcept
             {
-                Linear,
-                Step,
-                CubicSpline
-            };
+                return m_omittedLength;
+            }
 
-            int32_t input{ -1 };
-            int32_t output{ -1 };
+            void Value(nlohmann::json const & value)
+            {
+                switch (value.type())
+                {
+                case nlohmann::json::value_t::object:
+                    StartObject();
+                    for (nlohmann::json::const_iterator it = value.begin(); it != value.end(); ++it)
+                    {
+                        Key(it.key());
+                        Value(it.value());
+                    }
+                    EndObject();
+                    break;
+                case nlohmann::json::value_t::array:
+                    StartArray();
+                    for (nlohmann::json const & element : value)
+                    {
+                        Value(element);
+                    }
+                    EndArray();
+                    break;
+                case nlohmann::json::value_t::string:
+                    String(value.get_ref<std::string const &>());
+                    break;
+                case nlohmann::json::value_t::boolean:
+                    Bool(value.get<bool>());
+                    break;
+                case nlohmann::json::value_t::number_integer:
+                    Number(value.get<int64_t>());
+                    break;
+                case nlohmann::json::value_t::number_unsigned:
+                    Number(value.get<uint64_t>());
+                    break;
+                case nlohmann::json::value_t::number_float:
+                    Number(value.get<double>());
+                    break;
+                default:
+                    Null();
+                    break;
+                }
+            }
 
-            Type interpolation{ Sampler::Type::Linear };
+            void Flush()
+            {
+                m_output.write(m_buffer.data(), static_cast<std::streamsize>(m_buffer.size()));
+                m_buffer.clear();
+            }
 
-            nlohmann::json extensionsAndExtras{};
-        };
+        private:
+            static constexpr std::size_t BufferCapacity = 64 * 1024;
 
-        std::string name{};
-        std::vector<Channel> channels{};
-        std::vector<Sampler> samplers{};
+            std::ostream & m_output;
+            int m_indent{};
+            bool m_countOnly{};
+            bool m_afterKey{};
+            std::size_t m_omittedLength{};
 
-        nlohmann::json extensionsAndExtras{};
-    };
+            std::string m_buffer{};
 
-    struct Asset : NeverEmpty
-    {
-        std::string copyright{};
-        std::string generator{};
-        std::string minVersion{};
-        std::string version{ "2.0" };
+            // One entry per open object or array: true until its first member is written
+            std::vector<bool> m_scopes{};
 
-        nlohmann::json extensionsAndExtras{};
-    };
+            void Key(char const * key, std::size_t length)
+            {
+                BeginMember();
+                AppendString(key, length);
+                m_buffer.push_back(':');
+                if (m_indent >= 0)
+                {
+                    m_buffer.push_back(' ');
+                }
 
-    struct Buffer
-    {
-        uint32_t byteLength{};
+                m_afterKey = true;
+            }
 
-        std::string name;
-        std::string uri;
+            void BeginValue()
+            {
+                if (m_afterKey)
+                {
+                    m_afterKey = false;
+                }
+                else if (!m_scopes.empty())
+                {
+                    BeginMember();
+                }
 
-        nlohmann::json extensionsAndExtras{};
+                if (m_buffer.size() >= BufferCapacity)
+                {
+                    Flush();
+                }
+            }
 
-        std::vector<uint8_t> data{};
+            void BeginMember()
+            {
+                if (!m_scopes.back())
+                {
+                    m_buffer.push_back(',');
+                }
 
-        FX_GLTF_NODISCARD bool IsEmbeddedResource() const noexcept
-        {
-            return uri.find(detail::MimetypeApplicationOctet) == 0 || uri.find(detail::MimetypeGLTFBuffer) == 0;
-        }
+                m_scopes.back() = false;
+                NewLine();
+            }
 
-        void SetEmbeddedResource()
-        {
-            uri = std::string(detail::MimetypeApplicationOctet).append(",").append(base64::Encode(data));
-        }
-    };
+            void StartScope(char open)
+            {
+                m_buffer.push_back(open);
+                m_scopes.push_back(true);
+            }
 
-    struct BufferView
-    {
-        enum class TargetType : uint16_t
-        {
-            None = 0,
-            ArrayBuffer = 34962,
-            ElementArrayBuffer = 34963
-        };
+            void EndScope(char close)
+            {
+                const bool empty = m_scopes.back();
+                m_scopes.pop_back();
+                if (!empty)
+                {
+                    NewLine();
+                }
 
-        std::string name;
+                m_buffer.push_back(close);
+            }
 
-        int32_t buffer{ -1 };
-        uint32_t byteOffset{};
-        uint32_t byteLength{};
-        uint32_t byteStride{};
+            void NewLine()
+            {
+                if (m_indent >= 0)
+                {
+                    m_buffer.push_back('\n');
+                    m_buffer.append(m_scopes.size() * static_cast<std::size_t>(m_indent), ' ');
+                }
+            }
 
-        TargetType target{ TargetType::None };
+            void Append(char const * text, std::size_t length)
+            {
+                m_buffer.append(text, length);
+            }
 
-        nlohmann::json extensionsAndExtras{};
-    };
+            void AppendUnsigned(uint64_t value)
+            {
+                std::array<char, 20> digits{};
+                std::size_t position = digits.size();
+                do
+                {
+                    digits[--position] = static_cast<char>('0' + (value % 10));
+                    value /= 10;
+                } while (value != 0);
 
-    struct Camera
-    {
-        enum class Type
-        {
-            None,
-            Orthographic,
-            Perspective
-        };
+                Append(&digits[position], digits.size() - position);
+            }
 
-        struct Orthographic : NeverEmpty
-        {
-            float xmag{ defaults::FloatSentinel };
-            float ymag{ defaults::FloatSentinel };
-            float zfar{ -defaults::FloatSentinel };
-            float znear{ -defaults::FloatSentinel };
+            void AppendString(char const * text, std::size_t length)
+            {
+                m_buffer.push_back('"');
+                AppendEscaped(text, length);
+                m_buffer.push_back('"');
+            }
 
-            nlohmann::json extensionsAndExtras{};
-        };
+            void AppendEscaped(char const * text, std::size_t length)
+            {
+                constexpr char const * HexDigits = "0123456789abcdef";
 
-        struct Perspective : NeverEmpty
-        {
-            float aspectRatio{};
-            float yfov{};
-            float zfar{};
-            float znear{};
+                std::size_t start = 0;
+                for (std::size_t i = 0; i < length; i++)
+                {
+                    const uint8_t c = static_cast<uint8_t>(text[i]);
+                    if (c >= 0x20 && c != '"' && c != '\\')
+                    {
+                        continue;
+                    }
 
-            nlohmann::json extensionsAndExtras{};
+                    Append(text + start, i - start);
+                    start = i + 1;
+
+                    m_buffer.push_back('\\');
+                    switch (c)
+                    {
+                    case '"':
+                    case '\\':
+                        m_buffer.push_back(static_cast<char>(c));
+                        break;
+                    case '\b':
+                        m_buffer.push_back('b');
+                        break;
+                    case '\f':
+                        m_buffer.push_back('f');
+                        break;
+                    case '\n':
+                        m_buffer.push_back('n');
+                        break;
+                    case '\r':
+                        m_buffer.push_back('r');
+                        break;
+                    case '\t':
+                        m_buffer.push_back('t');
+                        break;
+                    default:
+                        m_buffer.append("u00", 3);
+                        m_buffer.push_back(HexDigits[c >> 4u]);
+                        m_buffer.push_back(HexDigits[c & 0xfu]);
+                        break;
+                    }
+                }
+
+                Append(text + start, length - start);
+            }
         };
 
-        std::string name{};
-        Type type{ Type::None };
+        template <typename TValue>
+        inline typename std::enable_if<std::is_integral<TValue>::value && std::is_signed<TValue>::value>::type WriteJsonValue(JsonWriter & json, TValue value);
 
-        Orthographic orthographic;
-        Perspective perspective;
+        template <typename TValue>
+        inline typename std::enable_if<std::is_integral<TValue>::value && std::is_unsigned<TValue>::value>::type WriteJsonValue(JsonWriter & json, TValue value);
 
-        nlohmann::json extensionsAndExtras{};
-    };
+        template <typename TValue>
+        inline typename std::enable_if<std::is_floating_point<TValue>::value>::type WriteJsonValue(JsonWriter & json, TValue value);
 
-    struct Image
-    {
-        int32_t bufferView{};
+        template <typename TValue>
+        inline typename std::enable_if<std::is_enum<TValue>::value>::type WriteJsonValue(JsonWriter & json, TValue value);
 
-        std::string name;
-        std::string uri;
-        std::string mimeType;
+        template <typename TValue>
+        inline typename std::enable_if<std::is_class<TValue>::value>::type WriteJsonValue(JsonWriter & json, TValue const & value);
 
-        nlohmann::json extensionsAndExtras{};
+        template <typename TValue, std::size_t N>
+        inline void WriteJsonValue(JsonWriter & json, std::array<TValue, N> const & values);
 
-        FX_GLTF_NODISCARD bool IsEmbeddedResource() const noexcept
+        template <typename TValue>
+        inline void WriteJsonValue(JsonWriter & json, std::vector<TValue> const & values);
+
+        template <typename TValue>
+        inline void WriteJsonValue(JsonWriter & json, std::unordered_map<std::string, TValue> const & values);
+
+        inline void WriteJsonValue(JsonWriter & json, bool value)
         {
-            return uri.find(detail::MimetypeImagePNG) == 0 || uri.find(detail::MimetypeImageJPG) == 0;
+            json.Bool(value);
         }
 
-        void MaterializeData(std::vector<uint8_t> & data) const
+        inline void WriteJsonValue(JsonWriter & json, std::string const & value)
         {
-            char const * const mimetype = uri.find(detail::MimetypeImagePNG) == 0 ? detail::MimetypeImagePNG : detail::MimetypeImageJPG;
-            const std::size_t startPos = std::char_traits<char>::length(mimetype) + 1;
-
-#if defined(FX_GLTF_HAS_CPP_17)
-            const std::size_t base64Length = uri.length() - startPos;
-            const bool success = base64::TryDecode({ &uri[startPos], base64Length }, data);
-#else
-            const bool success = base64::TryDecode(uri.substr(startPos), data);
-#endif
-            if (!success)
-            {
-                throw invalid_gltf_document("Invalid buffer.uri value", "malformed base64");
-            }
+            json.String(value);
         }
-    };
 
-    struct Material
-    {
-        enum class AlphaMode : uint8_t
+        inline void WriteJsonValue(JsonWriter & json, nlohmann::json const & value)
         {
-            Opaque,
-            Mask,
-            Blend
-        };
+            json.Value(value);
+        }
 
-        struct Texture
+        template <typename TValue>
+        inline typename std::enable_if<std::is_integral<TValue>::value && std::is_signed<TValue>::value>::type WriteJsonValue(JsonWriter & json, TValue value)
         {
-            int32_t index{ -1 };
-            int32_t texCoord{};
+            json.Number(static_cast<int64_t>(value));
+        }
 
-            nlohmann::json extensionsAndExtras{};
+        template <typename TValue>
+        inline typename std::enable_if<std::is_integral<TValue>::value && std::is_unsigned<TValue>::value>::type WriteJsonValue(JsonWriter & json, TValue value)
+        {
+            json.Number(static_cast<uint64_t>(value));
+        }
 
-            FX_GLTF_NODISCARD bool empty() const noexcept
-            {
-                return index == -1;
-            }
-        };
+        template <typename TValue>
+        inline typename std::enable_if<std::is_floating_point<TValue>::value>::type WriteJsonValue(JsonWriter & json, TValue value)
+        {
+            json.Number(static_cast<double>(value));
+        }
 
-        struct NormalTexture : Texture
+        template <typename TValue>
+        inline typename std::enable_if<std::is_enum<TValue>::value>::type WriteJsonValue(JsonWriter & json, TValue value)
         {
-            float scale{ defaults::IdentityScalar };
-        };
+            // Enums are numbers unless a WriteJsonValue overload next to their to_json maps them to text
+            json.Number(static_cast<int64_t>(value));
+        }
 
-        struct OcclusionTexture : Texture
+        template <typename TValue>
+        inline typename std::enable_if<std::is_class<TValue>::value>::type WriteJsonValue(JsonWriter & json, TValue const & value)
         {
-            float strength{ defaults::IdentityScalar };
-        };
+            json.StartObject();
+            to_json(json, value);
+            json.EndObject();
+        }
 
-        struct PBRMetallicRoughness
+        template <typename TValue, std::size_t N>
+        inline void WriteJsonValue(JsonWriter & json, std::array<TValue, N> const & values)
         {
-            std::array<float, 4> baseColorFactor = { defaults::IdentityVec4 };
-            Texture baseColorTexture;
+            json.StartArray();
+            for (TValue const & value : values)
+            {
+                WriteJsonValue(json, value);
+            }
+            json.EndArray();
+        }
 
-            float roughnessFactor{ defaults::IdentityScalar };
-            float metallicFactor{ defaults::IdentityScalar };
-            Texture metallicRoughnessTexture;
+        template <typename TValue>
+        inline void WriteJsonValue(JsonWriter & json, std::vector<TValue> const & values)
+        {
+            json.StartArray();
+            for (TValue const & value : values)
+            {
+                WriteJsonValue(json, value);
+            }
+            json.EndArray();
+        }
 
-            nlohmann::json extensionsAndExtras{};
+        template <typename TValue>
+        inline void WriteJsonValue(JsonWriter & json, std::unordered_map<std::string, TValue> const & values)
+        {
+            // Sort the keys so the output does not depend on the hash table layout
+            std::vector<typename std::unordered_map<std::string, TValue>::const_pointer> sorted{};
+            sorted.reserve(values.size());
+            for (auto const & value : values)
+            {
+                sorted.push_back(&value);
+            }
 
-            FX_GLTF_NODISCARD bool empty() const
+            std::sort(sorted.begin(), sorted.end(), [](auto a, auto b) { return a->first < b->first; });
+
+            json.StartObject();
+            for (auto value : sorted)
             {
-                return baseColorTexture.empty() && metallicRoughnessTexture.empty() && metallicFactor == 1.0f && roughnessFactor == 1.0f && baseColorFactor == defaults::IdentityVec4;
+                json.Key(value->first);
+                WriteJsonValue(json, value->second);
             }
-        };
+            json.EndObject();
+        }
 
-        float alphaCutoff{ defaults::MaterialAlphaCutoff };
-        AlphaMode alphaMode{ AlphaMode::Opaque };
+        template <typename TValue>
+        inline void WriteField(char const * key, JsonWriter & json, TValue const & value)
+        {
+            if (!value.empty())
+            {
+                json.Key(key);
+                WriteJsonValue(json, value);
+            }
+        }
 
-        bool doubleSided{ defaults::MaterialDoubleSided };
+        template <typename TValue>
+        inline void WriteField(char const * key, JsonWriter & json, TValue const & value, TValue const & defaultValue)
+        {
+            if (value != defaultValue)
+            {
+                json.Key(key);
+                WriteJsonValue(json, value);
+            }
+        }
 
-        NormalTexture normalTexture;
-        OcclusionTexture occlusionTexture;
-        PBRMetallicRoughness pbrMetallicRoughness;
+        inline void WriteExtensions(JsonWriter & json, nlohmann::json const & extensionsAndExtras)
+        {
+            if (!extensionsAndExtras.empty())
+            {
+                for (nlohmann::json::const_iterator it = extensionsAndExtras.begin(); it != extensionsAndExtras.end(); ++it)
+                {
+                    json.Key(it.key());
+                    json.Value(it.value());
+                }
+            }
+        }
 
-        Texture emissiveTexture;
-        std::array<float, 3> emissiveFactor = { defaults::NullVec3 };
+        inline void WriteExtensions(JsonWriter & json, nlohmann::json const & extensionsAndExtras, char const * key, bool beforeKey)
+        {
+            for (nlohmann::json::const_iterator it = extensionsAndExtras.begin(); it != extensionsAndExtras.end(); ++it)
+            {
+                if ((it.key() < key) == beforeKey)
+                {
+                    json.Key(it.key());
+                    json.Value(it.value());
+                }
+            }
+        }
 
-        std::string name;
-        nlohmann::json extensionsAndExtras{};
-    };
+        inline void WriteEmptyObject(nlohmann::json & json)
+        {
+            json = nlohmann::json::object();
+        }
 
-    struct Primitive
-    {
-        enum class Mode : uint8_t
+        inline void WriteEmptyObject(JsonWriter &)
         {
-            Points = 0,
-            Lines = 1,
-            LineLoop = 2,
-            LineStrip = 3,
-            Triangles = 4,
-            TriangleStrip = 5,
-            TriangleFan = 6
-        };
+            // Objects are always opened and closed by the writer...
+        }
 
-        int32_t indices{ -1 };
-        int32_t material{ -1 };
+        inline FX_GLTF_FILESYSTEM::path GetDocumentRootPath(FX_GLTF_FILESYSTEM::path const & documentFilePath)
+        {
+            return documentFilePath.parent_path();
+        }
 
-        Mode mode{ Mode::Triangles };
+        inline FX_GLTF_FILESYSTEM::path CreateBufferUriPath(FX_GLTF_FILESYSTEM::path const & documentRootPath, std::string const & bufferUri)
+        {
+            // Prevent simple forms of path traversal from malicious uri references...
+            if (bufferUri.empty() || bufferUri.find("..") != std::string::npos || bufferUri.front() == '/' || bufferUri.front() == '\\')
+            {
+                throw invalid_gltf_document("Invalid buffer.uri value", bufferUri);
+            }
 
-        Attributes attributes{};
-        std::vector<Attributes> targets{};
+            return documentRootPath / bufferUri;
+        }
 
-        nlohmann::json extensionsAndExtras{};
-    };
+        struct ChunkHeader
+        {
+            uint32_t chunkLength{};
+            uint32_t chunkType{};
+        };
 
-    struct Mesh
-    {
-        std::string name;
+        struct GLBHeader
+        {
+            uint32_t magic{};
+            uint32_t version{};
+            uint32_t length{};
 
-        std::vector<float> weights{};
-        std::vector<Primitive> primitives{};
+            ChunkHeader jsonHeader{};
+        };
 
-        nlohmann::json extensionsAndExtras{};
-    };
+        FX_GLTF_INLINE_CONSTEXPR uint32_t DefaultMaxBufferCount = 8;
+        FX_GLTF_INLINE_CONSTEXPR uint32_t DefaultMaxMemoryAllocation = 32 * 1024 * 1024;
+        FX_GLTF_INLINE_CONSTEXPR std::size_t HeaderSize{ sizeof(GLBHeader) };
+        FX_GLTF_INLINE_CONSTEXPR std::size_t ChunkHeaderSize{ sizeof(ChunkHeader) };
+        FX_GLTF_INLINE_CONSTEXPR uint32_t GLBHeaderMagic = 0x46546c67u;
+        FX_GLTF_INLINE_CONSTEXPR uint32_t GLBChunkJSON = 0x4e4f534au;
+        FX_GLTF_INLINE_CONSTEXPR uint32_t GLBChunkBIN = 0x004e4942u;
 
-    struct Node
-    {
-        std::string name;
+        FX_GLTF_INLINE_CONSTEXPR char const * const MimetypeApplicationOctet = "data:application/octet-stream;base64";
+        FX_GLTF_INLINE_CONSTEXPR char const * const MimetypeGLTFBuffer = "data:application/gltf-buffer;base64";
+        FX_GLTF_INLINE_CONSTEXPR char const * const MimetypeImagePNG = "data:image/png;base64";
+        FX_GLTF_INLINE_CONSTEXPR char const * const MimetypeImageJPG = "data:image/jpeg;base64";
+    } // namespace detail
 
-        int32_t camera{ -1 };
-        int32_t mesh{ -1 };
-        int32_t skin{ -1 };
+    namespace defaults
+    {
+        FX_GLTF_INLINE_CONSTEXPR std::array<float, 16> IdentityMatrix{ 1, 0, 0, 0, 0, 1, 0, 0, 0, 0, 1, 0, 0, 0, 0, 1 };
+        FX_GLTF_INLINE_CONSTEXPR std::array<float, 4> IdentityRotation{ 0, 0, 0, 1 };
+        FX_GLTF_INLINE_CONSTEXPR std::array<float, 4> IdentityVec4{ 1, 1, 1, 1 };
+        FX_GLTF_INLINE_CONSTEXPR std::array<float, 3> IdentityVec3{ 1, 1, 1 };
+        FX_GLTF_INLINE_CONSTEXPR std::array<float, 3> NullVec3{ 0, 0, 0 };
+        FX_GLTF_INLINE_CONSTEXPR float IdentityScalar = 1;
+        FX_GLTF_INLINE_CONSTEXPR float FloatSentinel = 10000;
 
-        std::array<float, 16> matrix{ defaults::IdentityMatrix };
-        std::array<float, 4> rotation{ defaults::IdentityRotation };
-        std::array<float, 3> scale{ defaults::IdentityVec3 };
-        std::array<float, 3> translation{ defaults::NullVec3 };
+        FX_GLTF_INLINE_CONSTEXPR bool AccessorNormalized = false;
 
-        std::vector<int32_t> children{};
-        std::vector<float> weights{};
+        FX_GLTF_INLINE_CONSTEXPR float MaterialAlphaCutoff = 0.5f;
+        FX_GLTF_INLINE_CONSTEXPR bool MaterialDoubleSided = false;
+    } // namespace defaults
 
-        nlohmann::json extensionsAndExtras{};
-    };
+    using Attributes = std::unordered_map<std::string, uint32_t>;
 
-    struct Sampler
+    // A non-owning view over a contiguous sequence of elements
+    template <typename TElement>
+    class Span
     {
-        enum class MagFilter : uint16_t
-        {
-            None,
-            Nearest = 9728,
-            Linear = 9729
-        };
+    public:
+        Span() noexcept = default;
 
-        enum class MinFilter : uint16_t
+        Span(TElement * data, std::size_t size) noexcept
+            : m_data(data), m_size(size)
         {
-            None,
-            Nearest = 9728,
-            Linear = 9729,
-            NearestMipMapNearest = 9984,
-            LinearMipMapNearest = 9985,
-            NearestMipMapLinear = 9986,
-            LinearMipMapLinear = 9987
-        };
+        }
 
-        enum class WrappingMode : uint16_t
+        template <typename TOther, typename = typename std::enable_if<std::is_convertible<TOther (*)[], TElement (*)[]>::value>::type>
+        Span(Span<TOther> const & other) noexcept // NOLINT(google-explicit-constructor): Span<T> -> Span<T const>
+            : m_data(other.data()), m_size(other.size())
         {
-            ClampToEdge = 33071,
-            MirroredRepeat = 33648,
-            Repeat = 10497
-        };
-
-        std::string name;
-
-        MagFilter magFilter{ MagFilter::None };
-        MinFilter minFilter{ MinFilter::None };
+        }
 
-        WrappingMode wrapS{ WrappingMode::Repeat };
-        WrappingMode wrapT{ WrappingMode::Repeat };
+        FX_GLTF_NODISCARD TElement * data() const noexcept
+        {
+            return m_data;
+        }
 
-        nlohmann::json extensionsAndExtras{};
+        FX_GLTF_NODISCARD std::size_t size() const noexcept
+        {
+            return m_size;
+        }
 
         FX_GLTF_NODISCARD bool empty() const noexcept
         {
-            return name.empty() && magFilter == MagFilter::None && minFilter == MinFilter::None && wrapS == WrappingMode::Repeat && wrapT == WrappingMode::Repeat && extensionsAndExtras.empty();
+            return m_size == 0;
         }
-    };
-
-    struct Scene
-    {
-        std::string name;
 
-        std::vector<uint32_t> nodes{};
+        FX_GLTF_NODISCARD TElement * begin() const noexcept
+        {
+            return m_data;
+        }
 
-        nlohmann::json extensionsAndExtras{};
-    };
+        FX_GLTF_NODISCARD TElement * end() const noexcept
+        {
+            return m_data + m_size;
+        }
 
-    struct Skin
-    {
-        int32_t inverseBindMatrices{ -1 };
-        int32_t skeleton{ -1 };
+        TElement & operator[](std::size_t index) const noexcept
+        {
+            return m_data[index];
+        }
 
-        std::string name;
-        std::vector<uint32_t> joints{};
+        FX_GLTF_NODISCARD Span subspan(std::size_t offset, std::size_t count) const noexcept
+        {
+            return Span(m_data + offset, count);
+        }
 
-        nlohmann::json extensionsAndExtras{};
+    private:
+        TElement * m_data{};
+        std::size_t m_size{};
     };
 
-    struct Texture
+    struct NeverEmpty
     {
-        std::string name;
-
-        int32_t sampler{ -1 };
-        int32_t source{ -1 };
-
-        nlohmann::json extensionsAndExtras{};
+        FX_GLTF_NODISCARD static bool empty() noexcept
+        {
+            return false;
+        }
     };
 
-    struct Document
+    struct Accessor
     {
-        Asset asset;
+        enum class ComponentType : uint16_t
+        {
+            None = 0,
+            Byte = 5120,
+            UnsignedByte = 5121,
+            Short = 5122,
+            UnsignedShort = 5123,
+            UnsignedInt = 5125,
+            Float = 5126
+        };
 
-        std::vector<Accessor> accessors{};
-        std::vector<Animation> animations{};
-        std::vector<Buffer> buffers{};
-        std::vector<BufferView> bufferViews{};
-        std::vector<Camera> cameras{};
-        std::vector<Image> images{};
-        std::vector<Material> materials{};
-        std::vector<Mesh> meshes{};
-        std::vector<Node> nodes{};
-        std::vector<Sampler> samplers{};
-        std::vector<Scene> scenes{};
-        std::vector<Skin> skins{};
-        std::vector<Texture> textures{};
-
-        int32_t scene{ -1 };
-        std::vector<std::string> extensionsUsed{};
-        std::vector<std::string> extensionsRequired{};
+        enum class Type : uint8_t
+        {
+            None,
+            Scalar,
+            Vec2,
+            Vec3,
+            Vec4,
+            Mat2,
+            Mat3,
+            Mat4
+        };
 
-        nlohmann::json extensionsAndExtras{};
-    };
+        struct Sparse
+        {
+            struct Indices : NeverEmpty
+            {
+                uint32_t bufferView{};
+                uint64_t byteOffset{};
+                ComponentType componentType{ ComponentType::None };
 
-    struct ReadQuotas
-    {
-        uint32_t MaxBufferCount{ detail::DefaultMaxBufferCount };
-        uint32_t MaxFileSize{ detail::DefaultMaxMemoryAllocation };
-        uint32_t MaxBufferByteLength{ detail::DefaultMaxMemoryAllocation };
-    };
+                nlohmann::json extensionsAndExtras{};
+            };
 
-    inline void from_json(nlohmann::json const & json, Accessor::Type & accessorType)
-    {
-        std::string type = json.get<std::string>();
-        if (type == "SCALAR")
-        {
-            accessorType = Accessor::Type::Scalar;
-        }
-        else if (type == "VEC2")
-        {
-            accessorType = Accessor::Type::Vec2;
-        }
-        else if (type == "VEC3")
-        {
-            accessorType = Accessor::Type::Vec3;
-        }
-        else if (type == "VEC4")
-        {
-            accessorType = Accessor::Type::Vec4;
-        }
-        else if (type == "MAT2")
-        {
-            accessorType = Accessor::Type::Mat2;
-        }
-        else if (type == "MAT3")
-        {
-            accessorType = Accessor::Type::Mat3;
-        }
-        else if (type == "MAT4")
-        {
-            accessorType = Accessor::Type::Mat4;
-        }
-        else
-        {
-            throw invalid_gltf_document("Unknown accessor.type value", type);
-        }
-    }
+            struct Values : NeverEmpty
+            {
+                uint32_t bufferView{};
+                uint64_t byteOffset{};
 
-    inline void from_json(nlohmann::json const & json, Accessor::Sparse::Values & values)
-    {
-        detail::ReadRequiredField("bufferView", json, values.bufferView);
+                nlohmann::json extensionsAndExtras{};
+            };
 
-        detail::ReadOptionalField("byteOffset", json, values.byteOffset);
+            int32_t count{};
+            Indices indices{};
+            Values values{};
 
-        detail::ReadExtensionsAndExtras(json, values.extensionsAndExtras);
-    }
+            nlohmann::json extensionsAndExtras{};
 
-    inline void from_json(nlohmann::json const & json, Accessor::Sparse::Indices & indices)
-    {
-        detail::ReadRequiredField("bufferView", json, indices.bufferView);
-        detail::ReadRequiredField("componentType", json, indices.componentType);
+            FX_GLTF_NODISCARD bool empty() const noexcept
+            {
+                return count == 0;
+            }
+        };
 
-        detail::ReadOptionalField("byteOffset", json, indices.byteOffset);
+        int32_t bufferView{ -1 };
+        uint64_t byteOffset{};
+        uint32_t count{};
+        bool normalized{ defaults::AccessorNormalized };
 
-        detail::ReadExtensionsAndExtras(json, indices.extensionsAndExtras);
-    }
+        ComponentType componentType{ ComponentType::None };
+        Type type{ Type::None };
+        Sparse sparse;
 
-    inline void from_json(nlohmann::json const & json, Accessor::Sparse & sparse)
-    {
-        detail::ReadRequiredField("count", json, sparse.count);
-        detail::ReadRequiredField("indices", json, sparse.indices);
-        detail::ReadRequiredField("values", json, sparse.values);
+        std::string name;
+        std::vector<float> max{};
+        std::vector<float> min{};
 
-        detail::ReadExtensionsAndExtras(json, sparse.extensionsAndExtras);
-    }
+        nlohmann::json extensionsAndExtras{};
+    };
 
-    inline void from_json(nlohmann::json const & json, Accessor & accessor)
+    struct Animation
     {
-        detail::ReadRequiredField("componentType", json, accessor.componentType);
-        detail::ReadRequiredField("count", json, accessor.count);
-        detail::ReadRequiredField("type", json, accessor.type);
+        struct Channel
+        {
+            struct Target : NeverEmpty
+            {
+                int32_t node{ -1 };
+                std::string path{};
 
-        detail::ReadOptionalField("bufferView", json, accessor.bufferView);
-        detail::ReadOptionalField("byteOffset", json, accessor.byteOffset);
-        detail::ReadOptionalField("max", json, accessor.max);
-        detail::ReadOptionalField("min", json, accessor.min);
-        detail::ReadOptionalField("name", json, accessor.name);
-        detail::ReadOptionalField("normalized", json, accessor.normalized);
-        detail::ReadOptionalField("sparse", json, accessor.sparse);
+                nlohmann::json extensionsAndExtras{};
+            };
 
-        detail::ReadExtensionsAndExtras(json, accessor.extensionsAndExtras);
-    }
+            int32_t sampler{ -1 };
+            Target target{};
 
-    inline void from_json(nlohmann::json const & json, Animation::Channel::Target & animationChannelTarget)
-    {
-        detail::ReadRequiredField("path", json, animationChannelTarget.path);
+            nlohmann::json extensionsAndExtras{};
+        };
 
-        detail::ReadOptionalField("node", json, animationChannelTarget.node);
+        struct Sampler
+        {
+            enum class Type
+            {
+                Linear,
+                Step,
+                CubicSpline
+            };
 
-        detail::ReadExtensionsAndExtras(json, animationChannelTarget.extensionsAndExtras);
-    }
+            int32_t input{ -1 };
+            int32_t output{ -1 };
 
-    inline void from_json(nlohmann::json const & json, Animation::Channel & animationChannel)
-    {
-        detail::ReadRequiredField("sampler", json, animationChannel.sampler);
-        detail::ReadRequiredField("target", json, animationChannel.target);
+            Type interpolation{ Sampler::Type::Linear };
 
-        detail::ReadExtensionsAndExtras(json, animationChannel.extensionsAndExtras);
-    }
+            nlohmann::json extensionsAndExtras{};
+        };
 
-    inline void from_json(nlohmann::json const & json, Animation::Sampler::Type & animationSamplerType)
-    {
-        std::string type = json.get<std::string>();
-        if (type == "LINEAR")
-        {
-            animationSamplerType = Animation::Sampler::Type::Linear;
-        }
-        else if (type == "STEP")
-        {
-            animationSamplerType = Animation::Sampler::Type::Step;
-        }
-        else if (type == "CUBICSPLINE")
-        {
-            animationSamplerType = Animation::Sampler::Type::CubicSpline;
-        }
-        else
-        {
-            throw invalid_gltf_document("Unknown animation.sampler.interpolation value", type);
-        }
-    }
+        std::string name{};
+        std::vector<Channel> channels{};
+        std::vector<Sampler> samplers{};
 
-    inline void from_json(nlohmann::json const & json, Animation::Sampler & animationSampler)
+        nlohmann::json extensionsAndExtras{};
+    };
+
+    struct Asset : NeverEmpty
     {
-        detail::ReadRequiredField("input", json, animationSampler.input);
-        detail::ReadRequiredField("output", json, animationSampler.output);
+        std::string copyright{};
+        std::string generator{};
+        std::string minVersion{};
+        std::string version{ "2.0" };
 
-        detail::ReadOptionalField("interpolation", json, animationSampler.interpolation);
+        nlohmann::json extensionsAndExtras{};
+    };
 
-        detail::ReadExtensionsAndExtras(json, animationSampler.extensionsAndExtras);
-    }
+    struct Buffer;
 
-    inline void from_json(nlohmann::json const & json, Animation & animation)
+    namespace detail
     {
-        detail::ReadRequiredField("channels", json, animation.channels);
-        detail::ReadRequiredField("samplers", json, animation.samplers);
+        // Buffer contents which are only read once first requested (ReadOptions::DeferBufferData). The loader
+        // works from the buffer's uri and byteLength, or a recorded byte range of the GLB file, and runs at most
+        // once; a failed load is retried on the next request.
+        class DeferredData
+        {
+        public:
+            using Loader = std::function<std::shared_ptr<uint8_t>(Buffer const & buffer)>;
 
-        detail::ReadOptionalField("name", json, animation.name);
+            explicit DeferredData(Loader loader)
+                : m_loader(std::move(loader))
+            {
+            }
 
-        detail::ReadExtensionsAndExtras(json, animation.extensionsAndExtras);
-    }
+            uint8_t * Get(Buffer const & buffer)
+            {
+                std::call_once(m_once, [this, &buffer]() {
+                    m_data = m_loader(buffer);
+                    m_loader = nullptr;
+                });
 
-    inline void from_json(nlohmann::json const & json, Asset & asset)
-    {
-        detail::ReadRequiredField("version", json, asset.version);
-        detail::ReadOptionalField("copyright", json, asset.copyright);
-        detail::ReadOptionalField("generator", json, asset.generator);
-        detail::ReadOptionalField("minVersion", json, asset.minVersion);
+                return m_data.get();
+            }
 
-        detail::ReadExtensionsAndExtras(json, asset.extensionsAndExtras);
-    }
+        private:
+            std::once_flag m_once{};
+            Loader m_loader;
+            std::shared_ptr<uint8_t> m_data{};
+        };
+    } // namespace detail
 
-    inline void from_json(nlohmann::json const & json, Buffer & buffer)
+    struct Buffer
     {
-        detail::ReadRequiredField("byteLength", json, buffer.byteLength);
+        // External buffers may exceed 4GB; the first buffer of a .glb is limited by the 32-bit chunk length
+        uint64_t byteLength{};
 
-        detail::ReadOptionalField("name", json, buffer.name);
-        detail::ReadOptionalField("uri", json, buffer.uri);
+        std::string name;
+        std::string uri;
 
-        detail::ReadExtensionsAndExtras(json, buffer.extensionsAndExtras);
-    }
+        nlohmann::json extensionsAndExtras{};
 
-    inline void from_json(nlohmann::json const & json, BufferView & bufferView)
-    {
-        detail::ReadRequiredField("buffer", json, bufferView.buffer);
-        detail::ReadRequiredField("byteLength", json, bufferView.byteLength);
+        std::vector<uint8_t> data{};
 
-        detail::ReadOptionalField("byteOffset", json, bufferView.byteOffset);
-        detail::ReadOptionalField("byteStride", json, bufferView.byteStride);
-        detail::ReadOptionalField("name", json, bufferView.name);
-        detail::ReadOptionalField("target", json, bufferView.target);
+        // Storage owned outside of the buffer (e.g. a memory mapped file) holding byteLength bytes.
+        // When set, it is used in place of `data`. Copies of the buffer share the same storage.
+        std::shared_ptr<uint8_t> externalData{};
 
-        detail::ReadExtensionsAndExtras(json, bufferView.extensionsAndExtras);
-    }
+        // Set by loads with ReadOptions::DeferBufferData. The contents are read on the first GetData() call, which
+        // then throws the load errors; copies of the buffer share the loaded contents.
+        std::shared_ptr<detail::DeferredData> deferredData{};
 
-    inline void from_json(nlohmann::json const & json, Camera::Type & cameraType)
-    {
-        std::string type = json.get<std::string>();
-        if (type == "orthographic")
+        FX_GLTF_NODISCARD Span<uint8_t> GetData()
         {
-            cameraType = Camera::Type::Orthographic;
+            if (externalData == nullptr && deferredData != nullptr)
+            {
+                return Span<uint8_t>(deferredData->Get(*this), static_cast<std::size_t>(byteLength));
+            }
+
+            return externalData != nullptr ? Span<uint8_t>(externalData.get(), static_cast<std::size_t>(byteLength)) : Span<uint8_t>(data.data(), data.size());
         }
-        else if (type == "perspective")
+
+        FX_GLTF_NODISCARD Span<uint8_t const> GetData() const
         {
-            cameraType = Camera::Type::Perspective;
+            if (externalData == nullptr && deferredData != nullptr)
+            {
+                return Span<uint8_t const>(deferredData->Get(*this), static_cast<std::size_t>(byteLength));
+            }
+
+            return externalData != nullptr ? Span<uint8_t const>(externalData.get(), static_cast<std::size_t>(byteLength)) : Span<uint8_t const>(data.data(), data.size());
         }
-        else
+
+        FX_GLTF_NODISCARD bool IsEmbeddedResource() const noexcept
         {
-            throw invalid_gltf_document("Unknown camera.type value", type);
+            return uri.find(detail::MimetypeApplicationOctet) == 0 || uri.find(detail::MimetypeGLTFBuffer) == 0;
         }
-    }
 
-    inline void from_json(nlohmann::json const & json, Camera::Orthographic & camera)
-    {
-        detail::ReadRequiredField("xmag", json, camera.xmag);
-        detail::ReadRequiredField("ymag", json, camera.ymag);
-        detail::ReadRequiredField("zfar", json, camera.zfar);
-        detail::ReadRequiredField("znear", json, camera.znear);
+        void SetEmbeddedResource()
+        {
+            const Span<uint8_t const> bytes = GetData();
+            const std::size_t prefixLength = std::char_traits<char>::length(detail::MimetypeApplicationOctet) + 1;
 
-        detail::ReadExtensionsAndExtras(json, camera.extensionsAndExtras);
-    }
+            uri.assign(prefixLength + base64::GetEncodedLength(bytes.size()), '\0');
+            std::memcpy(&uri[0], detail::MimetypeApplicationOctet, prefixLength - 1);
+            uri[prefixLength - 1] = ',';
+            base64::Encode(bytes.data(), bytes.size(), &uri[prefixLength]);
+        }
 
-    inline void from_json(nlohmann::json const & json, Camera::Perspective & camera)
-    {
-        detail::ReadRequiredField("yfov", json, camera.yfov);
-        detail::ReadRequiredField("znear", json, camera.znear);
+        // Marks the buffer as embedded without encoding it yet: `uri` only holds the data URI prefix and Save streams
+        // the base64 payload straight into the output. Prefer this for large buffers.
+        void SetEmbeddedResourceOnSave()
+        {
+            uri = std::string(detail::MimetypeApplicationOctet).append(",");
+        }
+
+        FX_GLTF_NODISCARD bool IsEmbeddedResourceOnSave() const noexcept
+        {
+            const std::size_t prefixLength = std::char_traits<char>::length(detail::MimetypeApplicationOctet);
+            return uri.length() == prefixLength + 1 && uri.back() == ',' && uri.compare(0, prefixLength, detail::MimetypeApplicationOctet) == 0;
+        }
+    };
+
+    struct BufferView
+    {
+        enum class TargetType : uint16_t
+        {
+            None = 0,
+            ArrayBuffer = 34962,
+            ElementArrayBuffer = 34963
+        };
+
+        std::string name;
+
+        int32_t buffer{ -1 };
+        uint64_t byteOffset{};
+        uint64_t byteLength{};
+        uint32_t byteStride{};
+
+        TargetType target{ TargetType::None };
+
+        nlohmann::json extensionsAndExtras{};
+    };
+
+    struct Camera
+    {
+        enum class Type
+        {
+            None,
+            Orthographic,
+            Perspective
+        };
+
+        struct Orthographic : NeverEmpty
+        {
+            float xmag{ defaults::FloatSentinel };
+            float ymag{ defaults::FloatSentinel };
+            float zfar{ -defaults::FloatSentinel };
+            float znear{ -defaults::FloatSentinel };
+
+            nlohmann::json extensionsAndExtras{};
+        };
+
+        struct Perspective : NeverEmpty
+        {
+            float aspectRatio{};
+            float yfov{};
+            float zfar{};
+            float znear{};
+
+            nlohmann::json extensionsAndExtras{};
+        };
+
+        std::string name{};
+        Type type{ Type::None };
+
+        Orthographic orthographic;
+        Perspective perspective;
+
+        nlohmann::json extensionsAndExtras{};
+    };
+
+    struct Image
+    {
+        int32_t bufferView{};
+
+        std::string name;
+        std::string uri;
+        std::string mimeType;
+
+        nlohmann::json extensionsAndExtras{};
+
+        FX_GLTF_NODISCARD bool IsEmbeddedResource() const noexcept
+        {
+            return uri.find(detail::MimetypeImagePNG) == 0 || uri.find(detail::MimetypeImageJPG) == 0;
+        }
+
+        void MaterializeData(std::vector<uint8_t> & data) const
+        {
+            char const * const mimetype = uri.find(detail::MimetypeImagePNG) == 0 ? detail::MimetypeImagePNG : detail::MimetypeImageJPG;
+            const std::size_t startPos = std::char_traits<char>::length(mimetype) + 1;
+
+#if defined(FX_GLTF_HAS_CPP_17)
+            const std::size_t base64Length = uri.length() - startPos;
+            const bool success = base64::TryDecode({ &uri[startPos], base64Length }, data);
+#else
+            const bool success = base64::TryDecode(uri.substr(startPos), data);
+#endif
+            if (!success)
+            {
+                throw invalid_gltf_document("Invalid buffer.uri value", "malformed base64");
+            }
+        }
+    };
+
+    struct Material
+    {
+        enum class AlphaMode : uint8_t
+        {
+            Opaque,
+            Mask,
+            Blend
+        };
+
+        struct Texture
+        {
+            int32_t index{ -1 };
+            int32_t texCoord{};
+
+            nlohmann::json extensionsAndExtras{};
+
+            FX_GLTF_NODISCARD bool empty() const noexcept
+            {
+                return index == -1;
+            }
+        };
+
+        struct NormalTexture : Texture
+        {
+            float scale{ defaults::IdentityScalar };
+        };
+
+        struct OcclusionTexture : Texture
+        {
+            float strength{ defaults::IdentityScalar };
+        };
+
+        struct PBRMetallicRoughness
+        {
+            std::array<float, 4> baseColorFactor = { defaults::IdentityVec4 };
+            Texture baseColorTexture;
+
+            float roughnessFactor{ defaults::IdentityScalar };
+            float metallicFactor{ defaults::IdentityScalar };
+            Texture metallicRoughnessTexture;
+
+            nlohmann::json extensionsAndExtras{};
+
+            FX_GLTF_NODISCARD bool empty() const
+            {
+                return baseColorTexture.empty() && metallicRoughnessTexture.empty() && metallicFactor == 1.0f && roughnessFactor == 1.0f && baseColorFactor == defaults::IdentityVec4;
+            }
+        };
+
+        float alphaCutoff{ defaults::MaterialAlphaCutoff };
+        AlphaMode alphaMode{ AlphaMode::Opaque };
+
+        bool doubleSided{ defaults::MaterialDoubleSided };
+
+        NormalTexture normalTexture;
+        OcclusionTexture occlusionTexture;
+        PBRMetallicRoughness pbrMetallicRoughness;
+
+        Texture emissiveTexture;
+        std::array<float, 3> emissiveFactor = { defaults::NullVec3 };
+
+        std::string name;
+        nlohmann::json extensionsAndExtras{};
+    };
+
+    struct Primitive
+    {
+        enum class Mode : uint8_t
+        {
+            Points = 0,
+            Lines = 1,
+            LineLoop = 2,
+            LineStrip = 3,
+            Triangles = 4,
+            TriangleStrip = 5,
+            TriangleFan = 6
+        };
+
+        int32_t indices{ -1 };
+        int32_t material{ -1 };
+
+        Mode mode{ Mode::Triangles };
+
+        Attributes attributes{};
+        std::vector<Attributes> targets{};
+
+        nlohmann::json extensionsAndExtras{};
+    };
+
+    struct Mesh
+    {
+        std::string name;
+
+        std::vector<float> weights{};
+        std::vector<Primitive> primitives{};
+
+        nlohmann::json extensionsAndExtras{};
+    };
+
+    struct Node
+    {
+        std::string name;
+
+        int32_t camera{ -1 };
+        int32_t mesh{ -1 };
+        int32_t skin{ -1 };
+
+        std::array<float, 16> matrix{ defaults::IdentityMatrix };
+        std::array<float, 4> rotation{ defaults::IdentityRotation };
+        std::array<float, 3> scale{ defaults::IdentityVec3 };
+        std::array<float, 3> translation{ defaults::NullVec3 };
+
+        std::vector<int32_t> children{};
+        std::vector<float> weights{};
+
+        nlohmann::json extensionsAndExtras{};
+    };
+
+    struct Sampler
+    {
+        enum class MagFilter : uint16_t
+        {
+            None,
+            Nearest = 9728,
+            Linear = 9729
+        };
+
+        enum class MinFilter : uint16_t
+        {
+            None,
+            Nearest = 9728,
+            Linear = 9729,
+            NearestMipMapNearest = 9984,
+            LinearMipMapNearest = 9985,
+            NearestMipMapLinear = 9986,
+            LinearMipMapLinear = 9987
+        };
+
+        enum class WrappingMode : uint16_t
+        {
+            ClampToEdge = 33071,
+            MirroredRepeat = 33648,
+            Repeat = 10497
+        };
+
+        std::string name;
+
+        MagFilter magFilter{ MagFilter::None };
+        MinFilter minFilter{ MinFilter::None };
+
+        WrappingMode wrapS{ WrappingMode::Repeat };
+        WrappingMode wrapT{ WrappingMode::Repeat };
+
+        nlohmann::json extensionsAndExtras{};
+
+        FX_GLTF_NODISCARD bool empty() const noexcept
+        {
+            return name.empty() && magFilter == MagFilter::None && minFilter == MinFilter::None && wrapS == WrappingMode::Repeat && wrapT == WrappingMode::Repeat && extensionsAndExtras.empty();
+        }
+    };
+
+    struct Scene
+    {
+        std::string name;
+
+        std::vector<uint32_t> nodes{};
+
+        nlohmann::json extensionsAndExtras{};
+    };
+
+    struct Skin
+    {
+        int32_t inverseBindMatrices{ -1 };
+        int32_t skeleton{ -1 };
+
+        std::string name;
+        std::vector<uint32_t> joints{};
+
+        nlohmann::json extensionsAndExtras{};
+    };
+
+    struct Texture
+    {
+        std::string name;
+
+        int32_t sampler{ -1 };
+        int32_t source{ -1 };
+
+        nlohmann::json extensionsAndExtras{};
+    };
+
+    struct Document
+    {
+        Asset asset;
+
+        std::vector<Accessor> accessors{};
+        std::vector<Animation> animations{};
+        std::vector<Buffer> buffers{};
+        std::vector<BufferView> bufferViews{};
+        std::vector<Camera> cameras{};
+        std::vector<Image> images{};
+        std::vector<Material> materials{};
+        std::vector<Mesh> meshes{};
+        std::vector<Node> nodes{};
+        std::vector<Sampler> samplers{};
+        std::vector<Scene> scenes{};
+        std::vector<Skin> skins{};
+        std::vector<Texture> textures{};
+
+        int32_t scene{ -1 };
+        std::vector<std::string> extensionsUsed{};
+        std::vector<std::string> extensionsRequired{};
+
+        nlohmann::json extensionsAndExtras{};
+    };
+
+    struct ReadQuotas
+    {
+        uint32_t MaxBufferCount{ detail::DefaultMaxBufferCount };
+        uint64_t MaxFileSize{ detail::DefaultMaxMemoryAllocation };
+        uint64_t MaxBufferByteLength{ detail::DefaultMaxMemoryAllocation };
+    };
+
+    // A byte range of a resource to read, and the storage receiving it
+    struct ResourceRange
+    {
+        uint64_t offset{};
+        Span<uint8_t> target{};
+    };
+
+    // Serves external buffer uris from storage other than the local file system: archives, blob stores, caches or
+    // HTTP. Loaders issue the reads of every external buffer of a document before waiting on any, so implementations
+    // can pipeline or batch them. Embedded (data uri) buffers never reach the resolver.
+    class ResourceResolver
+    {
+    public:
+        virtual ~ResourceResolver() = default;
+
+        // Fills the target of each range from the resource named by uri. `ranges` is only valid during the call; the
+        // targets stay valid until the returned future is ready. A default constructed future means the read already
+        // completed. Partial loads request several ranges, other loads a single range covering buffer.byteLength.
+        virtual std::future<void> Read(std::string const & uri, std::vector<ResourceRange> const & ranges) = 0;
+
+        // Stores an external buffer written by Save.
+        virtual void Write(std::string const & uri, Span<uint8_t const> data) = 0;
+    };
+
+    // Shares the contents of external buffer files between loads (ReadOptions::BufferCache), e.g. material libraries
+    // or props referenced by many documents. Files are identified by canonical path, size and last write time, so a
+    // modified file is read again. Only weak references are held: contents go away with the last buffer using them.
+    // Shared contents must be treated as read-only. The cache may be used by several loads and threads at once.
+    class SharedBufferCache
+    {
+    public:
+        // Returns the cached first byteLength bytes of the file, or reads them with `load`. Concurrent requests for
+        // the same contents wait for a single load. Files which cannot be identified are loaded without caching.
+        std::shared_ptr<uint8_t> GetOrLoad(FX_GLTF_FILESYSTEM::path const & filePath, uint64_t byteLength, std::function<std::shared_ptr<uint8_t>()> const & load)
+        {
+            Key key{};
+            if (!CreateKey(filePath, byteLength, key))
+            {
+                return load();
+            }
+
+            std::promise<std::shared_ptr<uint8_t>> loaded{};
+            std::shared_future<std::shared_ptr<uint8_t>> pending{};
+            {
+                std::lock_guard<std::mutex> lock(m_mutex);
+                Entry & entry = m_entries[key];
+                std::shared_ptr<uint8_t> data = entry.data.lock();
+                if (data != nullptr)
+                {
+                    return data;
+                }
+
+                if (entry.loading.valid())
+                {
+                    pending = entry.loading;
+                }
+                else
+                {
+                    entry.loading = loaded.get_future().share();
+                }
+            }
+
+            if (pending.valid())
+            {
+                return pending.get();
+            }
+
+            std::shared_ptr<uint8_t> data{};
+            try
+            {
+                data = load();
+            }
+            catch (...)
+            {
+                Finish(key, nullptr);
+                loaded.set_exception(std::current_exception());
+                throw;
+            }
+
+            Finish(key, data);
+            loaded.set_value(data);
+            return data;
+        }
+
+        // The number of file contents currently shared
+        FX_GLTF_NODISCARD std::size_t size() const
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            return static_cast<std::size_t>(std::count_if(m_entries.begin(), m_entries.end(), [](auto const & entry) { return !entry.second.data.expired(); }));
+        }
+
+    private:
+        struct Key
+        {
+            FX_GLTF_FILESYSTEM::path path{};
+            uint64_t fileSize{};
+            int64_t writeTime{};
+            uint64_t byteLength{};
+
+            bool operator<(Key const & other) const
+            {
+                return std::tie(path, fileSize, writeTime, byteLength) < std::tie(other.path, other.fileSize, other.writeTime, other.byteLength);
+            }
+        };
+
+        struct Entry
+        {
+            std::weak_ptr<uint8_t> data{};
+            std::shared_future<std::shared_ptr<uint8_t>> loading{};
+        };
+
+        mutable std::mutex m_mutex{};
+        std::map<Key, Entry> m_entries{};
+
+        static bool CreateKey(FX_GLTF_FILESYSTEM::path const & filePath, uint64_t byteLength, Key & key)
+        {
+            std::error_code error{};
+            key.path = FX_GLTF_FILESYSTEM::canonical(filePath, error);
+            if (!error)
+            {
+                key.fileSize = static_cast<uint64_t>(FX_GLTF_FILESYSTEM::file_size(key.path, error));
+            }
+
+            if (!error)
+            {
+                key.writeTime = static_cast<int64_t>(FX_GLTF_FILESYSTEM::last_write_time(key.path, error).time_since_epoch().count());
+            }
+
+            key.byteLength = byteLength;
+            return !error;
+        }
+
+        void Finish(Key const & key, std::shared_ptr<uint8_t> const & data)
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            Entry & entry = m_entries[key];
+            entry.data = data;
+            entry.loading = {};
+
+            // Drop the entries of contents released meanwhile
+            for (auto it = m_entries.begin(); it != m_entries.end();)
+            {
+                it = it->second.data.expired() && !it->second.loading.valid() ? m_entries.erase(it) : std::next(it);
+            }
+        }
+    };
+
+    struct ReadOptions
+    {
+        // Allocates storage for buffer contents so loaders can place data directly into memory chosen by the
+        // application (arenas, staging memory etc.). The storage must hold at least byteLength bytes and is
+        // released through its deleter once the last buffer referencing it goes away. When not set, buffer
+        // contents are placed in Buffer::data.
+        std::function<std::shared_ptr<uint8_t>(std::size_t byteLength)> BufferAllocator{};
+
+        // The number of threads used to read and decode external and embedded buffers. 1 loads them one after
+        // another on the calling thread, 0 uses std::thread::hardware_concurrency(). When more than 1 thread is
+        // used, BufferAllocator must be safe to call concurrently.
+        uint32_t MaxThreadCount{ 1 };
+
+        // Leaves buffer contents unread until Buffer::GetData() is first called, directly or through the accessor
+        // and bufferView helpers. Only the uri, or the GLB BIN chunk location when loading a .glb from a path, is
+        // kept until then. Buffer::data stays empty for such buffers.
+        bool DeferBufferData{};
+
+        // When set to a scene index, external buffer files are only read where that scene's meshes, skins, node
+        // animations and material images reference them. The remaining bytes are zeroed, or left as allocated with
+        // a BufferAllocator. Referenced ranges less than PartialLoadMaxGap bytes apart are read as one.
+        int32_t PartialLoadScene{ -1 };
+        uint64_t PartialLoadMaxGap{ 64 * 1024 };
+
+        // Serves the external buffers instead of the file system; see ResourceResolver.
+        std::shared_ptr<ResourceResolver> Resolver{};
+
+        // Shares external buffer files with other loads using the same cache; see SharedBufferCache. Partial loads and
+        // resolved buffers are not cached.
+        std::shared_ptr<SharedBufferCache> BufferCache{};
+    };
+
+    // A piece of the BIN chunk written by SaveBinary: either the bytes of `data`, or a `write` callback which must put
+    // exactly byteLength bytes into the stream it is given.
+    struct BinaryChunkPart
+    {
+        Span<uint8_t const> data{};
+
+        uint64_t byteLength{};
+        std::function<void(std::ostream & output)> write{};
+
+        FX_GLTF_NODISCARD uint64_t size() const noexcept
+        {
+            return write ? byteLength : data.size();
+        }
+    };
+
+    struct PackOptions
+    {
+        // Aligns each bufferView to the largest component size of its accessors rather than to 4 bytes. Vertex
+        // buffers (strided or targeting ArrayBuffer) stay 4 byte aligned.
+        bool AlignToComponentSize{};
+
+        // Leaves out the bytes which no bufferView covers rather than copying every buffer whole
+        bool DropUnreferencedBytes{};
+    };
+
+    // The float attributes QuantizeMeshes converts to KHR_mesh_quantization types
+    struct QuantizeOptions
+    {
+        // POSITION (and morph target POSITION) as Short; a child node undoes the offset and scale
+        bool Positions{ true };
+
+        // NORMAL as normalized Byte
+        bool Normals{ true };
+
+        // TEXCOORD_n as normalized UnsignedShort, for sets within [0, 1]
+        bool TexCoords{ true };
+    };
+
+    struct SaveOptions
+    {
+        // Writes the min/max of every accessor as computed from its data (see ComputeBounds) in place of the stored
+        // values. The document is left unchanged. Every buffer an accessor reads must hold its contents, including
+        // the first buffer with SaveBinary.
+        bool RefreshBounds{};
+
+        // The number of threads used by RefreshBounds; 0 uses std::thread::hardware_concurrency()
+        uint32_t MaxThreadCount{ 1 };
+
+        // Receives the external buffers instead of the file system; see ResourceResolver.
+        std::shared_ptr<ResourceResolver> Resolver{};
+    };
+
+    // Per component bounds of an accessor, in the form of Accessor::min and Accessor::max
+    struct AccessorBounds
+    {
+        std::vector<float> min{};
+        std::vector<float> max{};
+    };
+
+    inline Span<uint8_t const> GetData(Document const & document, BufferView const & bufferView)
+    {
+        if (bufferView.buffer < 0 || static_cast<std::size_t>(bufferView.buffer) >= document.buffers.size())
+        {
+            throw invalid_gltf_document("Invalid bufferView.buffer value");
+        }
+
+        const Span<uint8_t const> bufferData = document.buffers[bufferView.buffer].GetData();
+        if (bufferView.byteOffset > bufferData.size() || bufferView.byteLength > bufferData.size() - bufferView.byteOffset)
+        {
+            throw invalid_gltf_document("Invalid bufferView.byteLength value : range exceeds buffer size");
+        }
+
+        return bufferData.subspan(static_cast<std::size_t>(bufferView.byteOffset), static_cast<std::size_t>(bufferView.byteLength));
+    }
+
+    inline Span<uint8_t> GetData(Document & document, BufferView const & bufferView)
+    {
+        const Span<uint8_t const> data = GetData(static_cast<Document const &>(document), bufferView);
+        return { const_cast<uint8_t *>(data.data()), data.size() }; // NOLINT(cppcoreguidelines-pro-type-const-cast): the document is non-const
+    }
+
+    // Returns the bytes of the accessor's bufferView starting at the accessor's first element
+    inline Span<uint8_t const> GetData(Document const & document, Accessor const & accessor)
+    {
+        if (accessor.bufferView < 0 || static_cast<std::size_t>(accessor.bufferView) >= document.bufferViews.size())
+        {
+            throw invalid_gltf_document("Invalid accessor.bufferView value");
+        }
+
+        const Span<uint8_t const> bufferViewData = GetData(document, document.bufferViews[accessor.bufferView]);
+        if (accessor.byteOffset > bufferViewData.size())
+        {
+            throw invalid_gltf_document("Invalid accessor.byteOffset value : range exceeds bufferView size");
+        }
+
+        return bufferViewData.subspan(static_cast<std::size_t>(accessor.byteOffset), bufferViewData.size() - static_cast<std::size_t>(accessor.byteOffset));
+    }
+
+    inline Span<uint8_t> GetData(Document & document, Accessor const & accessor)
+    {
+        const Span<uint8_t const> data = GetData(static_cast<Document const &>(document), accessor);
+        return { const_cast<uint8_t *>(data.data()), data.size() }; // NOLINT(cppcoreguidelines-pro-type-const-cast): the document is non-const
+    }
+
+    inline uint32_t GetComponentSize(Accessor::ComponentType componentType) noexcept
+    {
+        switch (componentType)
+        {
+        case Accessor::ComponentType::Byte:
+        case Accessor::ComponentType::UnsignedByte:
+            return 1;
+        case Accessor::ComponentType::Short:
+        case Accessor::ComponentType::UnsignedShort:
+            return 2;
+        case Accessor::ComponentType::UnsignedInt:
+        case Accessor::ComponentType::Float:
+            return 4;
+        case Accessor::ComponentType::None:
+            break;
+        }
+
+        return 0;
+    }
+
+    inline uint32_t GetComponentCount(Accessor::Type type) noexcept
+    {
+        switch (type)
+        {
+        case Accessor::Type::Scalar:
+            return 1;
+        case Accessor::Type::Vec2:
+            return 2;
+        case Accessor::Type::Vec3:
+            return 3;
+        case Accessor::Type::Vec4:
+        case Accessor::Type::Mat2:
+            return 4;
+        case Accessor::Type::Mat3:
+            return 9;
+        case Accessor::Type::Mat4:
+            return 16;
+        case Accessor::Type::None:
+            break;
+        }
+
+        return 0;
+    }
+
+    namespace detail
+    {
+        inline uint32_t GetMatrixRowCount(Accessor::Type type) noexcept
+        {
+            switch (type)
+            {
+            case Accessor::Type::Mat2:
+                return 2;
+            case Accessor::Type::Mat3:
+                return 3;
+            case Accessor::Type::Mat4:
+                return 4;
+            default:
+                return 0;
+            }
+        }
+
+        // Matrix columns must start on 4-byte boundaries which pads MAT2/MAT3 columns of small components
+        inline uint32_t GetComponentOffset(Accessor::Type type, uint32_t componentSize, uint32_t componentIndex) noexcept
+        {
+            const uint32_t rows = GetMatrixRowCount(type);
+            if (rows == 0)
+            {
+                return componentIndex * componentSize;
+            }
+
+            const uint32_t columnStride = (rows * componentSize + 3) & (~3u);
+            return (componentIndex / rows) * columnStride + (componentIndex % rows) * componentSize;
+        }
+    } // namespace detail
+
+    // The size of a single element, including any matrix column padding
+    inline uint32_t GetElementSize(Accessor const & accessor) noexcept
+    {
+        const uint32_t componentCount = GetComponentCount(accessor.type);
+        if (componentCount == 0)
+        {
+            return 0;
+        }
+
+        const uint32_t componentSize = GetComponentSize(accessor.componentType);
+        const uint32_t rows = detail::GetMatrixRowCount(accessor.type);
+        return rows == 0 ? componentCount * componentSize : rows * ((rows * componentSize + 3) & (~3u));
+    }
+
+    namespace detail
+    {
+        // Element types not described here are read as raw bytes
+        template <typename TElement>
+        struct AccessorElementTraits
+        {
+            using Component = uint8_t;
+            static constexpr uint32_t Count = 0;
+            static constexpr Accessor::ComponentType Type = Accessor::ComponentType::None;
+        };
+
+        template <typename TComponent, Accessor::ComponentType TComponentType>
+        struct AccessorComponentTraits
+        {
+            using Component = TComponent;
+            static constexpr uint32_t Count = 1;
+            static constexpr Accessor::ComponentType Type = TComponentType;
+        };
+
+        template <>
+        struct AccessorElementTraits<int8_t> : AccessorComponentTraits<int8_t, Accessor::ComponentType::Byte>
+        {
+        };
+
+        template <>
+        struct AccessorElementTraits<uint8_t> : AccessorComponentTraits<uint8_t, Accessor::ComponentType::UnsignedByte>
+        {
+        };
+
+        template <>
+        struct AccessorElementTraits<int16_t> : AccessorComponentTraits<int16_t, Accessor::ComponentType::Short>
+        {
+        };
+
+        template <>
+        struct AccessorElementTraits<uint16_t> : AccessorComponentTraits<uint16_t, Accessor::ComponentType::UnsignedShort>
+        {
+        };
+
+        template <>
+        struct AccessorElementTraits<uint32_t> : AccessorComponentTraits<uint32_t, Accessor::ComponentType::UnsignedInt>
+        {
+        };
+
+        template <>
+        struct AccessorElementTraits<float> : AccessorComponentTraits<float, Accessor::ComponentType::Float>
+        {
+        };
+
+        template <typename TComponent, std::size_t TCount>
+        struct AccessorElementTraits<std::array<TComponent, TCount>>
+        {
+            using Component = typename AccessorElementTraits<TComponent>::Component;
+            static constexpr uint32_t Count = static_cast<uint32_t>(TCount) * AccessorElementTraits<TComponent>::Count;
+            static constexpr Accessor::ComponentType Type = AccessorElementTraits<TComponent>::Type;
+        };
+
+        template <typename TSource>
+        inline TSource LoadComponent(uint8_t const * source) noexcept
+        {
+            TSource value;
+            std::memcpy(&value, source, sizeof(TSource));
+            return value;
+        }
+
+        // Normalization rules as defined by the glTF 2.0 specification
+        inline float NormalizeComponent(int8_t value) noexcept
+        {
+            const float result = value / 127.0f;
+            return result < -1.0f ? -1.0f : result;
+        }
+
+        inline float NormalizeComponent(uint8_t value) noexcept
+        {
+            return value / 255.0f;
+        }
+
+        inline float NormalizeComponent(int16_t value) noexcept
+        {
+            const float result = value / 32767.0f;
+            return result < -1.0f ? -1.0f : result;
+        }
+
+        inline float NormalizeComponent(uint16_t value) noexcept
+        {
+            return value / 65535.0f;
+        }
+
+        inline float NormalizeComponent(uint32_t value) noexcept
+        {
+            return static_cast<float>(value / 4294967295.0);
+        }
+
+        inline float NormalizeComponent(float value) noexcept
+        {
+            return value;
+        }
+
+        template <typename TTarget, typename TSource>
+        inline TTarget ConvertComponent(TSource value, bool normalized, std::true_type /* floating point target */) noexcept
+        {
+            return normalized ? static_cast<TTarget>(NormalizeComponent(value)) : static_cast<TTarget>(value);
+        }
+
+        template <typename TTarget, typename TSource>
+        inline TTarget ConvertComponent(TSource value, bool /* normalized */, std::false_type /* integral target */) noexcept
+        {
+            return static_cast<TTarget>(value);
+        }
+
+        template <typename TTarget>
+        inline TTarget ReadComponent(uint8_t const * source, Accessor::ComponentType componentType, bool normalized) noexcept
+        {
+            using IsFloatingPoint = typename std::is_floating_point<TTarget>::type;
+            switch (componentType)
+            {
+            case Accessor::ComponentType::Byte:
+                return ConvertComponent<TTarget>(LoadComponent<int8_t>(source), normalized, IsFloatingPoint{});
+            case Accessor::ComponentType::UnsignedByte:
+                return ConvertComponent<TTarget>(LoadComponent<uint8_t>(source), normalized, IsFloatingPoint{});
+            case Accessor::ComponentType::Short:
+                return ConvertComponent<TTarget>(LoadComponent<int16_t>(source), normalized, IsFloatingPoint{});
+            case Accessor::ComponentType::UnsignedShort:
+                return ConvertComponent<TTarget>(LoadComponent<uint16_t>(source), normalized, IsFloatingPoint{});
+            case Accessor::ComponentType::UnsignedInt:
+                return ConvertComponent<TTarget>(LoadComponent<uint32_t>(source), normalized, IsFloatingPoint{});
+            case Accessor::ComponentType::Float:
+                return ConvertComponent<TTarget>(LoadComponent<float>(source), normalized, IsFloatingPoint{});
+            case Accessor::ComponentType::None:
+                break;
+            }
+
+            return TTarget{};
+        }
+
+#if defined(FX_GLTF_SIMD_AVX2)
+        struct SimdKernel
+        {
+            using Integer = __m256i;
+            static constexpr std::size_t Width = 8;
+
+            static Integer LoadByte(uint8_t const * source) noexcept
+            {
+                return _mm256_cvtepi8_epi32(_mm_loadl_epi64(reinterpret_cast<__m128i const *>(source)));
+            }
+
+            static Integer LoadUnsignedByte(uint8_t const * source) noexcept
+            {
+                return _mm256_cvtepu8_epi32(_mm_loadl_epi64(reinterpret_cast<__m128i const *>(source)));
+            }
+
+            static Integer LoadShort(uint8_t const * source) noexcept
+            {
+                return _mm256_cvtepi16_epi32(_mm_loadu_si128(reinterpret_cast<__m128i const *>(source)));
+            }
+
+            static Integer LoadUnsignedShort(uint8_t const * source) noexcept
+            {
+                return _mm256_cvtepu16_epi32(_mm_loadu_si128(reinterpret_cast<__m128i const *>(source)));
+            }
+
+            static void StoreFloat(float * target, Integer value, float divisor, bool clamp) noexcept
+            {
+                __m256 result = _mm256_cvtepi32_ps(value);
+                if (divisor != 0.0f)
+                {
+                    result = _mm256_div_ps(result, _mm256_set1_ps(divisor));
+                    if (clamp)
+                    {
+                        result = _mm256_max_ps(result, _mm256_set1_ps(-1.0f));
+                    }
+                }
+
+                _mm256_storeu_ps(target, result);
+            }
+
+            static void StoreUInt32(uint32_t * target, Integer value) noexcept
+            {
+                _mm256_storeu_si256(reinterpret_cast<__m256i *>(target), value);
+            }
+
+            static void Quantize(int32_t * target, float const * source, float const * offsets, float factor, float low, float high) noexcept
+            {
+                __m256 value = _mm256_mul_ps(_mm256_sub_ps(_mm256_loadu_ps(source), _mm256_loadu_ps(offsets)), _mm256_set1_ps(factor));
+                value = _mm256_min_ps(_mm256_max_ps(value, _mm256_set1_ps(low)), _mm256_set1_ps(high));
+                _mm256_storeu_si256(reinterpret_cast<__m256i *>(target), _mm256_cvtps_epi32(value));
+            }
+
+            using Float = __m256;
+
+            static Float LoadFloat(float const * source) noexcept
+            {
+                return _mm256_loadu_ps(source);
+            }
+
+            static void StoreFloat(float * target, Float value) noexcept
+            {
+                _mm256_storeu_ps(target, value);
+            }
+
+            // Keep `bound` where `value` is NaN, like std::min/std::max with the bound first
+            static Float Min(Float value, Float bound) noexcept
+            {
+                return _mm256_min_ps(value, bound);
+            }
+
+            static Float Max(Float value, Float bound) noexcept
+            {
+                return _mm256_max_ps(value, bound);
+            }
+        };
+#elif defined(FX_GLTF_SIMD_SSE2)
+        struct SimdKernel
+        {
+            using Integer = __m128i;
+            static constexpr std::size_t Width = 4;
+
+            static Integer LoadByte(uint8_t const * source) noexcept
+            {
+                Integer value = _mm_cvtsi32_si128(LoadComponent<int32_t>(source));
+                value = _mm_unpacklo_epi8(value, value);
+                return _mm_srai_epi32(_mm_unpacklo_epi16(value, value), 24);
+            }
+
+            static Integer LoadUnsignedByte(uint8_t const * source) noexcept
+            {
+                const Integer zero = _mm_setzero_si128();
+                return _mm_unpacklo_epi16(_mm_unpacklo_epi8(_mm_cvtsi32_si128(LoadComponent<int32_t>(source)), zero), zero);
+            }
+
+            static Integer LoadShort(uint8_t const * source) noexcept
+            {
+                const Integer value = _mm_loadl_epi64(reinterpret_cast<__m128i const *>(source));
+                return _mm_srai_epi32(_mm_unpacklo_epi16(value, value), 16);
+            }
+
+            static Integer LoadUnsignedShort(uint8_t const * source) noexcept
+            {
+                return _mm_unpacklo_epi16(_mm_loadl_epi64(reinterpret_cast<__m128i const *>(source)), _mm_setzero_si128());
+            }
+
+            static void StoreFloat(float * target, Integer value, float divisor, bool clamp) noexcept
+            {
+                __m128 result = _mm_cvtepi32_ps(value);
+                if (divisor != 0.0f)
+                {
+                    result = _mm_div_ps(result, _mm_set1_ps(divisor));
+                    if (clamp)
+                    {
+                        result = _mm_max_ps(result, _mm_set1_ps(-1.0f));
+                    }
+                }
+
+                _mm_storeu_ps(target, result);
+            }
+
+            static void StoreUInt32(uint32_t * target, Integer value) noexcept
+            {
+                _mm_storeu_si128(reinterpret_cast<__m128i *>(target), value);
+            }
+
+            static void Quantize(int32_t * target, float const * source, float const * offsets, float factor, float low, float high) noexcept
+            {
+                __m128 value = _mm_mul_ps(_mm_sub_ps(_mm_loadu_ps(source), _mm_loadu_ps(offsets)), _mm_set1_ps(factor));
+                value = _mm_min_ps(_mm_max_ps(value, _mm_set1_ps(low)), _mm_set1_ps(high));
+                _mm_storeu_si128(reinterpret_cast<__m128i *>(target), _mm_cvtps_epi32(value));
+            }
+
+            using Float = __m128;
+
+            static Float LoadFloat(float const * source) noexcept
+            {
+                return _mm_loadu_ps(source);
+            }
+
+            static void StoreFloat(float * target, Float value) noexcept
+            {
+                _mm_storeu_ps(target, value);
+            }
+
+            // Keep `bound` where `value` is NaN, like std::min/std::max with the bound first
+            static Float Min(Float value, Float bound) noexcept
+            {
+                return _mm_min_ps(value, bound);
+            }
+
+            static Float Max(Float value, Float bound) noexcept
+            {
+                return _mm_max_ps(value, bound);
+            }
+        };
+#elif defined(FX_GLTF_SIMD_NEON)
+        struct SimdKernel
+        {
+            using Integer = int32x4_t;
+            static constexpr std::size_t Width = 4;
+
+            static Integer LoadByte(uint8_t const * source) noexcept
+            {
+                const int8x8_t value = vcreate_s8(LoadComponent<uint32_t>(source));
+                return vmovl_s16(vget_low_s16(vmovl_s8(value)));
+            }
+
+            static Integer LoadUnsignedByte(uint8_t const * source) noexcept
+            {
+                const uint8x8_t value = vcreate_u8(LoadComponent<uint32_t>(source));
+                return vreinterpretq_s32_u32(vmovl_u16(vget_low_u16(vmovl_u8(value))));
+            }
+
+            static Integer LoadShort(uint8_t const * source) noexcept
+            {
+                return vmovl_s16(vcreate_s16(LoadComponent<uint64_t>(source)));
+            }
+
+            static Integer LoadUnsignedShort(uint8_t const * source) noexcept
+            {
+                return vreinterpretq_s32_u32(vmovl_u16(vcreate_u16(LoadComponent<uint64_t>(source))));
+            }
+
+            static void StoreFloat(float * target, Integer value, float divisor, bool clamp) noexcept
+            {
+                float32x4_t result = vcvtq_f32_s32(value);
+                if (divisor != 0.0f)
+                {
+                    result = vdivq_f32(result, vdupq_n_f32(divisor));
+                    if (clamp)
+                    {
+                        result = vmaxq_f32(result, vdupq_n_f32(-1.0f));
+                    }
+                }
+
+                vst1q_f32(target, result);
+            }
+
+            static void StoreUInt32(uint32_t * target, Integer value) noexcept
+            {
+                vst1q_u32(target, vreinterpretq_u32_s32(value));
+            }
+
+            static void Quantize(int32_t * target, float const * source, float const * offsets, float factor, float low, float high) noexcept
+            {
+                float32x4_t value = vmulq_f32(vsubq_f32(vld1q_f32(source), vld1q_f32(offsets)), vdupq_n_f32(factor));
+                value = vminq_f32(vmaxq_f32(value, vdupq_n_f32(low)), vdupq_n_f32(high));
+                vst1q_s32(target, vcvtnq_s32_f32(value));
+            }
+
+            using Float = float32x4_t;
+
+            static Float LoadFloat(float const * source) noexcept
+            {
+                return vld1q_f32(source);
+            }
+
+            static void StoreFloat(float * target, Float value) noexcept
+            {
+                vst1q_f32(target, value);
+            }
+
+            // Keep `bound` where `value` is NaN, like std::min/std::max with the bound first. vminq/vmaxq would
+            // propagate the NaN instead.
+            static Float Min(Float value, Float bound) noexcept
+            {
+                return vbslq_f32(vcltq_f32(value, bound), value, bound);
+            }
+
+            static Float Max(Float value, Float bound) noexcept
+            {
+                return vbslq_f32(vcgtq_f32(value, bound), value, bound);
+            }
+        };
+#endif
+
+        // The vector loops below produce the same bits as ReadComponent: every integer converts to float exactly
+        // and normalization divides by the same constant. They return how many components were handled so the
+        // caller can finish the tail with the scalar path.
+        template <typename TLoad>
+        inline std::size_t ConvertToFloatKernel(
+            uint8_t const * source, std::size_t componentSize, float * target, std::size_t count, float divisor, bool clamp, TLoad load) noexcept
+        {
+            std::size_t i = 0;
+#if defined(FX_GLTF_SIMD_AVX2) || defined(FX_GLTF_SIMD_SSE2) || defined(FX_GLTF_SIMD_NEON)
+            for (; i + SimdKernel::Width <= count; i += SimdKernel::Width)
+            {
+                SimdKernel::StoreFloat(target + i, load(source + i * componentSize), divisor, clamp);
+            }
+#else
+            (void)source;
+            (void)componentSize;
+            (void)target;
+            (void)count;
+            (void)divisor;
+            (void)clamp;
+            (void)load;
+#endif
+            return i;
+        }
+
+        template <typename TLoad>
+        inline std::size_t ConvertToUInt32Kernel(uint8_t const * source, std::size_t componentSize, uint32_t * target, std::size_t count, TLoad load) noexcept
+        {
+            std::size_t i = 0;
+#if defined(FX_GLTF_SIMD_AVX2) || defined(FX_GLTF_SIMD_SSE2) || defined(FX_GLTF_SIMD_NEON)
+            for (; i + SimdKernel::Width <= count; i += SimdKernel::Width)
+            {
+                SimdKernel::StoreUInt32(target + i, load(source + i * componentSize));
+            }
+#else
+            (void)source;
+            (void)componentSize;
+            (void)target;
+            (void)count;
+            (void)load;
+#endif
+            return i;
+        }
+
+        // round((source[i] - offsets[i % componentCount]) * factor), clamped to [low, high], rounding to nearest even
+        // like QuantizeComponent. Handles whole groups of Width elements and returns how many components were done.
+        inline std::size_t QuantizeKernel(
+            float const * source, std::size_t count, std::size_t componentCount, float const * offsets, float factor, float low, float high, int32_t * target) noexcept
+        {
+            std::size_t i = 0;
+#if defined(FX_GLTF_SIMD_AVX2) || defined(FX_GLTF_SIMD_SSE2) || defined(FX_GLTF_SIMD_NEON)
+            constexpr std::size_t MaxComponentCount = 4;
+            if (componentCount > MaxComponentCount)
+            {
+                return 0;
+            }
+
+            // A group of Width elements spans componentCount vectors; lane j of vector k is component (k * Width + j) % componentCount
+            std::array<float, MaxComponentCount * SimdKernel::Width> laneOffsets{};
+            for (std::size_t lane = 0; lane < componentCount * SimdKernel::Width; lane++)
+            {
+                laneOffsets[lane] = offsets[lane % componentCount];
+            }
+
+            const std::size_t group = componentCount * SimdKernel::Width;
+            for (; i + group <= count; i += group)
+            {
+                for (std::size_t vector = 0; vector < componentCount; vector++)
+                {
+                    const std::size_t first = i + vector * SimdKernel::Width;
+                    SimdKernel::Quantize(target + first, source + first, &laneOffsets[vector * SimdKernel::Width], factor, low, high);
+                }
+            }
+#else
+            (void)source;
+            (void)count;
+            (void)componentCount;
+            (void)offsets;
+            (void)factor;
+            (void)low;
+            (void)high;
+            (void)target;
+#endif
+            return i;
+        }
+
+        // Lowers low[c] and raises high[c] to the bounds of every component c = i % componentCount of `source`, which
+        // starts at component 0. Handles whole groups of Width elements and returns how many components were done.
+        inline std::size_t MinMaxKernel(float const * source, std::size_t count, std::size_t componentCount, float * low, float * high) noexcept
+        {
+            std::size_t i = 0;
+#if defined(FX_GLTF_SIMD_AVX2) || defined(FX_GLTF_SIMD_SSE2) || defined(FX_GLTF_SIMD_NEON)
+            constexpr std::size_t MaxComponentCount = 4;
+            const std::size_t group = componentCount * SimdKernel::Width;
+            if (componentCount > MaxComponentCount || count < group)
+            {
+                return 0;
+            }
+
+            // As in QuantizeKernel, lane j of vector k is component (k * Width + j) % componentCount
+            std::array<float, MaxComponentCount * SimdKernel::Width> laneLow{};
+            std::array<float, MaxComponentCount * SimdKernel::Width> laneHigh{};
+            for (std::size_t lane = 0; lane < group; lane++)
+            {
+                laneLow[lane] = low[lane % componentCount];
+                laneHigh[lane] = high[lane % componentCount];
+            }
+
+            // std::array would drop the alignment attributes of the vector type
+            SimdKernel::Float vectorLow[MaxComponentCount]{};  // NOLINT(cppcoreguidelines-avoid-c-arrays, modernize-avoid-c-arrays)
+            SimdKernel::Float vectorHigh[MaxComponentCount]{}; // NOLINT(cppcoreguidelines-avoid-c-arrays, modernize-avoid-c-arrays)
+            for (std::size_t vector = 0; vector < componentCount; vector++)
+            {
+                vectorLow[vector] = SimdKernel::LoadFloat(&laneLow[vector * SimdKernel::Width]);
+                vectorHigh[vector] = SimdKernel::LoadFloat(&laneHigh[vector * SimdKernel::Width]);
+            }
+
+            for (; i + group <= count; i += group)
+            {
+                for (std::size_t vector = 0; vector < componentCount; vector++)
+                {
+                    const SimdKernel::Float value = SimdKernel::LoadFloat(source + i + vector * SimdKernel::Width);
+                    vectorLow[vector] = SimdKernel::Min(value, vectorLow[vector]);
+                    vectorHigh[vector] = SimdKernel::Max(value, vectorHigh[vector]);
+                }
+            }
+
+            for (std::size_t vector = 0; vector < componentCount; vector++)
+            {
+                SimdKernel::StoreFloat(&laneLow[vector * SimdKernel::Width], vectorLow[vector]);
+                SimdKernel::StoreFloat(&laneHigh[vector * SimdKernel::Width], vectorHigh[vector]);
+            }
+
+            for (std::size_t lane = 0; lane < group; lane++)
+            {
+                low[lane % componentCount] = (std::min)(low[lane % componentCount], laneLow[lane]);
+                high[lane % componentCount] = (std::max)(high[lane % componentCount], laneHigh[lane]);
+            }
+#else
+            (void)source;
+            (void)count;
+            (void)componentCount;
+            (void)low;
+            (void)high;
+#endif
+            return i;
+        }
+
+        inline void MinMaxComponents(float const * source, std::size_t count, std::size_t componentCount, float * low, float * high) noexcept
+        {
+            for (std::size_t i = MinMaxKernel(source, count, componentCount, low, high); i < count; i++)
+            {
+                low[i % componentCount] = (std::min)(low[i % componentCount], source[i]);
+                high[i % componentCount] = (std::max)(high[i % componentCount], source[i]);
+            }
+        }
+
+        inline int32_t QuantizeComponent(float value, float offset, float factor, float low, float high) noexcept
+        {
+            return static_cast<int32_t>(std::nearbyint((std::min)((std::max)((value - offset) * factor, low), high)));
+        }
+
+        inline void QuantizeComponents(
+            float const * source, std::size_t count, std::size_t componentCount, float const * offsets, float factor, float low, float high, int32_t * target) noexcept
+        {
+            for (std::size_t i = QuantizeKernel(source, count, componentCount, offsets, factor, low, high, target); i < count; i++)
+            {
+                target[i] = QuantizeComponent(source[i], offsets[i % componentCount], factor, low, high);
+            }
+        }
+
+#if defined(FX_GLTF_SIMD_AVX2) || defined(FX_GLTF_SIMD_SSE2) || defined(FX_GLTF_SIMD_NEON)
+        struct LoadByte
+        {
+            SimdKernel::Integer operator()(uint8_t const * source) const noexcept
+            {
+                return SimdKernel::LoadByte(source);
+            }
+        };
+
+        struct LoadUnsignedByte
+        {
+            SimdKernel::Integer operator()(uint8_t const * source) const noexcept
+            {
+                return SimdKernel::LoadUnsignedByte(source);
+            }
+        };
+
+        struct LoadShort
+        {
+            SimdKernel::Integer operator()(uint8_t const * source) const noexcept
+            {
+                return SimdKernel::LoadShort(source);
+            }
+        };
+
+        struct LoadUnsignedShort
+        {
+            SimdKernel::Integer operator()(uint8_t const * source) const noexcept
+            {
+                return SimdKernel::LoadUnsignedShort(source);
+            }
+        };
+#else
+        struct LoadByte
+        {
+        };
+
+        struct LoadUnsignedByte
+        {
+        };
+
+        struct LoadShort
+        {
+        };
+
+        struct LoadUnsignedShort
+        {
+        };
+#endif
+
+        // Converts `count` tightly packed components
+        template <typename TTarget>
+        inline void ConvertComponents(uint8_t const * source, Accessor::ComponentType componentType, bool normalized, TTarget * target, std::size_t count) noexcept
+        {
+            const uint32_t componentSize = GetComponentSize(componentType);
+            for (std::size_t i = 0; i < count; i++)
+            {
+                target[i] = ReadComponent<TTarget>(source + i * componentSize, componentType, normalized);
+            }
+        }
+
+        inline void ConvertComponents(uint8_t const * source, Accessor::ComponentType componentType, bool normalized, float * target, std::size_t count) noexcept
+        {
+            std::size_t converted = 0;
+            switch (componentType)
+            {
+            case Accessor::ComponentType::Byte:
+                converted = ConvertToFloatKernel(source, 1, target, count, normalized ? 127.0f : 0.0f, normalized, LoadByte{});
+                break;
+            case Accessor::ComponentType::UnsignedByte:
+                converted = ConvertToFloatKernel(source, 1, target, count, normalized ? 255.0f : 0.0f, false, LoadUnsignedByte{});
+                break;
+            case Accessor::ComponentType::Short:
+                converted = ConvertToFloatKernel(source, 2, target, count, normalized ? 32767.0f : 0.0f, normalized, LoadShort{});
+                break;
+            case Accessor::ComponentType::UnsignedShort:
+                converted = ConvertToFloatKernel(source, 2, target, count, normalized ? 65535.0f : 0.0f, false, LoadUnsignedShort{});
+                break;
+            case Accessor::ComponentType::Float:
+                std::memcpy(target, source, count * sizeof(float));
+                return;
+            default:
+                break;
+            }
+
+            ConvertComponents<float>(source + converted * GetComponentSize(componentType), componentType, normalized, target + converted, count - converted);
+        }
+
+        inline void ConvertComponents(uint8_t const * source, Accessor::ComponentType componentType, bool normalized, uint32_t * target, std::size_t count) noexcept
+        {
+            std::size_t converted = 0;
+            switch (componentType)
+            {
+            case Accessor::ComponentType::UnsignedByte:
+                converted = ConvertToUInt32Kernel(source, 1, target, count, LoadUnsignedByte{});
+                break;
+            case Accessor::ComponentType::UnsignedShort:
+                converted = ConvertToUInt32Kernel(source, 2, target, count, LoadUnsignedShort{});
+                break;
+            case Accessor::ComponentType::UnsignedInt:
+                std::memcpy(target, source, count * sizeof(uint32_t));
+                return;
+            default:
+                break;
+            }
+
+            ConvertComponents<uint32_t>(source + converted * GetComponentSize(componentType), componentType, normalized, target + converted, count - converted);
+        }
+
+        struct AccessorLayout
+        {
+            uint8_t const * data{};
+            std::size_t stride{};
+            uint32_t elementSize{};
+
+            // True when the components of consecutive elements follow each other without gaps
+            bool packed{};
+        };
+
+        // Validates the accessor's element type and range. `data` is null for accessors without a bufferView.
+        inline AccessorLayout GetAccessorLayout(Document const & document, Accessor const & accessor)
+        {
+            AccessorLayout layout{};
+            layout.elementSize = GetElementSize(accessor);
+            if (layout.elementSize == 0)
+            {
+                throw invalid_gltf_document("Invalid accessor.type value");
+            }
+
+            if (accessor.bufferView < 0 || accessor.count == 0)
+            {
+                return layout;
+            }
+
+            const Span<uint8_t const> data = GetData(document, accessor);
+            const uint32_t byteStride = document.bufferViews[accessor.bufferView].byteStride;
+            layout.stride = byteStride != 0 ? byteStride : layout.elementSize;
+            if (layout.stride * (accessor.count - 1) + layout.elementSize > data.size())
+            {
+                throw invalid_gltf_document("Invalid accessor.count value : range exceeds bufferView size");
+            }
+
+            layout.data = data.data();
+            layout.packed = layout.stride == layout.elementSize &&
+                            layout.elementSize == GetComponentCount(accessor.type) * GetComponentSize(accessor.componentType);
+            return layout;
+        }
+
+        template <typename TTarget>
+        inline void ConvertAccessor(Document const & document, Accessor const & accessor, Span<TTarget> output)
+        {
+            const AccessorLayout layout = GetAccessorLayout(document, accessor);
+            const uint32_t componentCount = GetComponentCount(accessor.type);
+            const std::size_t count = static_cast<std::size_t>(accessor.count) * componentCount;
+            if (output.size() < count)
+            {
+                throw std::out_of_range("ConvertAccessor : output too small");
+            }
+
+            if (layout.data == nullptr)
+            {
+                std::fill(output.begin(), output.begin() + count, TTarget{});
+            }
+            else if (layout.packed)
+            {
+                ConvertComponents(layout.data, accessor.componentType, accessor.normalized, output.data(), count);
+            }
+            else
+            {
+                const uint32_t componentSize = GetComponentSize(accessor.componentType);
+                for (std::size_t i = 0; i < accessor.count; i++)
+                {
+                    uint8_t const * element = layout.data + i * layout.stride;
+                    for (uint32_t c = 0; c < componentCount; c++)
+                    {
+                        output[i * componentCount + c] =
+                            ReadComponent<TTarget>(element + GetComponentOffset(accessor.type, componentSize, c), accessor.componentType, accessor.normalized);
+                    }
+                }
+            }
+        }
+    } // namespace detail
+
+    // Reads every component of the accessor as float, honoring accessor.normalized, into `output` which must hold at
+    // least count * GetComponentCount(type) values. Packed data is converted with the SIMD kernels.
+    inline void ConvertToFloat(Document const & document, Accessor const & accessor, Span<float> output)
+    {
+        detail::ConvertAccessor(document, accessor, output);
+    }
+
+    // Widens the accessor's components to uint32_t, typically to read UnsignedByte/UnsignedShort indices. Normalized,
+    // signed and Float data is not widened.
+    inline void ConvertToUInt32(Document const & document, Accessor const & accessor, Span<uint32_t> output)
+    {
+        if ((accessor.componentType != Accessor::ComponentType::UnsignedByte && accessor.componentType != Accessor::ComponentType::UnsignedShort &&
+                accessor.componentType != Accessor::ComponentType::UnsignedInt) ||
+            accessor.normalized)
+        {
+            throw invalid_gltf_document("Invalid accessor.componentType value : not convertible to uint32");
+        }
+
+        detail::ConvertAccessor(document, accessor, output);
+    }
+
+    // A typed, read-only, view over the elements of an accessor. Handles bufferView.byteStride, byteOffset and
+    // matrix column padding. When TElement is a known component type (or std::array of one) the view also
+    // converts on read: integer data may be read as float (honoring accessor.normalized) or widened to an integer
+    // type holding every value, e.g. UnsignedShort indices read as uint32_t or UnsignedByte read as int16_t. Other
+    // element types are read as-is and only need to match the element size.
+    //
+    // Sparse substitution is not applied (see SparseAccessorView); accessors without a bufferView read as zeros.
+    template <typename TElement>
+    class AccessorView
+    {
+        static_assert(std::is_trivially_copyable<TElement>::value, "AccessorView elements must be trivially copyable");
+
+        using Traits = detail::AccessorElementTraits<TElement>;
+
+    public:
+        class Iterator
+        {
+        public:
+            using iterator_category = std::random_access_iterator_tag;
+            using value_type = TElement;
+            using difference_type = std::ptrdiff_t;
+            using pointer = void;
+            using reference = TElement;
+
+            Iterator() noexcept = default;
+
+            Iterator(AccessorView const * view, std::size_t index) noexcept
+                : m_view(view), m_index(index)
+            {
+            }
+
+            TElement operator*() const
+            {
+                return (*m_view)[m_index];
+            }
+
+            TElement operator[](difference_type offset) const
+            {
+                return (*m_view)[m_index + offset];
+            }
+
+            Iterator & operator++() noexcept
+            {
+                ++m_index;
+                return *this;
+            }
+
+            Iterator operator++(int) noexcept
+            {
+                Iterator result = *this;
+                ++m_index;
+                return result;
+            }
+
+            Iterator & operator--() noexcept
+            {
+                --m_index;
+                return *this;
+            }
+
+            Iterator operator--(int) noexcept
+            {
+                Iterator result = *this;
+                --m_index;
+                return result;
+            }
+
+            Iterator & operator+=(difference_type offset) noexcept
+            {
+                m_index += offset;
+                return *this;
+            }
+
+            Iterator & operator-=(difference_type offset) noexcept
+            {
+                m_index -= offset;
+                return *this;
+            }
+
+            Iterator operator+(difference_type offset) const noexcept
+            {
+                return Iterator(m_view, m_index + offset);
+            }
+
+            Iterator operator-(difference_type offset) const noexcept
+            {
+                return Iterator(m_view, m_index - offset);
+            }
+
+            difference_type operator-(Iterator const & other) const noexcept
+            {
+                return static_cast<difference_type>(m_index) - static_cast<difference_type>(other.m_index);
+            }
+
+            bool operator==(Iterator const & other) const noexcept
+            {
+                return m_index == other.m_index;
+            }
+
+            bool operator!=(Iterator const & other) const noexcept
+            {
+                return m_index != other.m_index;
+            }
+
+            bool operator<(Iterator const & other) const noexcept
+            {
+                return m_index < other.m_index;
+            }
+
+            bool operator>(Iterator const & other) const noexcept
+            {
+                return m_index > other.m_index;
+            }
+
+            bool operator<=(Iterator const & other) const noexcept
+            {
+                return m_index <= other.m_index;
+            }
+
+            bool operator>=(Iterator const & other) const noexcept
+            {
+                return m_index >= other.m_index;
+            }
+
+        private:
+            AccessorView const * m_view{};
+            std::size_t m_index{};
+        };
+
+        AccessorView(Document const & document, Accessor const & accessor)
+            : m_count(accessor.count), m_componentType(accessor.componentType), m_type(accessor.type), m_normalized(accessor.normalized)
+        {
+            const detail::AccessorLayout layout = detail::GetAccessorLayout(document, accessor);
+
+            const bool layoutMatches = sizeof(TElement) == layout.elementSize;
+            if (Traits::Count == 0)
+            {
+                if (!layoutMatches)
+                {
+                    throw invalid_gltf_document("Invalid accessor.type value : element size does not match the view");
+                }
+            }
+            else
+            {
+                if (Traits::Count != GetComponentCount(accessor.type))
+                {
+                    throw invalid_gltf_document("Invalid accessor.type value : component count does not match the view");
+                }
+
+                m_convert = !(layoutMatches && Traits::Type == accessor.componentType);
+                if (m_convert)
+                {
+                    // Integers must keep their value: same signedness and at least as wide, or unsigned into a wider signed type
+                    using Component = typename Traits::Component;
+                    const bool floatTarget = std::is_floating_point<Component>::value;
+                    const bool signedSource = accessor.componentType == Accessor::ComponentType::Byte || accessor.componentType == Accessor::ComponentType::Short;
+                    const uint32_t sourceSize = GetComponentSize(accessor.componentType);
+                    const bool fits = signedSource == std::is_signed<Component>::value ? sizeof(Component) >= sourceSize : !signedSource && sizeof(Component) > sourceSize;
+                    const bool widening = accessor.componentType != Accessor::ComponentType::Float && !accessor.normalized && fits;
+                    if (!floatTarget && !widening)
+                    {
+                        throw invalid_gltf_document("Invalid accessor.componentType value : not convertible to the view");
+                    }
+                }
+            }
+
+            m_data = layout.data;
+            m_stride = layout.stride;
+            m_packed = layout.packed;
+        }
+
+        FX_GLTF_NODISCARD std::size_t size() const noexcept
+        {
+            return m_count;
+        }
+
+        FX_GLTF_NODISCARD bool empty() const noexcept
+        {
+            return m_count == 0;
+        }
+
+        FX_GLTF_NODISCARD std::size_t stride() const noexcept
+        {
+            return m_stride;
+        }
+
+        // True when elements are tightly packed and stored exactly as TElement; CopyTo is then a single memcpy
+        FX_GLTF_NODISCARD bool IsContiguous() const noexcept
+        {
+            return !m_convert && m_data != nullptr && m_stride == sizeof(TElement);
+        }
+
+        TElement operator[](std::size_t index) const noexcept
+        {
+            TElement element{};
+            if (m_data == nullptr)
+            {
+                return element;
+            }
+
+            uint8_t const * source = m_data + index * m_stride;
+            if (!m_convert)
+            {
+                std::memcpy(&element, source, sizeof(TElement));
+            }
+            else
+            {
+                ReadConverted(source, element);
+            }
+
+            return element;
+        }
+
+        FX_GLTF_NODISCARD Iterator begin() const noexcept
+        {
+            return Iterator(this, 0);
+        }
+
+        FX_GLTF_NODISCARD Iterator end() const noexcept
+        {
+            return Iterator(this, m_count);
+        }
+
+        // Copies all elements into `output`, which must hold at least size() elements. Packed data that needs
+        // converting goes through the same SIMD kernels as ConvertToFloat/ConvertToUInt32.
+        void CopyTo(Span<TElement> output) const
+        {
+            if (output.size() < m_count)
+            {
+                throw std::out_of_range("AccessorView::CopyTo : output too small");
+            }
+
+            if (IsContiguous())
+            {
+                std::memcpy(output.data(), m_data, m_count * sizeof(TElement));
+            }
+            else if (m_convert && m_packed)
+            {
+                // std::array elements are laid out as Traits::Count consecutive components
+                detail::ConvertComponents(m_data, m_componentType, m_normalized, reinterpret_cast<typename Traits::Component *>(output.data()), m_count * Traits::Count);
+            }
+            else
+            {
+                for (std::size_t i = 0; i < m_count; i++)
+                {
+                    output[i] = (*this)[i];
+                }
+            }
+        }
+
+    private:
+        uint8_t const * m_data{};
+        std::size_t m_count{};
+        std::size_t m_stride{};
+
+        Accessor::ComponentType m_componentType{};
+        Accessor::Type m_type{};
+        bool m_normalized{};
+        bool m_convert{};
+        bool m_packed{};
+
+        void ReadConverted(uint8_t const * source, TElement & element) const noexcept
+        {
+            using Component = typename Traits::Component;
+
+            const uint32_t componentSize = GetComponentSize(m_componentType);
+            auto * target = reinterpret_cast<uint8_t *>(&element);
+            for (uint32_t i = 0; i < Traits::Count; i++)
+            {
+                const Component value = detail::ReadComponent<Component>(source + detail::GetComponentOffset(m_type, componentSize, i), m_componentType, m_normalized);
+                std::memcpy(target + i * sizeof(Component), &value, sizeof(Component));
+            }
+        }
+    };
+
+    namespace detail
+    {
+        // Describes accessor.sparse.indices and accessor.sparse.values as accessors of sparse.count elements
+        inline void GetSparseAccessors(Accessor const & accessor, Accessor & indices, Accessor & values)
+        {
+            if (accessor.sparse.count < 0 || static_cast<uint32_t>(accessor.sparse.count) > accessor.count)
+            {
+                throw invalid_gltf_document("Invalid accessor.sparse.count value");
+            }
+
+            indices = {};
+            indices.bufferView = static_cast<int32_t>(accessor.sparse.indices.bufferView);
+            indices.byteOffset = accessor.sparse.indices.byteOffset;
+            indices.count = static_cast<uint32_t>(accessor.sparse.count);
+            indices.componentType = accessor.sparse.indices.componentType;
+            indices.type = Accessor::Type::Scalar;
+            if (indices.componentType != Accessor::ComponentType::UnsignedByte &&
+                indices.componentType != Accessor::ComponentType::UnsignedShort &&
+                indices.componentType != Accessor::ComponentType::UnsignedInt)
+            {
+                throw invalid_gltf_document("Invalid accessor.sparse.indices.componentType value");
+            }
+
+            values = accessor;
+            values.bufferView = static_cast<int32_t>(accessor.sparse.values.bufferView);
+            values.byteOffset = accessor.sparse.values.byteOffset;
+            values.count = static_cast<uint32_t>(accessor.sparse.count);
+            values.sparse = {};
+        }
+    } // namespace detail
+
+    // An AccessorView with accessor.sparse applied. Only the sparse indices and values are read up front, so the
+    // cost of construction depends on sparse.count rather than on accessor.count; overridden elements are found
+    // with a binary search. Use CopyTo to materialize every element in one pass.
+    template <typename TElement>
+    class SparseAccessorView
+    {
+    public:
+        SparseAccessorView(Document const & document, Accessor const & accessor)
+            : m_base(document, accessor)
+        {
+            if (accessor.sparse.empty())
+            {
+                return;
+            }
+
+            Accessor indices{};
+            Accessor values{};
+            detail::GetSparseAccessors(accessor, indices, values);
+
+            const std::size_t sparseCount = static_cast<std::size_t>(accessor.sparse.count);
+
+            m_indices.resize(sparseCount);
+            ConvertToUInt32(document, indices, { m_indices.data(), m_indices.size() });
+
+            m_values.resize(sparseCount);
+            AccessorView<TElement>(document, values).CopyTo({ m_values.data(), m_values.size() });
+
+            // The specification requires strictly increasing indices; tolerate unordered ones by sorting, which also
+            // keeps the scatter in CopyTo moving forward through memory
+            if (!std::is_sorted(m_indices.begin(), m_indices.end()))
+            {
+                std::vector<std::size_t> order(sparseCount);
+                for (std::size_t i = 0; i < sparseCount; i++)
+                {
+                    order[i] = i;
+                }
+
+                std::sort(order.begin(), order.end(), [this](std::size_t a, std::size_t b) { return m_indices[a] < m_indices[b]; });
+
+                std::vector<uint32_t> sortedIndices(sparseCount);
+                std::vector<TElement> sortedValues(sparseCount);
+                for (std::size_t i = 0; i < sparseCount; i++)
+                {
+                    sortedIndices[i] = m_indices[order[i]];
+                    sortedValues[i] = m_values[order[i]];
+                }
+
+                m_indices.swap(sortedIndices);
+                m_values.swap(sortedValues);
+            }
+
+            for (std::size_t i = 0; i < sparseCount; i++)
+            {
+                if (m_indices[i] >= accessor.count || (i > 0 && m_indices[i] == m_indices[i - 1]))
+                {
+                    throw invalid_gltf_document("Invalid accessor.sparse.indices value");
+                }
+            }
+        }
+
+        FX_GLTF_NODISCARD std::size_t size() const noexcept
+        {
+            return m_base.size();
+        }
+
+        FX_GLTF_NODISCARD bool empty() const noexcept
+        {
+            return m_base.empty();
+        }
+
+        // The overridden element indices, in increasing order, and their values
+        FX_GLTF_NODISCARD Span<uint32_t const> indices() const noexcept
+        {
+            return { m_indices.data(), m_indices.size() };
+        }
+
+        FX_GLTF_NODISCARD Span<TElement const> values() const noexcept
+        {
+            return { m_values.data(), m_values.size() };
+        }
+
+        FX_GLTF_NODISCARD AccessorView<TElement> const & base() const noexcept
+        {
+            return m_base;
+        }
+
+        TElement operator[](std::size_t index) const noexcept
+        {
+            const auto it = std::lower_bound(m_indices.begin(), m_indices.end(), index, [](uint32_t a, std::size_t b) { return a < b; });
+            if (it != m_indices.end() && *it == index)
+            {
+                return m_values[static_cast<std::size_t>(it - m_indices.begin())];
+            }
+
+            return m_base[index];
+        }
+
+        // Copies all elements into `output`, which must hold at least size() elements: the dense base data first,
+        // then the sparse values scattered on top
+        void CopyTo(Span<TElement> output) const
+        {
+            m_base.CopyTo(output);
+            for (std::size_t i = 0; i < m_indices.size(); i++)
+            {
+                output[m_indices[i]] = m_values[i];
+            }
+        }
+
+    private:
+        AccessorView<TElement> m_base;
+        std::vector<uint32_t> m_indices{};
+        std::vector<TElement> m_values{};
+    };
+
+    // Writes every element of the accessor, with sparse substitution applied, into `output`
+    template <typename TElement>
+    inline void MaterializeAccessor(Document const & document, Accessor const & accessor, Span<TElement> output)
+    {
+        SparseAccessorView<TElement>(document, accessor).CopyTo(output);
+    }
+
+    namespace detail
+    {
+        inline void ReadEnum(std::string const & type, Accessor::Type & accessorType)
+        {
+            if (type == "SCALAR")
+            {
+                accessorType = Accessor::Type::Scalar;
+            }
+            else if (type == "VEC2")
+            {
+                accessorType = Accessor::Type::Vec2;
+            }
+            else if (type == "VEC3")
+            {
+                accessorType = Accessor::Type::Vec3;
+            }
+            else if (type == "VEC4")
+            {
+                accessorType = Accessor::Type::Vec4;
+            }
+            else if (type == "MAT2")
+            {
+                accessorType = Accessor::Type::Mat2;
+            }
+            else if (type == "MAT3")
+            {
+                accessorType = Accessor::Type::Mat3;
+            }
+            else if (type == "MAT4")
+            {
+                accessorType = Accessor::Type::Mat4;
+            }
+            else
+            {
+                throw invalid_gltf_document("Unknown accessor.type value", type);
+            }
+        }
+    } // namespace detail
+
+    inline void from_json(nlohmann::json const & json, Accessor::Type & accessorType)
+    {
+        detail::ReadEnum(json.get<std::string>(), accessorType);
+    }
+
+    inline void from_json(nlohmann::json const & json, Accessor::Sparse::Values & values)
+    {
+        detail::ReadRequiredField("bufferView", json, values.bufferView);
+
+        detail::ReadOptionalField("byteOffset", json, values.byteOffset);
+
+        detail::ReadExtensionsAndExtras(json, values.extensionsAndExtras);
+    }
+
+    inline void from_json(nlohmann::json const & json, Accessor::Sparse::Indices & indices)
+    {
+        detail::ReadRequiredField("bufferView", json, indices.bufferView);
+        detail::ReadRequiredField("componentType", json, indices.componentType);
+
+        detail::ReadOptionalField("byteOffset", json, indices.byteOffset);
+
+        detail::ReadExtensionsAndExtras(json, indices.extensionsAndExtras);
+    }
+
+    inline void from_json(nlohmann::json const & json, Accessor::Sparse & sparse)
+    {
+        detail::ReadRequiredField("count", json, sparse.count);
+        detail::ReadRequiredField("indices", json, sparse.indices);
+        detail::ReadRequiredField("values", json, sparse.values);
+
+        detail::ReadExtensionsAndExtras(json, sparse.extensionsAndExtras);
+    }
+
+    inline void from_json(nlohmann::json const & json, Accessor & accessor)
+    {
+        detail::ReadRequiredField("componentType", json, accessor.componentType);
+        detail::ReadRequiredField("count", json, accessor.count);
+        detail::ReadRequiredField("type", json, accessor.type);
+
+        detail::ReadOptionalField("bufferView", json, accessor.bufferView);
+        detail::ReadOptionalField("byteOffset", json, accessor.byteOffset);
+        detail::ReadOptionalField("max", json, accessor.max);
+        detail::ReadOptionalField("min", json, accessor.min);
+        detail::ReadOptionalField("name", json, accessor.name);
+        detail::ReadOptionalField("normalized", json, accessor.normalized);
+        detail::ReadOptionalField("sparse", json, accessor.sparse);
+
+        detail::ReadExtensionsAndExtras(json, accessor.extensionsAndExtras);
+    }
+
+    inline void from_json(nlohmann::json const & json, Animation::Channel::Target & animationChannelTarget)
+    {
+        detail::ReadRequiredField("path", json, animationChannelTarget.path);
+
+        detail::ReadOptionalField("node", json, animationChannelTarget.node);
+
+        detail::ReadExtensionsAndExtras(json, animationChannelTarget.extensionsAndExtras);
+    }
+
+    inline void from_json(nlohmann::json const & json, Animation::Channel & animationChannel)
+    {
+        detail::ReadRequiredField("sampler", json, animationChannel.sampler);
+        detail::ReadRequiredField("target", json, animationChannel.target);
+
+        detail::ReadExtensionsAndExtras(json, animationChannel.extensionsAndExtras);
+    }
+
+    namespace detail
+    {
+        inline void ReadEnum(std::string const & type, Animation::Sampler::Type & animationSamplerType)
+        {
+            if (type == "LINEAR")
+            {
+                animationSamplerType = Animation::Sampler::Type::Linear;
+            }
+            else if (type == "STEP")
+            {
+                animationSamplerType = Animation::Sampler::Type::Step;
+            }
+            else if (type == "CUBICSPLINE")
+            {
+                animationSamplerType = Animation::Sampler::Type::CubicSpline;
+            }
+            else
+            {
+                throw invalid_gltf_document("Unknown animation.sampler.interpolation value", type);
+            }
+        }
+    } // namespace detail
+
+    inline void from_json(nlohmann::json const & json, Animation::Sampler::Type & animationSamplerType)
+    {
+        detail::ReadEnum(json.get<std::string>(), animationSamplerType);
+    }
+
+    inline void from_json(nlohmann::json const & json, Animation::Sampler & animationSampler)
+    {
+        detail::ReadRequiredField("input", json, animationSampler.input);
+        detail::ReadRequiredField("output", json, animationSampler.output);
+
+        detail::ReadOptionalField("interpolation", json, animationSampler.interpolation);
+
+        detail::ReadExtensionsAndExtras(json, animationSampler.extensionsAndExtras);
+    }
+
+    inline void from_json(nlohmann::json const & json, Animation & animation)
+    {
+        detail::ReadRequiredField("channels", json, animation.channels);
+        detail::ReadRequiredField("samplers", json, animation.samplers);
+
+        detail::ReadOptionalField("name", json, animation.name);
+
+        detail::ReadExtensionsAndExtras(json, animation.extensionsAndExtras);
+    }
+
+    inline void from_json(nlohmann::json const & json, Asset & asset)
+    {
+        detail::ReadRequiredField("version", json, asset.version);
+        detail::ReadOptionalField("copyright", json, asset.copyright);
+        detail::ReadOptionalField("generator", json, asset.generator);
+        detail::ReadOptionalField("minVersion", json, asset.minVersion);
+
+        detail::ReadExtensionsAndExtras(json, asset.extensionsAndExtras);
+    }
+
+    inline void from_json(nlohmann::json const & json, Buffer & buffer)
+    {
+        detail::ReadRequiredField("byteLength", json, buffer.byteLength);
+
+        detail::ReadOptionalField("name", json, buffer.name);
+        detail::ReadOptionalField("uri", json, buffer.uri);
+
+        detail::ReadExtensionsAndExtras(json, buffer.extensionsAndExtras);
+    }
+
+    inline void from_json(nlohmann::json const & json, BufferView & bufferView)
+    {
+        detail::ReadRequiredField("buffer", json, bufferView.buffer);
+        detail::ReadRequiredField("byteLength", json, bufferView.byteLength);
+
+        detail::ReadOptionalField("byteOffset", json, bufferView.byteOffset);
+        detail::ReadOptionalField("byteStride", json, bufferView.byteStride);
+        detail::ReadOptionalField("name", json, bufferView.name);
+        detail::ReadOptionalField("target", json, bufferView.target);
+
+        detail::ReadExtensionsAndExtras(json, bufferView.extensionsAndExtras);
+    }
+
+    namespace detail
+    {
+        inline void ReadEnum(std::string const & type, Camera::Type & cameraType)
+        {
+            if (type == "orthographic")
+            {
+                cameraType = Camera::Type::Orthographic;
+            }
+            else if (type == "perspective")
+            {
+                cameraType = Camera::Type::Perspective;
+            }
+            else
+            {
+                throw invalid_gltf_document("Unknown camera.type value", type);
+            }
+        }
+    } // namespace detail
+
+    inline void from_json(nlohmann::json const & json, Camera::Type & cameraType)
+    {
+        detail::ReadEnum(json.get<std::string>(), cameraType);
+    }
+
+    inline void from_json(nlohmann::json const & json, Camera::Orthographic & camera)
+    {
+        detail::ReadRequiredField("xmag", json, camera.xmag);
+        detail::ReadRequiredField("ymag", json, camera.ymag);
+        detail::ReadRequiredField("zfar", json, camera.zfar);
+        detail::ReadRequiredField("znear", json, camera.znear);
+
+        detail::ReadExtensionsAndExtras(json, camera.extensionsAndExtras);
+    }
+
+    inline void from_json(nlohmann::json const & json, Camera::Perspective & camera)
+    {
+        detail::ReadRequiredField("yfov", json, camera.yfov);
+        detail::ReadRequiredField("znear", json, camera.znear);
 
         detail::ReadOptionalField("aspectRatio", json, camera.aspectRatio);
         detail::ReadOptionalField("zfar", json, camera.zfar);
 
-        detail::ReadExtensionsAndExtras(json, camera.extensionsAndExtras);
+        detail::ReadExtensionsAndExtras(json, camera.extensionsAndExtras);
+    }
+
+    inline void from_json(nlohmann::json const & json, Camera & camera)
+    {
+        detail::ReadRequiredField("type", json, camera.type);
+
+        detail::ReadOptionalField("name", json, camera.name);
+
+        detail::ReadExtensionsAndExtras(json, camera.extensionsAndExtras);
+
+        if (camera.type == Camera::Type::Perspective)
+        {
+            detail::ReadRequiredField("perspective", json, camera.perspective);
+        }
+        else if (camera.type == Camera::Type::Orthographic)
+        {
+            detail::ReadRequiredField("orthographic", json, camera.orthographic);
+        }
+    }
+
+    inline void from_json(nlohmann::json const & json, Image & image)
+    {
+        detail::ReadOptionalField("bufferView", json, image.bufferView);
+        detail::ReadOptionalField("mimeType", json, image.mimeType);
+        detail::ReadOptionalField("name", json, image.name);
+        detail::ReadOptionalField("uri", json, image.uri);
+
+        detail::ReadExtensionsAndExtras(json, image.extensionsAndExtras);
+    }
+
+    namespace detail
+    {
+        inline void ReadEnum(std::string const & alphaMode, Material::AlphaMode & materialAlphaMode)
+        {
+            if (alphaMode == "OPAQUE")
+            {
+                materialAlphaMode = Material::AlphaMode::Opaque;
+            }
+            else if (alphaMode == "MASK")
+            {
+                materialAlphaMode = Material::AlphaMode::Mask;
+            }
+            else if (alphaMode == "BLEND")
+            {
+                materialAlphaMode = Material::AlphaMode::Blend;
+            }
+            else
+            {
+                throw invalid_gltf_document("Unknown material.alphaMode value", alphaMode);
+            }
+        }
+    } // namespace detail
+
+    inline void from_json(nlohmann::json const & json, Material::AlphaMode & materialAlphaMode)
+    {
+        detail::ReadEnum(json.get<std::string>(), materialAlphaMode);
+    }
+
+    inline void from_json(nlohmann::json const & json, Material::Texture & materialTexture)
+    {
+        detail::ReadRequiredField("index", json, materialTexture.index);
+        detail::ReadOptionalField("texCoord", json, materialTexture.texCoord);
+
+        detail::ReadExtensionsAndExtras(json, materialTexture.extensionsAndExtras);
+    }
+
+    inline void from_json(nlohmann::json const & json, Material::NormalTexture & materialTexture)
+    {
+        from_json(json, static_cast<Material::Texture &>(materialTexture));
+        detail::ReadOptionalField("scale", json, materialTexture.scale);
+
+        detail::ReadExtensionsAndExtras(json, materialTexture.extensionsAndExtras);
+    }
+
+    inline void from_json(nlohmann::json const & json, Material::OcclusionTexture & materialTexture)
+    {
+        from_json(json, static_cast<Material::Texture &>(materialTexture));
+        detail::ReadOptionalField("strength", json, materialTexture.strength);
+
+        detail::ReadExtensionsAndExtras(json, materialTexture.extensionsAndExtras);
+    }
+
+    inline void from_json(nlohmann::json const & json, Material::PBRMetallicRoughness & pbrMetallicRoughness)
+    {
+        detail::ReadOptionalField("baseColorFactor", json, pbrMetallicRoughness.baseColorFactor);
+        detail::ReadOptionalField("baseColorTexture", json, pbrMetallicRoughness.baseColorTexture);
+        detail::ReadOptionalField("metallicFactor", json, pbrMetallicRoughness.metallicFactor);
+        detail::ReadOptionalField("metallicRoughnessTexture", json, pbrMetallicRoughness.metallicRoughnessTexture);
+        detail::ReadOptionalField("roughnessFactor", json, pbrMetallicRoughness.roughnessFactor);
+
+        detail::ReadExtensionsAndExtras(json, pbrMetallicRoughness.extensionsAndExtras);
+    }
+
+    inline void from_json(nlohmann::json const & json, Material & material)
+    {
+        detail::ReadOptionalField("alphaMode", json, material.alphaMode);
+        detail::ReadOptionalField("alphaCutoff", json, material.alphaCutoff);
+        detail::ReadOptionalField("doubleSided", json, material.doubleSided);
+        detail::ReadOptionalField("emissiveFactor", json, material.emissiveFactor);
+        detail::ReadOptionalField("emissiveTexture", json, material.emissiveTexture);
+        detail::ReadOptionalField("name", json, material.name);
+        detail::ReadOptionalField("normalTexture", json, material.normalTexture);
+        detail::ReadOptionalField("occlusionTexture", json, material.occlusionTexture);
+        detail::ReadOptionalField("pbrMetallicRoughness", json, material.pbrMetallicRoughness);
+
+        detail::ReadExtensionsAndExtras(json, material.extensionsAndExtras);
+    }
+
+    inline void from_json(nlohmann::json const & json, Mesh & mesh)
+    {
+        detail::ReadRequiredField("primitives", json, mesh.primitives);
+
+        detail::ReadOptionalField("name", json, mesh.name);
+        detail::ReadOptionalField("weights", json, mesh.weights);
+
+        detail::ReadExtensionsAndExtras(json, mesh.extensionsAndExtras);
+    }
+
+    inline void from_json(nlohmann::json const & json, Node & node)
+    {
+        detail::ReadOptionalField("camera", json, node.camera);
+        detail::ReadOptionalField("children", json, node.children);
+        detail::ReadOptionalField("matrix", json, node.matrix);
+        detail::ReadOptionalField("mesh", json, node.mesh);
+        detail::ReadOptionalField("name", json, node.name);
+        detail::ReadOptionalField("rotation", json, node.rotation);
+        detail::ReadOptionalField("scale", json, node.scale);
+        detail::ReadOptionalField("skin", json, node.skin);
+        detail::ReadOptionalField("translation", json, node.translation);
+
+        detail::ReadExtensionsAndExtras(json, node.extensionsAndExtras);
+    }
+
+    inline void from_json(nlohmann::json const & json, Primitive & primitive)
+    {
+        detail::ReadRequiredField("attributes", json, primitive.attributes);
+
+        detail::ReadOptionalField("indices", json, primitive.indices);
+        detail::ReadOptionalField("material", json, primitive.material);
+        detail::ReadOptionalField("mode", json, primitive.mode);
+        detail::ReadOptionalField("targets", json, primitive.targets);
+
+        detail::ReadExtensionsAndExtras(json, primitive.extensionsAndExtras);
+    }
+
+    inline void from_json(nlohmann::json const & json, Sampler & sampler)
+    {
+        detail::ReadOptionalField("magFilter", json, sampler.magFilter);
+        detail::ReadOptionalField("minFilter", json, sampler.minFilter);
+        detail::ReadOptionalField("name", json, sampler.name);
+        detail::ReadOptionalField("wrapS", json, sampler.wrapS);
+        detail::ReadOptionalField("wrapT", json, sampler.wrapT);
+
+        detail::ReadExtensionsAndExtras(json, sampler.extensionsAndExtras);
+    }
+
+    inline void from_json(nlohmann::json const & json, Scene & scene)
+    {
+        detail::ReadOptionalField("name", json, scene.name);
+        detail::ReadOptionalField("nodes", json, scene.nodes);
+
+        detail::ReadExtensionsAndExtras(json, scene.extensionsAndExtras);
+    }
+
+    inline void from_json(nlohmann::json const & json, Skin & skin)
+    {
+        detail::ReadRequiredField("joints", json, skin.joints);
+
+        detail::ReadOptionalField("inverseBindMatrices", json, skin.inverseBindMatrices);
+        detail::ReadOptionalField("name", json, skin.name);
+        detail::ReadOptionalField("skeleton", json, skin.skeleton);
+
+        detail::ReadExtensionsAndExtras(json, skin.extensionsAndExtras);
+    }
+
+    inline void from_json(nlohmann::json const & json, Texture & texture)
+    {
+        detail::ReadOptionalField("name", json, texture.name);
+        detail::ReadOptionalField("sampler", json, texture.sampler);
+        detail::ReadOptionalField("source", json, texture.source);
+
+        detail::ReadExtensionsAndExtras(json, texture.extensionsAndExtras);
+    }
+
+    inline void from_json(nlohmann::json const & json, Document & document)
+    {
+        detail::ReadRequiredField("asset", json, document.asset);
+
+        detail::ReadOptionalField("accessors", json, document.accessors);
+        detail::ReadOptionalField("animations", json, document.animations);
+        detail::ReadOptionalField("buffers", json, document.buffers);
+        detail::ReadOptionalField("bufferViews", json, document.bufferViews);
+        detail::ReadOptionalField("cameras", json, document.cameras);
+        detail::ReadOptionalField("materials", json, document.materials);
+        detail::ReadOptionalField("meshes", json, document.meshes);
+        detail::ReadOptionalField("nodes", json, document.nodes);
+        detail::ReadOptionalField("images", json, document.images);
+        detail::ReadOptionalField("samplers", json, document.samplers);
+        detail::ReadOptionalField("scene", json, document.scene);
+        detail::ReadOptionalField("scenes", json, document.scenes);
+        detail::ReadOptionalField("skins", json, document.skins);
+        detail::ReadOptionalField("textures", json, document.textures);
+
+        detail::ReadOptionalField("extensionsUsed", json, document.extensionsUsed);
+        detail::ReadOptionalField("extensionsRequired", json, document.extensionsRequired);
+        detail::ReadExtensionsAndExtras(json, document.extensionsAndExtras);
+    }
+
+    namespace detail
+    {
+        class SaxDocumentReader;
+
+        // Matches a json key against the fields of one glTF object. The ReadFields overloads below list the same
+        // fields as their from_json counterparts. Once an object is complete they run a second time, in check mode,
+        // to report any required field which was never seen
+        class SaxFieldReader
+        {
+        public:
+            SaxFieldReader(SaxDocumentReader & reader, std::string const & key, uint32_t & found) noexcept
+                : m_reader(&reader), m_key(&key), m_found(&found)
+            {
+            }
+
+            explicit SaxFieldReader(uint32_t & found) noexcept
+                : m_found(&found)
+            {
+            }
+
+            template <typename TValue>
+            void Required(char const * name, TValue & target)
+            {
+                RequiredIf(true, name, target);
+            }
+
+            template <typename TValue>
+            void RequiredIf(bool condition, char const * name, TValue & target)
+            {
+                const uint32_t bit = 1u << m_requiredCount++;
+                if (m_reader == nullptr)
+                {
+                    if (condition && (*m_found & bit) == 0)
+                    {
+                        throw invalid_gltf_document("Required field not found", name);
+                    }
+                }
+                else if (Match(name, target))
+                {
+                    *m_found |= bit;
+                }
+            }
+
+            template <typename TValue>
+            void Optional(char const * name, TValue & target)
+            {
+                if (m_reader != nullptr)
+                {
+                    Match(name, target);
+                }
+            }
+
+            void ExtensionsAndExtras(nlohmann::json & extensionsAndExtras)
+            {
+                if (m_reader != nullptr && !m_matched && (*m_key == "extensions" || *m_key == "extras"))
+                {
+                    Match(m_key->c_str(), extensionsAndExtras[*m_key]);
+                }
+            }
+
+            // Every key is a field, as in Primitive::attributes
+            template <typename TValue>
+            void Any(std::unordered_map<std::string, TValue> & values)
+            {
+                if (m_reader != nullptr)
+                {
+                    Match(m_key->c_str(), values[*m_key]);
+                }
+            }
+
+        private:
+            SaxDocumentReader * m_reader{};
+            std::string const * m_key{};
+            uint32_t * m_found{};
+
+            uint32_t m_requiredCount{};
+            bool m_matched{};
+
+            template <typename TValue>
+            bool Match(char const * name, TValue & target);
+        };
+
+        // How each kind of json value is stored into a C++ type; see SaxValueTraits
+        struct SaxValueReader
+        {
+            void (*integer)(SaxDocumentReader & reader, void * target, int64_t value);
+            void (*unsignedInteger)(SaxDocumentReader & reader, void * target, uint64_t value);
+            void (*floatingPoint)(SaxDocumentReader & reader, void * target, double value);
+            void (*boolean)(SaxDocumentReader & reader, void * target, bool value);
+            void (*string)(SaxDocumentReader & reader, void * target, std::string & value);
+            void (*startObject)(SaxDocumentReader & reader, void * target);
+            void (*startArray)(SaxDocumentReader & reader, void * target);
+        };
+
+        template <typename TValue>
+        SaxValueReader const * GetSaxValueReader() noexcept;
+
+        // Where the next json value goes. An empty slot skips the value, e.g. for unknown keys
+        struct SaxSlot
+        {
+            SaxValueReader const * reader{};
+            void * target{};
+        };
+
+        // Fills a Document straight from nlohmann::json::sax_parse events. Only extensions and extras, which have no
+        // fixed schema, are captured as nlohmann::json subtrees
+        class SaxDocumentReader
+        {
+        public:
+            explicit SaxDocumentReader(Document & document)
+                : m_slot{ GetSaxValueReader<Document>(), &document }
+            {
+                m_frames.reserve(16);
+            }
+
+            bool null()
+            {
+                if (!Capture(nullptr))
+                {
+                    SaxSlot slot = NextSlot();
+                    if (slot.target != nullptr)
+                    {
+                        RejectValue();
+                    }
+                }
+
+                return true;
+            }
+
+            bool boolean(bool value)
+            {
+                if (!Capture(value))
+                {
+                    SaxSlot slot = NextSlot();
+                    if (slot.target != nullptr)
+                    {
+                        slot.reader->boolean(*this, slot.target, value);
+                    }
+                }
+
+                return true;
+            }
+
+            bool number_integer(nlohmann::json::number_integer_t value)
+            {
+                if (!Capture(value))
+                {
+                    SaxSlot slot = NextSlot();
+                    if (slot.target != nullptr)
+                    {
+                        slot.reader->integer(*this, slot.target, value);
+                    }
+                }
+
+                return true;
+            }
+
+            bool number_unsigned(nlohmann::json::number_unsigned_t value)
+            {
+                if (!Capture(value))
+                {
+                    SaxSlot slot = NextSlot();
+                    if (slot.target != nullptr)
+                    {
+                        slot.reader->unsignedInteger(*this, slot.target, value);
+                    }
+                }
+
+                return true;
+            }
+
+            bool number_float(nlohmann::json::number_float_t value, nlohmann::json::string_t const &)
+            {
+                if (!Capture(value))
+                {
+                    SaxSlot slot = NextSlot();
+                    if (slot.target != nullptr)
+                    {
+                        slot.reader->floatingPoint(*this, slot.target, value);
+                    }
+                }
+
+                return true;
+            }
+
+            bool string(nlohmann::json::string_t & value)
+            {
+                if (!Capture(value))
+                {
+                    SaxSlot slot = NextSlot();
+                    if (slot.target != nullptr)
+                    {
+                        slot.reader->string(*this, slot.target, value);
+                    }
+                }
+
+                return true;
+            }
+
+            bool binary(nlohmann::json::binary_t &)
+            {
+                // Only produced by the binary formats (CBOR etc.), never by json text
+                RejectValue();
+                return false;
+            }
+
+            bool start_object(std::size_t)
+            {
+                if (m_skipDepth != 0)
+                {
+                    m_skipDepth++;
+                }
+                else if (!m_captures.empty())
+                {
+                    m_captures.push_back(AddCaptured(nlohmann::json::object()));
+                }
+                else
+                {
+                    SaxSlot slot = NextSlot();
+                    if (slot.target != nullptr)
+                    {
+                        slot.reader->startObject(*this, slot.target);
+                    }
+                    else
+                    {
+                        m_skipDepth = 1;
+                    }
+                }
+
+                return true;
+            }
+
+            bool key(nlohmann::json::string_t & key)
+            {
+                if (m_skipDepth != 0)
+                {
+                    return true;
+                }
+
+                if (!m_captures.empty())
+                {
+                    m_captureKey.assign(key);
+                    return true;
+                }
+
+                m_key.assign(key);
+                m_slot = {};
+
+                Frame & frame = m_frames.back();
+                SaxFieldReader fields(*this, m_key, frame.found);
+                frame.readFields(fields, frame.target);
+                return true;
+            }
+
+            bool end_object()
+            {
+                if (m_skipDepth != 0)
+                {
+                    m_skipDepth--;
+                }
+                else if (!m_captures.empty())
+                {
+                    m_captures.pop_back();
+                }
+                else
+                {
+                    Frame & frame = m_frames.back();
+                    SaxFieldReader fields(frame.found);
+                    frame.readFields(fields, frame.target);
+                    m_frames.pop_back();
+                }
+
+                return true;
+            }
+
+            bool start_array(std::size_t)
+            {
+                if (m_skipDepth != 0)
+                {
+                    m_skipDepth++;
+                }
+                else if (!m_captures.empty())
+                {
+                    m_captures.push_back(AddCaptured(nlohmann::json::array()));
+                }
+                else
+                {
+                    SaxSlot slot = NextSlot();
+                    if (slot.target != nullptr)
+                    {
+                        slot.reader->startArray(*this, slot.target);
+                    }
+                    else
+                    {
+                        m_skipDepth = 1;
+                    }
+                }
+
+                return true;
+            }
+
+            bool end_array()
+            {
+                if (m_skipDepth != 0)
+                {
+                    m_skipDepth--;
+                }
+                else if (!m_captures.empty())
+                {
+                    m_captures.pop_back();
+                }
+                else
+                {
+                    if (m_frames.back().count < m_frames.back().minCount)
+                    {
+                        throw invalid_gltf_document("Invalid array length", m_key);
+                    }
+
+                    m_frames.pop_back();
+                }
+
+                return true;
+            }
+
+            bool parse_error(std::size_t, std::string const &, nlohmann::json::exception const & ex)
+            {
+                // Rethrow as the concrete exception type, as nlohmann::json's own dom parser does
+                switch ((ex.id / 100) % 100)
+                {
+                case 1:
+                    throw *static_cast<nlohmann::json::parse_error const *>(&ex);
+                case 2:
+                    throw *static_cast<nlohmann::json::invalid_iterator const *>(&ex);
+                case 3:
+                    throw *static_cast<nlohmann::json::type_error const *>(&ex);
+                case 4:
+                    throw *static_cast<nlohmann::json::out_of_range const *>(&ex);
+                default:
+                    throw *static_cast<nlohmann::json::other_error const *>(&ex);
+                }
+            }
+
+            void SetSlot(SaxSlot slot) noexcept
+            {
+                m_slot = slot;
+            }
+
+            template <typename TValue>
+            void PushObject(TValue & target)
+            {
+                m_frames.push_back({ &target, &ReadFieldsOf<TValue>, nullptr, nullptr, 0, 0, 0 });
+            }
+
+            template <typename TValue>
+            void PushArray(std::vector<TValue> & target)
+            {
+                target.clear();
+                m_frames.push_back({ &target, nullptr, &AddElement<TValue>, GetSaxValueReader<TValue>(), 0, 0, 0 });
+            }
+
+            template <typename TValue, std::size_t N>
+            void PushArray(std::array<TValue, N> & target)
+            {
+                m_frames.push_back({ &target, nullptr, &AddElement<TValue, N>, GetSaxValueReader<TValue>(), 0, N, 0 });
+            }
+
+            void PushCapture(nlohmann::json & target)
+            {
+                m_captures.push_back(&target);
+            }
+
+            [[noreturn]] void RejectValue() const
+            {
+                throw invalid_gltf_document("Invalid value type", m_key);
+            }
+
+        private:
+            struct Frame
+            {
+                void * target;
+
+                // Objects
+                void (*readFields)(SaxFieldReader & fields, void * target);
+
+                // Arrays; a null element is skipped
+                void * (*addElement)(void * target, std::size_t index);
+                SaxValueReader const * elementReader;
+                std::size_t count;
+                std::size_t minCount;
+
+                uint32_t found;
+            };
+
+            std::vector<Frame> m_frames{};
+            SaxSlot m_slot{};
+            std::string m_key{};
+
+            std::vector<nlohmann::json *> m_captures{};
+            std::string m_captureKey{};
+            std::size_t m_skipDepth{};
+
+            template <typename TValue>
+            static void ReadFieldsOf(SaxFieldReader & fields, void * target)
+            {
+                ReadFields(fields, *static_cast<TValue *>(target));
+            }
+
+            template <typename TValue>
+            static void * AddElement(void * target, std::size_t)
+            {
+                std::vector<TValue> & values = *static_cast<std::vector<TValue> *>(target);
+                values.emplace_back();
+                return &values.back();
+            }
+
+            template <typename TValue, std::size_t N>
+            static void * AddElement(void * target, std::size_t index)
+            {
+                return index < N ? &(*static_cast<std::array<TValue, N> *>(target))[index] : nullptr;
+            }
+
+            SaxSlot NextSlot()
+            {
+                if (!m_frames.empty() && m_frames.back().addElement != nullptr)
+                {
+                    Frame & frame = m_frames.back();
+                    void * element = frame.addElement(frame.target, frame.count++);
+                    return element != nullptr ? SaxSlot{ frame.elementReader, element } : SaxSlot{};
+                }
+
+                const SaxSlot slot = m_slot;
+                m_slot = {};
+                return slot;
+            }
+
+            // Returns true if the value was consumed by a skipped or captured subtree
+            template <typename TValue>
+            bool Capture(TValue && value)
+            {
+                if (m_skipDepth != 0)
+                {
+                    return true;
+                }
+
+                if (m_captures.empty())
+                {
+                    return false;
+                }
+
+                AddCaptured(std::forward<TValue>(value));
+                return true;
+            }
+
+            template <typename TValue>
+            nlohmann::json * AddCaptured(TValue && value)
+            {
+                nlohmann::json & parent = *m_captures.back();
+                if (parent.is_object())
+                {
+                    nlohmann::json & child = parent[m_captureKey];
+                    child = std::forward<TValue>(value);
+                    return &child;
+                }
+
+                parent.push_back(std::forward<TValue>(value));
+                return &parent.back();
+            }
+        };
+
+        template <typename TValue>
+        inline bool SaxFieldReader::Match(char const * name, TValue & target)
+        {
+            if (m_matched || *m_key != name)
+            {
+                return false;
+            }
+
+            m_reader->SetSlot({ GetSaxValueReader<TValue>(), &target });
+            m_matched = true;
+            return true;
+        }
+
+        // Value handlers which reject everything; the traits below override the ones they accept
+        struct SaxRejectValue
+        {
+            static void Integer(SaxDocumentReader & reader, void *, int64_t)
+            {
+                reader.RejectValue();
+            }
+
+            static void UnsignedInteger(SaxDocumentReader & reader, void *, uint64_t)
+            {
+                reader.RejectValue();
+            }
+
+            static void FloatingPoint(SaxDocumentReader & reader, void *, double)
+            {
+                reader.RejectValue();
+            }
+
+            static void Boolean(SaxDocumentReader & reader, void *, bool)
+            {
+                reader.RejectValue();
+            }
+
+            static void String(SaxDocumentReader & reader, void *, std::string &)
+            {
+                reader.RejectValue();
+            }
+
+            static void StartObject(SaxDocumentReader & reader, void *)
+            {
+                reader.RejectValue();
+            }
+
+            static void StartArray(SaxDocumentReader & reader, void *)
+            {
+                reader.RejectValue();
+            }
+        };
+
+        // glTF objects
+        template <typename TValue, typename = void>
+        struct SaxValueTraits : SaxRejectValue
+        {
+            static void StartObject(SaxDocumentReader & reader, void * target)
+            {
+                reader.PushObject(*static_cast<TValue *>(target));
+            }
+        };
+
+        template <typename TValue, typename TNumber>
+        inline typename std::enable_if<std::is_arithmetic<TValue>::value>::type ConvertNumber(TNumber number, TValue & value) noexcept
+        {
+            value = static_cast<TValue>(number);
+        }
+
+        template <typename TValue, typename TNumber>
+        inline typename std::enable_if<std::is_enum<TValue>::value>::type ConvertNumber(TNumber number, TValue & value) noexcept
+        {
+            value = static_cast<TValue>(static_cast<typename std::underlying_type<TValue>::type>(number));
+        }
+
+        // Numbers and numeric enums; like nlohmann::json, booleans convert to numbers
+        template <typename TValue>
+        struct SaxValueTraits<TValue, typename std::enable_if<std::is_arithmetic<TValue>::value || std::is_enum<TValue>::value>::type> : SaxRejectValue
+        {
+            static void Integer(SaxDocumentReader &, void * target, int64_t value)
+            {
+                ConvertNumber(value, *static_cast<TValue *>(target));
+            }
+
+            static void UnsignedInteger(SaxDocumentReader &, void * target, uint64_t value)
+            {
+                ConvertNumber(value, *static_cast<TValue *>(target));
+            }
+
+            static void FloatingPoint(SaxDocumentReader &, void * target, double value)
+            {
+                ConvertNumber(value, *static_cast<TValue *>(target));
+            }
+
+            static void Boolean(SaxDocumentReader &, void * target, bool value)
+            {
+                ConvertNumber(value, *static_cast<TValue *>(target));
+            }
+        };
+
+        template <>
+        struct SaxValueTraits<bool> : SaxRejectValue
+        {
+            static void Boolean(SaxDocumentReader &, void * target, bool value)
+            {
+                *static_cast<bool *>(target) = value;
+            }
+        };
+
+        // Enums written as strings
+        template <typename TValue>
+        struct SaxStringEnumTraits : SaxRejectValue
+        {
+            static void String(SaxDocumentReader &, void * target, std::string & value)
+            {
+                ReadEnum(value, *static_cast<TValue *>(target));
+            }
+        };
+
+        template <>
+        struct SaxValueTraits<Accessor::Type> : SaxStringEnumTraits<Accessor::Type>
+        {
+        };
+
+        template <>
+        struct SaxValueTraits<Animation::Sampler::Type> : SaxStringEnumTraits<Animation::Sampler::Type>
+        {
+        };
+
+        template <>
+        struct SaxValueTraits<Camera::Type> : SaxStringEnumTraits<Camera::Type>
+        {
+        };
+
+        template <>
+        struct SaxValueTraits<Material::AlphaMode> : SaxStringEnumTraits<Material::AlphaMode>
+        {
+        };
+
+        template <>
+        struct SaxValueTraits<std::string> : SaxRejectValue
+        {
+            static void String(SaxDocumentReader &, void * target, std::string & value)
+            {
+                *static_cast<std::string *>(target) = std::move(value);
+            }
+        };
+
+        template <typename TValue>
+        struct SaxValueTraits<std::vector<TValue>> : SaxRejectValue
+        {
+            static void StartArray(SaxDocumentReader & reader, void * target)
+            {
+                reader.PushArray(*static_cast<std::vector<TValue> *>(target));
+            }
+        };
+
+        template <typename TValue, std::size_t N>
+        struct SaxValueTraits<std::array<TValue, N>> : SaxRejectValue
+        {
+            static void StartArray(SaxDocumentReader & reader, void * target)
+            {
+                reader.PushArray(*static_cast<std::array<TValue, N> *>(target));
+            }
+        };
+
+        // Extensions and extras are kept as json
+        template <>
+        struct SaxValueTraits<nlohmann::json>
+        {
+            static void Integer(SaxDocumentReader &, void * target, int64_t value)
+            {
+                *static_cast<nlohmann::json *>(target) = value;
+            }
+
+            static void UnsignedInteger(SaxDocumentReader &, void * target, uint64_t value)
+            {
+                *static_cast<nlohmann::json *>(target) = value;
+            }
+
+            static void FloatingPoint(SaxDocumentReader &, void * target, double value)
+            {
+                *static_cast<nlohmann::json *>(target) = value;
+            }
+
+            static void Boolean(SaxDocumentReader &, void * target, bool value)
+            {
+                *static_cast<nlohmann::json *>(target) = value;
+            }
+
+            static void String(SaxDocumentReader &, void * target, std::string & value)
+            {
+                *static_cast<nlohmann::json *>(target) = std::move(value);
+            }
+
+            static void StartObject(SaxDocumentReader & reader, void * target)
+            {
+                *static_cast<nlohmann::json *>(target) = nlohmann::json::object();
+                reader.PushCapture(*static_cast<nlohmann::json *>(target));
+            }
+
+            static void StartArray(SaxDocumentReader & reader, void * target)
+            {
+                *static_cast<nlohmann::json *>(target) = nlohmann::json::array();
+                reader.PushCapture(*static_cast<nlohmann::json *>(target));
+            }
+        };
+
+        template <typename TValue>
+        inline SaxValueReader const * GetSaxValueReader() noexcept
+        {
+            using Traits = SaxValueTraits<TValue>;
+            static constexpr SaxValueReader reader{
+                &Traits::Integer, &Traits::UnsignedInteger, &Traits::FloatingPoint, &Traits::Boolean, &Traits::String, &Traits::StartObject, &Traits::StartArray
+            };
+
+            return &reader;
+        }
+
+        inline void ReadFields(SaxFieldReader & fields, Attributes & attributes)
+        {
+            fields.Any(attributes);
+        }
+
+        inline void ReadFields(SaxFieldReader & fields, Accessor::Sparse::Values & values)
+        {
+            fields.Required("bufferView", values.bufferView);
+
+            fields.Optional("byteOffset", values.byteOffset);
+
+            fields.ExtensionsAndExtras(values.extensionsAndExtras);
+        }
+
+        inline void ReadFields(SaxFieldReader & fields, Accessor::Sparse::Indices & indices)
+        {
+            fields.Required("bufferView", indices.bufferView);
+            fields.Required("componentType", indices.componentType);
+
+            fields.Optional("byteOffset", indices.byteOffset);
+
+            fields.ExtensionsAndExtras(indices.extensionsAndExtras);
+        }
+
+        inline void ReadFields(SaxFieldReader & fields, Accessor::Sparse & sparse)
+        {
+            fields.Required("count", sparse.count);
+            fields.Required("indices", sparse.indices);
+            fields.Required("values", sparse.values);
+
+            fields.ExtensionsAndExtras(sparse.extensionsAndExtras);
+        }
+
+        inline void ReadFields(SaxFieldReader & fields, Accessor & accessor)
+        {
+            fields.Required("componentType", accessor.componentType);
+            fields.Required("count", accessor.count);
+            fields.Required("type", accessor.type);
+
+            fields.Optional("bufferView", accessor.bufferView);
+            fields.Optional("byteOffset", accessor.byteOffset);
+            fields.Optional("max", accessor.max);
+            fields.Optional("min", accessor.min);
+            fields.Optional("name", accessor.name);
+            fields.Optional("normalized", accessor.normalized);
+            fields.Optional("sparse", accessor.sparse);
+
+            fields.ExtensionsAndExtras(accessor.extensionsAndExtras);
+        }
+
+        inline void ReadFields(SaxFieldReader & fields, Animation::Channel::Target & animationChannelTarget)
+        {
+            fields.Required("path", animationChannelTarget.path);
+
+            fields.Optional("node", animationChannelTarget.node);
+
+            fields.ExtensionsAndExtras(animationChannelTarget.extensionsAndExtras);
+        }
+
+        inline void ReadFields(SaxFieldReader & fields, Animation::Channel & animationChannel)
+        {
+            fields.Required("sampler", animationChannel.sampler);
+            fields.Required("target", animationChannel.target);
+
+            fields.ExtensionsAndExtras(animationChannel.extensionsAndExtras);
+        }
+
+        inline void ReadFields(SaxFieldReader & fields, Animation::Sampler & animationSampler)
+        {
+            fields.Required("input", animationSampler.input);
+            fields.Required("output", animationSampler.output);
+
+            fields.Optional("interpolation", animationSampler.interpolation);
+
+            fields.ExtensionsAndExtras(animationSampler.extensionsAndExtras);
+        }
+
+        inline void ReadFields(SaxFieldReader & fields, Animation & animation)
+        {
+            fields.Required("channels", animation.channels);
+            fields.Required("samplers", animation.samplers);
+
+            fields.Optional("name", animation.name);
+
+            fields.ExtensionsAndExtras(animation.extensionsAndExtras);
+        }
+
+        inline void ReadFields(SaxFieldReader & fields, Asset & asset)
+        {
+            fields.Required("version", asset.version);
+            fields.Optional("copyright", asset.copyright);
+            fields.Optional("generator", asset.generator);
+            fields.Optional("minVersion", asset.minVersion);
+
+            fields.ExtensionsAndExtras(asset.extensionsAndExtras);
+        }
+
+        inline void ReadFields(SaxFieldReader & fields, Buffer & buffer)
+        {
+            fields.Required("byteLength", buffer.byteLength);
+
+            fields.Optional("name", buffer.name);
+            fields.Optional("uri", buffer.uri);
+
+            fields.ExtensionsAndExtras(buffer.extensionsAndExtras);
+        }
+
+        inline void ReadFields(SaxFieldReader & fields, BufferView & bufferView)
+        {
+            fields.Required("buffer", bufferView.buffer);
+            fields.Required("byteLength", bufferView.byteLength);
+
+            fields.Optional("byteOffset", bufferView.byteOffset);
+            fields.Optional("byteStride", bufferView.byteStride);
+            fields.Optional("name", bufferView.name);
+            fields.Optional("target", bufferView.target);
+
+            fields.ExtensionsAndExtras(bufferView.extensionsAndExtras);
+        }
+
+        inline void ReadFields(SaxFieldReader & fields, Camera::Orthographic & camera)
+        {
+            fields.Required("xmag", camera.xmag);
+            fields.Required("ymag", camera.ymag);
+            fields.Required("zfar", camera.zfar);
+            fields.Required("znear", camera.znear);
+
+            fields.ExtensionsAndExtras(camera.extensionsAndExtras);
+        }
+
+        inline void ReadFields(SaxFieldReader & fields, Camera::Perspective & camera)
+        {
+            fields.Required("yfov", camera.yfov);
+            fields.Required("znear", camera.znear);
+
+            fields.Optional("aspectRatio", camera.aspectRatio);
+            fields.Optional("zfar", camera.zfar);
+
+            fields.ExtensionsAndExtras(camera.extensionsAndExtras);
+        }
+
+        inline void ReadFields(SaxFieldReader & fields, Camera & camera)
+        {
+            fields.Required("type", camera.type);
+
+            fields.Optional("name", camera.name);
+
+            fields.ExtensionsAndExtras(camera.extensionsAndExtras);
+
+            // The type may come after the projection, so both are read and only checked once the object is complete
+            fields.RequiredIf(camera.type == Camera::Type::Perspective, "perspective", camera.perspective);
+            fields.RequiredIf(camera.type == Camera::Type::Orthographic, "orthographic", camera.orthographic);
+        }
+
+        inline void ReadFields(SaxFieldReader & fields, Image & image)
+        {
+            fields.Optional("bufferView", image.bufferView);
+            fields.Optional("mimeType", image.mimeType);
+            fields.Optional("name", image.name);
+            fields.Optional("uri", image.uri);
+
+            fields.ExtensionsAndExtras(image.extensionsAndExtras);
+        }
+
+        inline void ReadFields(SaxFieldReader & fields, Material::Texture & materialTexture)
+        {
+            fields.Required("index", materialTexture.index);
+            fields.Optional("texCoord", materialTexture.texCoord);
+
+            fields.ExtensionsAndExtras(materialTexture.extensionsAndExtras);
+        }
+
+        inline void ReadFields(SaxFieldReader & fields, Material::NormalTexture & materialTexture)
+        {
+            ReadFields(fields, static_cast<Material::Texture &>(materialTexture));
+            fields.Optional("scale", materialTexture.scale);
+        }
+
+        inline void ReadFields(SaxFieldReader & fields, Material::OcclusionTexture & materialTexture)
+        {
+            ReadFields(fields, static_cast<Material::Texture &>(materialTexture));
+            fields.Optional("strength", materialTexture.strength);
+        }
+
+        inline void ReadFields(SaxFieldReader & fields, Material::PBRMetallicRoughness & pbrMetallicRoughness)
+        {
+            fields.Optional("baseColorFactor", pbrMetallicRoughness.baseColorFactor);
+            fields.Optional("baseColorTexture", pbrMetallicRoughness.baseColorTexture);
+            fields.Optional("metallicFactor", pbrMetallicRoughness.metallicFactor);
+            fields.Optional("metallicRoughnessTexture", pbrMetallicRoughness.metallicRoughnessTexture);
+            fields.Optional("roughnessFactor", pbrMetallicRoughness.roughnessFactor);
+
+            fields.ExtensionsAndExtras(pbrMetallicRoughness.extensionsAndExtras);
+        }
+
+        inline void ReadFields(SaxFieldReader & fields, Material & material)
+        {
+            fields.Optional("alphaMode", material.alphaMode);
+            fields.Optional("alphaCutoff", material.alphaCutoff);
+            fields.Optional("doubleSided", material.doubleSided);
+            fields.Optional("emissiveFactor", material.emissiveFactor);
+            fields.Optional("emissiveTexture", material.emissiveTexture);
+            fields.Optional("name", material.name);
+            fields.Optional("normalTexture", material.normalTexture);
+            fields.Optional("occlusionTexture", material.occlusionTexture);
+            fields.Optional("pbrMetallicRoughness", material.pbrMetallicRoughness);
+
+            fields.ExtensionsAndExtras(material.extensionsAndExtras);
+        }
+
+        inline void ReadFields(SaxFieldReader & fields, Mesh & mesh)
+        {
+            fields.Required("primitives", mesh.primitives);
+
+            fields.Optional("name", mesh.name);
+            fields.Optional("weights", mesh.weights);
+
+            fields.ExtensionsAndExtras(mesh.extensionsAndExtras);
+        }
+
+        inline void ReadFields(SaxFieldReader & fields, Node & node)
+        {
+            fields.Optional("camera", node.camera);
+            fields.Optional("children", node.children);
+            fields.Optional("matrix", node.matrix);
+            fields.Optional("mesh", node.mesh);
+            fields.Optional("name", node.name);
+            fields.Optional("rotation", node.rotation);
+            fields.Optional("scale", node.scale);
+            fields.Optional("skin", node.skin);
+            fields.Optional("translation", node.translation);
+
+            fields.ExtensionsAndExtras(node.extensionsAndExtras);
+        }
+
+        inline void ReadFields(SaxFieldReader & fields, Primitive & primitive)
+        {
+            fields.Required("attributes", primitive.attributes);
+
+            fields.Optional("indices", primitive.indices);
+            fields.Optional("material", primitive.material);
+            fields.Optional("mode", primitive.mode);
+            fields.Optional("targets", primitive.targets);
+
+            fields.ExtensionsAndExtras(primitive.extensionsAndExtras);
+        }
+
+        inline void ReadFields(SaxFieldReader & fields, Sampler & sampler)
+        {
+            fields.Optional("magFilter", sampler.magFilter);
+            fields.Optional("minFilter", sampler.minFilter);
+            fields.Optional("name", sampler.name);
+            fields.Optional("wrapS", sampler.wrapS);
+            fields.Optional("wrapT", sampler.wrapT);
+
+            fields.ExtensionsAndExtras(sampler.extensionsAndExtras);
+        }
+
+        inline void ReadFields(SaxFieldReader & fields, Scene & scene)
+        {
+            fields.Optional("name", scene.name);
+            fields.Optional("nodes", scene.nodes);
+
+            fields.ExtensionsAndExtras(scene.extensionsAndExtras);
+        }
+
+        inline void ReadFields(SaxFieldReader & fields, Skin & skin)
+        {
+            fields.Required("joints", skin.joints);
+
+            fields.Optional("inverseBindMatrices", skin.inverseBindMatrices);
+            fields.Optional("name", skin.name);
+            fields.Optional("skeleton", skin.skeleton);
+
+            fields.ExtensionsAndExtras(skin.extensionsAndExtras);
+        }
+
+        inline void ReadFields(SaxFieldReader & fields, Texture & texture)
+        {
+            fields.Optional("name", texture.name);
+            fields.Optional("sampler", texture.sampler);
+            fields.Optional("source", texture.source);
+
+            fields.ExtensionsAndExtras(texture.extensionsAndExtras);
+        }
+
+        inline void ReadFields(SaxFieldReader & fields, Document & document)
+        {
+            fields.Required("asset", document.asset);
+
+            fields.Optional("accessors", document.accessors);
+            fields.Optional("animations", document.animations);
+            fields.Optional("buffers", document.buffers);
+            fields.Optional("bufferViews", document.bufferViews);
+            fields.Optional("cameras", document.cameras);
+            fields.Optional("materials", document.materials);
+            fields.Optional("meshes", document.meshes);
+            fields.Optional("nodes", document.nodes);
+            fields.Optional("images", document.images);
+            fields.Optional("samplers", document.samplers);
+            fields.Optional("scene", document.scene);
+            fields.Optional("scenes", document.scenes);
+            fields.Optional("skins", document.skins);
+            fields.Optional("textures", document.textures);
+
+            fields.Optional("extensionsUsed", document.extensionsUsed);
+            fields.Optional("extensionsRequired", document.extensionsRequired);
+            fields.ExtensionsAndExtras(document.extensionsAndExtras);
+        }
+
+        inline Document ParseDocument(std::istream & input)
+        {
+            // Not strict, matching `input >> json`, so trailing content after the document is ignored
+            Document document{};
+            SaxDocumentReader reader(document);
+            nlohmann::json::sax_parse(input, &reader, nlohmann::json::input_format_t::json, false);
+
+            return document;
+        }
+
+        inline Document ParseDocument(uint8_t const * first, uint8_t const * last)
+        {
+            Document document{};
+            SaxDocumentReader reader(document);
+            nlohmann::json::sax_parse(first, last, &reader);
+
+            return document;
+        }
+    } // namespace detail
+
+    inline void to_json(nlohmann::json & json, Accessor::ComponentType const & accessorComponentType)
+    {
+        if (accessorComponentType == Accessor::ComponentType::None)
+        {
+            throw invalid_gltf_document("Unknown accessor.componentType value");
+        }
+
+        json = static_cast<uint16_t>(accessorComponentType);
+    }
+
+    namespace detail
+    {
+        inline char const * GetAccessorTypeText(Accessor::Type accessorType)
+        {
+            switch (accessorType)
+            {
+            case Accessor::Type::Scalar:
+                return "SCALAR";
+            case Accessor::Type::Vec2:
+                return "VEC2";
+            case Accessor::Type::Vec3:
+                return "VEC3";
+            case Accessor::Type::Vec4:
+                return "VEC4";
+            case Accessor::Type::Mat2:
+                return "MAT2";
+            case Accessor::Type::Mat3:
+                return "MAT3";
+            case Accessor::Type::Mat4:
+                return "MAT4";
+            default:
+                throw invalid_gltf_document("Unknown accessor.type value");
+            }
+        }
+
+        inline void WriteJsonValue(JsonWriter & json, Accessor::Type accessorType)
+        {
+            json.String(GetAccessorTypeText(accessorType));
+        }
+    } // namespace detail
+
+    inline void to_json(nlohmann::json & json, Accessor::Type const & accessorType)
+    {
+        json = detail::GetAccessorTypeText(accessorType);
+    }
+
+    template <typename TJson>
+    inline void to_json(TJson & json, Accessor::Sparse::Values const & values)
+    {
+        detail::WriteField("bufferView", json, values.bufferView, static_cast<uint32_t>(-1));
+        detail::WriteField("byteOffset", json, values.byteOffset, {});
+        detail::WriteExtensions(json, values.extensionsAndExtras);
+    }
+
+    template <typename TJson>
+    inline void to_json(TJson & json, Accessor::Sparse::Indices const & indices)
+    {
+        detail::WriteField("bufferView", json, indices.bufferView, static_cast<uint32_t>(-1));
+        detail::WriteField("byteOffset", json, indices.byteOffset, {});
+        detail::WriteField("componentType", json, indices.componentType, Accessor::ComponentType::None);
+        detail::WriteExtensions(json, indices.extensionsAndExtras);
+    }
+
+    template <typename TJson>
+    inline void to_json(TJson & json, Accessor::Sparse const & sparse)
+    {
+        detail::WriteField("count", json, sparse.count, -1);
+        detail::WriteExtensions(json, sparse.extensionsAndExtras);
+        detail::WriteField("indices", json, sparse.indices);
+        detail::WriteField("values", json, sparse.values);
+    }
+
+    namespace detail
+    {
+        template <typename TType>
+        inline std::vector<TType> ConvertMinMax(std::vector<float> const & values)
+        {
+            std::vector<TType> converted(values.size());
+            std::transform(values.begin(), values.end(), converted.begin(), [](float v) { return static_cast<TType>(v); });
+            return converted;
+        }
+
+        template <typename TType, typename TJson>
+        inline void WriteMinMaxConvert(TJson & json, Accessor const & accessor)
+        {
+            detail::WriteField("max", json, ConvertMinMax<TType>(accessor.max));
+            detail::WriteField("min", json, ConvertMinMax<TType>(accessor.min));
+        }
+
+        template <typename TJson>
+        inline void WriteAccessorMinMax(TJson & json, Accessor const & accessor)
+        {
+            switch (accessor.componentType)
+            {
+            // fast path
+            case Accessor::ComponentType::Float:
+                detail::WriteField("max", json, accessor.max);
+                detail::WriteField("min", json, accessor.min);
+                break;
+
+            // slow path conversions...
+            case Accessor::ComponentType::Byte:
+                WriteMinMaxConvert<int8_t>(json, accessor);
+                break;
+            case Accessor::ComponentType::UnsignedByte:
+                WriteMinMaxConvert<uint8_t>(json, accessor);
+                break;
+            case Accessor::ComponentType::Short:
+                WriteMinMaxConvert<int16_t>(json, accessor);
+                break;
+            case Accessor::ComponentType::UnsignedShort:
+                WriteMinMaxConvert<uint16_t>(json, accessor);
+                break;
+            case Accessor::ComponentType::UnsignedInt:
+                WriteMinMaxConvert<uint32_t>(json, accessor);
+                break;
+            case Accessor::ComponentType::None:
+                break;
+            }
+        }
+    } // namespace detail
+
+    template <typename TJson>
+    inline void to_json(TJson & json, Accessor const & accessor)
+    {
+        detail::WriteField("bufferView", json, accessor.bufferView, -1);
+        detail::WriteField("byteOffset", json, accessor.byteOffset, {});
+        detail::WriteField("componentType", json, accessor.componentType, Accessor::ComponentType::None);
+        detail::WriteField("count", json, accessor.count, {});
+        detail::WriteExtensions(json, accessor.extensionsAndExtras);
+        detail::WriteAccessorMinMax(json, accessor);
+        detail::WriteField("name", json, accessor.name);
+        detail::WriteField("normalized", json, accessor.normalized, false);
+        detail::WriteField("sparse", json, accessor.sparse);
+        detail::WriteField("type", json, accessor.type, Accessor::Type::None);
+    }
+
+    template <typename TJson>
+    inline void to_json(TJson & json, Animation::Channel::Target const & animationChannelTarget)
+    {
+        detail::WriteExtensions(json, animationChannelTarget.extensionsAndExtras);
+        detail::WriteField("node", json, animationChannelTarget.node, -1);
+        detail::WriteField("path", json, animationChannelTarget.path);
+    }
+
+    template <typename TJson>
+    inline void to_json(TJson & json, Animation::Channel const & animationChannel)
+    {
+        detail::WriteExtensions(json, animationChannel.extensionsAndExtras);
+        detail::WriteField("sampler", json, animationChannel.sampler, -1);
+        detail::WriteField("target", json, animationChannel.target);
+    }
+
+    namespace detail
+    {
+        inline char const * GetAnimationSamplerTypeText(Animation::Sampler::Type animationSamplerType)
+        {
+            switch (animationSamplerType)
+            {
+            case Animation::Sampler::Type::Linear:
+                return "LINEAR";
+            case Animation::Sampler::Type::Step:
+                return "STEP";
+            case Animation::Sampler::Type::CubicSpline:
+                return "CUBICSPLINE";
+            default:
+                throw invalid_gltf_document("Unknown animation.sampler.interpolation value");
+            }
+        }
+
+        inline void WriteJsonValue(JsonWriter & json, Animation::Sampler::Type animationSamplerType)
+        {
+            json.String(GetAnimationSamplerTypeText(animationSamplerType));
+        }
+    } // namespace detail
+
+    inline void to_json(nlohmann::json & json, Animation::Sampler::Type const & animationSamplerType)
+    {
+        json = detail::GetAnimationSamplerTypeText(animationSamplerType);
+    }
+
+    template <typename TJson>
+    inline void to_json(TJson & json, Animation::Sampler const & animationSampler)
+    {
+        detail::WriteExtensions(json, animationSampler.extensionsAndExtras);
+        detail::WriteField("input", json, animationSampler.input, -1);
+        detail::WriteField("interpolation", json, animationSampler.interpolation, Animation::Sampler::Type::Linear);
+        detail::WriteField("output", json, animationSampler.output, -1);
+    }
+
+    template <typename TJson>
+    inline void to_json(TJson & json, Animation const & animation)
+    {
+        detail::WriteField("channels", json, animation.channels);
+        detail::WriteExtensions(json, animation.extensionsAndExtras);
+        detail::WriteField("name", json, animation.name);
+        detail::WriteField("samplers", json, animation.samplers);
+    }
+
+    template <typename TJson>
+    inline void to_json(TJson & json, Asset const & asset)
+    {
+        detail::WriteField("copyright", json, asset.copyright);
+        detail::WriteExtensions(json, asset.extensionsAndExtras);
+        detail::WriteField("generator", json, asset.generator);
+        detail::WriteField("minVersion", json, asset.minVersion);
+        detail::WriteField("version", json, asset.version);
+    }
+
+    namespace detail
+    {
+        inline void WriteBufferUri(nlohmann::json & json, Buffer const & buffer)
+        {
+            detail::WriteField("uri", json, buffer.uri);
+        }
+
+        inline void WriteBufferUri(JsonWriter & json, Buffer const & buffer)
+        {
+            if (buffer.IsEmbeddedResourceOnSave())
+            {
+                const Span<uint8_t const> bytes = buffer.GetData();
+                json.Key("uri");
+                json.Base64String(buffer.uri, bytes.data(), bytes.size());
+            }
+            else
+            {
+                detail::WriteField("uri", json, buffer.uri);
+            }
+        }
+    } // namespace detail
+
+    template <typename TJson>
+    inline void to_json(TJson & json, Buffer const & buffer)
+    {
+        detail::WriteField("byteLength", json, buffer.byteLength, {});
+        detail::WriteExtensions(json, buffer.extensionsAndExtras);
+        detail::WriteField("name", json, buffer.name);
+        detail::WriteBufferUri(json, buffer);
+    }
+
+    template <typename TJson>
+    inline void to_json(TJson & json, BufferView const & bufferView)
+    {
+        detail::WriteField("buffer", json, bufferView.buffer, -1);
+        detail::WriteField("byteLength", json, bufferView.byteLength, {});
+        detail::WriteField("byteOffset", json, bufferView.byteOffset, {});
+        detail::WriteField("byteStride", json, bufferView.byteStride, {});
+        detail::WriteExtensions(json, bufferView.extensionsAndExtras);
+        detail::WriteField("name", json, bufferView.name);
+        detail::WriteField("target", json, bufferView.target, BufferView::TargetType::None);
+    }
+
+    namespace detail
+    {
+        inline char const * GetCameraTypeText(Camera::Type cameraType)
+        {
+            switch (cameraType)
+            {
+            case Camera::Type::Orthographic:
+                return "orthographic";
+            case Camera::Type::Perspective:
+                return "perspective";
+            default:
+                throw invalid_gltf_document("Unknown camera.type value");
+            }
+        }
+
+        inline void WriteJsonValue(JsonWriter & json, Camera::Type cameraType)
+        {
+            json.String(GetCameraTypeText(cameraType));
+        }
+    } // namespace detail
+
+    inline void to_json(nlohmann::json & json, Camera::Type const & cameraType)
+    {
+        json = detail::GetCameraTypeText(cameraType);
+    }
+
+    template <typename TJson>
+    inline void to_json(TJson & json, Camera::Orthographic const & camera)
+    {
+        detail::WriteExtensions(json, camera.extensionsAndExtras);
+        detail::WriteField("xmag", json, camera.xmag, defaults::FloatSentinel);
+        detail::WriteField("ymag", json, camera.ymag, defaults::FloatSentinel);
+        detail::WriteField("zfar", json, camera.zfar, -defaults::FloatSentinel);
+        detail::WriteField("znear", json, camera.znear, -defaults::FloatSentinel);
+    }
+
+    template <typename TJson>
+    inline void to_json(TJson & json, Camera::Perspective const & camera)
+    {
+        detail::WriteField("aspectRatio", json, camera.aspectRatio, {});
+        detail::WriteExtensions(json, camera.extensionsAndExtras);
+        detail::WriteField("yfov", json, camera.yfov, {});
+        detail::WriteField("zfar", json, camera.zfar, {});
+        detail::WriteField("znear", json, camera.znear, {});
+    }
+
+    template <typename TJson>
+    inline void to_json(TJson & json, Camera const & camera)
+    {
+        detail::WriteExtensions(json, camera.extensionsAndExtras);
+        detail::WriteField("name", json, camera.name);
+
+        if (camera.type == Camera::Type::Perspective)
+        {
+            detail::WriteField("perspective", json, camera.perspective);
+        }
+        else if (camera.type == Camera::Type::Orthographic)
+        {
+            detail::WriteField("orthographic", json, camera.orthographic);
+        }
+
+        detail::WriteField("type", json, camera.type, Camera::Type::None);
+    }
+
+    template <typename TJson>
+    inline void to_json(TJson & json, Image const & image)
+    {
+        detail::WriteField("bufferView", json, image.bufferView, image.uri.empty() ? -1 : 0); // bufferView or uri need to be written; even if default 0
+        detail::WriteExtensions(json, image.extensionsAndExtras);
+        detail::WriteField("mimeType", json, image.mimeType);
+        detail::WriteField("name", json, image.name);
+        detail::WriteField("uri", json, image.uri);
+    }
+
+    namespace detail
+    {
+        inline char const * GetMaterialAlphaModeText(Material::AlphaMode materialAlphaMode)
+        {
+            switch (materialAlphaMode)
+            {
+            case Material::AlphaMode::Opaque:
+                return "OPAQUE";
+            case Material::AlphaMode::Mask:
+                return "MASK";
+            case Material::AlphaMode::Blend:
+                return "BLEND";
+            default:
+                throw invalid_gltf_document("Unknown material.alphaMode value");
+            }
+        }
+
+        inline void WriteJsonValue(JsonWriter & json, Material::AlphaMode materialAlphaMode)
+        {
+            json.String(GetMaterialAlphaModeText(materialAlphaMode));
+        }
+    } // namespace detail
+
+    inline void to_json(nlohmann::json & json, Material::AlphaMode const & materialAlphaMode)
+    {
+        json = detail::GetMaterialAlphaModeText(materialAlphaMode);
+    }
+
+    template <typename TJson>
+    inline void to_json(TJson & json, Material::Texture const & materialTexture)
+    {
+        detail::WriteExtensions(json, materialTexture.extensionsAndExtras);
+        detail::WriteField("index", json, materialTexture.index, -1);
+        detail::WriteField("texCoord", json, materialTexture.texCoord, 0);
+    }
+
+    template <typename TJson>
+    inline void to_json(TJson & json, Material::NormalTexture const & materialTexture)
+    {
+        detail::WriteExtensions(json, materialTexture.extensionsAndExtras);
+        detail::WriteField("index", json, materialTexture.index, -1);
+        detail::WriteField("scale", json, materialTexture.scale, defaults::IdentityScalar);
+        detail::WriteField("texCoord", json, materialTexture.texCoord, 0);
+    }
+
+    template <typename TJson>
+    inline void to_json(TJson & json, Material::OcclusionTexture const & materialTexture)
+    {
+        detail::WriteExtensions(json, materialTexture.extensionsAndExtras);
+        detail::WriteField("index", json, materialTexture.index, -1);
+        detail::WriteField("strength", json, materialTexture.strength, defaults::IdentityScalar);
+        detail::WriteField("texCoord", json, materialTexture.texCoord, 0);
+    }
+
+    template <typename TJson>
+    inline void to_json(TJson & json, Material::PBRMetallicRoughness const & pbrMetallicRoughness)
+    {
+        detail::WriteField("baseColorFactor", json, pbrMetallicRoughness.baseColorFactor, defaults::IdentityVec4);
+        detail::WriteField("baseColorTexture", json, pbrMetallicRoughness.baseColorTexture);
+        detail::WriteExtensions(json, pbrMetallicRoughness.extensionsAndExtras);
+        detail::WriteField("metallicFactor", json, pbrMetallicRoughness.metallicFactor, defaults::IdentityScalar);
+        detail::WriteField("metallicRoughnessTexture", json, pbrMetallicRoughness.metallicRoughnessTexture);
+        detail::WriteField("roughnessFactor", json, pbrMetallicRoughness.roughnessFactor, defaults::IdentityScalar);
+    }
+
+    template <typename TJson>
+    inline void to_json(TJson & json, Material const & material)
+    {
+        detail::WriteField("alphaCutoff", json, material.alphaCutoff, defaults::MaterialAlphaCutoff);
+        detail::WriteField("alphaMode", json, material.alphaMode, Material::AlphaMode::Opaque);
+        detail::WriteField("doubleSided", json, material.doubleSided, defaults::MaterialDoubleSided);
+        detail::WriteField("emissiveFactor", json, material.emissiveFactor, defaults::NullVec3);
+        detail::WriteField("emissiveTexture", json, material.emissiveTexture);
+        detail::WriteField("name", json, material.name);
+        detail::WriteField("normalTexture", json, material.normalTexture);
+        detail::WriteField("occlusionTexture", json, material.occlusionTexture);
+        detail::WriteField("pbrMetallicRoughness", json, material.pbrMetallicRoughness);
+
+        detail::WriteExtensions(json, material.extensionsAndExtras);
+    }
+
+    template <typename TJson>
+    inline void to_json(TJson & json, Mesh const & mesh)
+    {
+        detail::WriteExtensions(json, mesh.extensionsAndExtras);
+        detail::WriteField("name", json, mesh.name);
+        detail::WriteField("primitives", json, mesh.primitives);
+        detail::WriteField("weights", json, mesh.weights);
+    }
+
+    template <typename TJson>
+    inline void to_json(TJson & json, Node const & node)
+    {
+        detail::WriteField("camera", json, node.camera, -1);
+        detail::WriteField("children", json, node.children);
+        detail::WriteExtensions(json, node.extensionsAndExtras);
+        detail::WriteField("matrix", json, node.matrix, defaults::IdentityMatrix);
+        detail::WriteField("mesh", json, node.mesh, -1);
+        detail::WriteField("name", json, node.name);
+        detail::WriteField("rotation", json, node.rotation, defaults::IdentityRotation);
+        detail::WriteField("scale", json, node.scale, defaults::IdentityVec3);
+        detail::WriteField("skin", json, node.skin, -1);
+        detail::WriteField("translation", json, node.translation, defaults::NullVec3);
+        detail::WriteField("weights", json, node.weights);
+    }
+
+    template <typename TJson>
+    inline void to_json(TJson & json, Primitive const & primitive)
+    {
+        detail::WriteField("attributes", json, primitive.attributes);
+        detail::WriteExtensions(json, primitive.extensionsAndExtras);
+        detail::WriteField("indices", json, primitive.indices, -1);
+        detail::WriteField("material", json, primitive.material, -1);
+        detail::WriteField("mode", json, primitive.mode, Primitive::Mode::Triangles);
+        detail::WriteField("targets", json, primitive.targets);
+    }
+
+    template <typename TJson>
+    inline void to_json(TJson & json, Sampler const & sampler)
+    {
+        if (!sampler.empty())
+        {
+            detail::WriteExtensions(json, sampler.extensionsAndExtras);
+            detail::WriteField("magFilter", json, sampler.magFilter, Sampler::MagFilter::None);
+            detail::WriteField("minFilter", json, sampler.minFilter, Sampler::MinFilter::None);
+            detail::WriteField("name", json, sampler.name);
+            detail::WriteField("wrapS", json, sampler.wrapS, Sampler::WrappingMode::Repeat);
+            detail::WriteField("wrapT", json, sampler.wrapT, Sampler::WrappingMode::Repeat);
+        }
+        else
+        {
+            // If a sampler is completely empty we still need to write out an empty object for the encompassing array...
+            detail::WriteEmptyObject(json);
+        }
+    }
+
+    template <typename TJson>
+    inline void to_json(TJson & json, Scene const & scene)
+    {
+        detail::WriteExtensions(json, scene.extensionsAndExtras);
+        detail::WriteField("name", json, scene.name);
+        detail::WriteField("nodes", json, scene.nodes);
+    }
+
+    template <typename TJson>
+    inline void to_json(TJson & json, Skin const & skin)
+    {
+        detail::WriteExtensions(json, skin.extensionsAndExtras);
+        detail::WriteField("inverseBindMatrices", json, skin.inverseBindMatrices, -1);
+        detail::WriteField("joints", json, skin.joints);
+        detail::WriteField("name", json, skin.name);
+        detail::WriteField("skeleton", json, skin.skeleton, -1);
+    }
+
+    template <typename TJson>
+    inline void to_json(TJson & json, Texture const & texture)
+    {
+        detail::WriteExtensions(json, texture.extensionsAndExtras);
+        detail::WriteField("name", json, texture.name);
+        detail::WriteField("sampler", json, texture.sampler, -1);
+        detail::WriteField("source", json, texture.source, -1);
+    }
+
+    namespace detail
+    {
+        // Writes the document with `accessors` in place of document.accessors
+        template <typename TJson>
+        inline void WriteDocument(TJson & json, Document const & document, std::vector<Accessor> const & accessors)
+        {
+            detail::WriteField("accessors", json, accessors);
+            detail::WriteField("animations", json, document.animations);
+            detail::WriteField("asset", json, document.asset);
+            detail::WriteField("bufferViews", json, document.bufferViews);
+            detail::WriteField("buffers", json, document.buffers);
+            detail::WriteField("cameras", json, document.cameras);
+            detail::WriteExtensions(json, document.extensionsAndExtras, "extensionsRequired", true);
+            detail::WriteField("extensionsRequired", json, document.extensionsRequired);
+            detail::WriteField("extensionsUsed", json, document.extensionsUsed);
+            detail::WriteExtensions(json, document.extensionsAndExtras, "extensionsRequired", false);
+            detail::WriteField("images", json, document.images);
+            detail::WriteField("materials", json, document.materials);
+            detail::WriteField("meshes", json, document.meshes);
+            detail::WriteField("nodes", json, document.nodes);
+            detail::WriteField("samplers", json, document.samplers);
+            detail::WriteField("scene", json, document.scene, -1);
+            detail::WriteField("scenes", json, document.scenes);
+            detail::WriteField("skins", json, document.skins);
+            detail::WriteField("textures", json, document.textures);
+        }
+    } // namespace detail
+
+    template <typename TJson>
+    inline void to_json(TJson & json, Document const & document)
+    {
+        detail::WriteDocument(json, document, document.accessors);
+    }
+
+    namespace detail
+    {
+        struct DataContext
+        {
+            FX_GLTF_FILESYSTEM::path bufferRootPath{};
+            ReadQuotas readQuotas;
+            ReadOptions readOptions{};
+
+            std::vector<uint8_t> * binaryData{};
+
+            std::shared_ptr<uint8_t> binaryStorage{};
+            std::size_t binaryStorageLength{};
+            bool useMappedFiles{};
+
+            // The .glb file and offset of a BIN chunk left unread by ReadOptions::DeferBufferData
+            FX_GLTF_FILESYSTEM::path binaryFilePath{};
+            std::size_t binaryFileOffset{};
+        };
+
+        // A read-only, copy-on-write, mapping of an entire file; without FX_GLTF_ENABLE_MMAP, a copy of it in memory
+        class MappedFile
+        {
+        public:
+            explicit MappedFile(FX_GLTF_FILESYSTEM::path const & filePath)
+            {
+#if !defined(FX_GLTF_ENABLE_MMAP)
+                std::ifstream file(filePath, std::ios::binary | std::ios::ate);
+                const std::streamoff fileSize = file ? static_cast<std::streamoff>(file.tellg()) : 0;
+                if (fileSize > 0 && file.seekg(0, std::ios::beg))
+                {
+                    m_storage.reset(new uint8_t[static_cast<std::size_t>(fileSize)]);
+                    if (file.read(reinterpret_cast<char *>(m_storage.get()), static_cast<std::streamsize>(fileSize)))
+                    {
+                        m_data = m_storage.get();
+                        m_size = static_cast<std::size_t>(fileSize);
+                    }
+                }
+#elif defined(_WIN32)
+                m_file = ::CreateFileW(filePath.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+                if (m_file == INVALID_HANDLE_VALUE)
+                {
+                    return;
+                }
+
+                LARGE_INTEGER fileSize{};
+                if (::GetFileSizeEx(m_file, &fileSize) != 0 && fileSize.QuadPart > 0)
+                {
+                    m_mapping = ::CreateFileMappingW(m_file, nullptr, PAGE_WRITECOPY, 0, 0, nullptr);
+                    if (m_mapping != nullptr)
+                    {
+                        m_data = static_cast<uint8_t *>(::MapViewOfFile(m_mapping, FILE_MAP_COPY, 0, 0, 0));
+                        m_size = m_data != nullptr ? static_cast<std::size_t>(fileSize.QuadPart) : 0;
+                    }
+                }
+#else
+                const int fd = ::open(filePath.c_str(), O_RDONLY | O_CLOEXEC);
+                if (fd == -1)
+                {
+                    return;
+                }
+
+                struct stat fileInfo
+                {
+                };
+                if (::fstat(fd, &fileInfo) == 0 && fileInfo.st_size > 0)
+                {
+                    void * address = ::mmap(nullptr, static_cast<std::size_t>(fileInfo.st_size), PROT_READ | PROT_WRITE, MAP_PRIVATE, fd, 0);
+                    if (address != MAP_FAILED)
+                    {
+                        m_data = static_cast<uint8_t *>(address);
+                        m_size = static_cast<std::size_t>(fileInfo.st_size);
+                    }
+                }
+
+                ::close(fd);
+#endif
+            }
+
+            MappedFile(MappedFile const &) = delete;
+            MappedFile(MappedFile &&) = delete;
+            MappedFile & operator=(MappedFile const &) = delete;
+            MappedFile & operator=(MappedFile &&) = delete;
+
+            ~MappedFile()
+            {
+#if defined(FX_GLTF_ENABLE_MMAP) && defined(_WIN32)
+                if (m_data != nullptr)
+                {
+                    ::UnmapViewOfFile(m_data);
+                }
+
+                if (m_mapping != nullptr)
+                {
+                    ::CloseHandle(m_mapping);
+                }
+
+                if (m_file != INVALID_HANDLE_VALUE)
+                {
+                    ::CloseHandle(m_file);
+                }
+#elif defined(FX_GLTF_ENABLE_MMAP)
+                if (m_data != nullptr)
+                {
+                    ::munmap(m_data, m_size);
+                }
+#endif
+            }
+
+            FX_GLTF_NODISCARD bool IsOpen() const noexcept
+            {
+                return m_data != nullptr;
+            }
+
+            FX_GLTF_NODISCARD uint8_t * data() const noexcept
+            {
+                return m_data;
+            }
+
+            FX_GLTF_NODISCARD std::size_t size() const noexcept
+            {
+                return m_size;
+            }
+
+        private:
+#if !defined(FX_GLTF_ENABLE_MMAP)
+            std::unique_ptr<uint8_t[]> m_storage{};
+#elif defined(_WIN32)
+            HANDLE m_file{ INVALID_HANDLE_VALUE };
+            HANDLE m_mapping{};
+#endif
+            uint8_t * m_data{};
+            std::size_t m_size{};
+        };
+
+        inline void ThrowIfBad(std::ios const & io)
+        {
+            if (!io.good())
+            {
+                throw std::system_error(std::make_error_code(std::errc::io_error));
+            }
+        }
+
+        inline void ValidateGLBHeader(GLBHeader const & header)
+        {
+            if (header.magic != detail::GLBHeaderMagic ||
+                header.jsonHeader.chunkType != detail::GLBChunkJSON ||
+                header.jsonHeader.chunkLength + detail::HeaderSize > header.length)
+            {
+                throw invalid_gltf_document("Invalid GLB header");
+            }
+        }
+
+        // Moves buffer contents in pieces; single reads and writes of several GB are unreliable on some platforms
+        FX_GLTF_INLINE_CONSTEXPR std::size_t MaxStreamChunkSize = 1024 * 1024 * 1024;
+
+        inline bool ReadFully(std::istream & input, uint8_t * data, uint64_t length)
+        {
+            while (length > 0)
+            {
+                const std::size_t chunk = static_cast<std::size_t>(std::min<uint64_t>(length, MaxStreamChunkSize));
+                if (!input.read(reinterpret_cast<char *>(data), static_cast<std::streamsize>(chunk)))
+                {
+                    return false;
+                }
+
+                data += chunk;
+                length -= chunk;
+            }
+
+            return true;
+        }
+
+        inline void WriteFully(std::ostream & output, uint8_t const * data, uint64_t length)
+        {
+            while (length > 0)
+            {
+                const std::size_t chunk = static_cast<std::size_t>(std::min<uint64_t>(length, MaxStreamChunkSize));
+                output.write(reinterpret_cast<char const *>(data), static_cast<std::streamsize>(chunk));
+
+                data += chunk;
+                length -= chunk;
+            }
+        }
+
+        inline void ValidateGLBFileSize(std::size_t totalSize, ReadQuotas const & readQuotas)
+        {
+            if (totalSize > readQuotas.MaxFileSize)
+            {
+                throw invalid_gltf_document("Quota exceeded : file size > MaxFileSize");
+            }
+        }
+
+        inline Span<uint8_t> AllocateData(Buffer & buffer, ReadOptions const & readOptions)
+        {
+            if (readOptions.BufferAllocator)
+            {
+                buffer.externalData = readOptions.BufferAllocator(static_cast<std::size_t>(buffer.byteLength));
+                if (buffer.externalData == nullptr)
+                {
+                    throw std::system_error(std::make_error_code(std::errc::not_enough_memory));
+                }
+
+                buffer.data.clear();
+            }
+            else
+            {
+                buffer.data.resize(static_cast<std::size_t>(buffer.byteLength));
+            }
+
+            return buffer.GetData();
+        }
+
+        inline void MaterializeData(Buffer & buffer, ReadOptions const & readOptions)
+        {
+            std::size_t startPos = 0;
+            if (buffer.uri.find(detail::MimetypeApplicationOctet) == 0)
+            {
+                startPos = std::char_traits<char>::length(detail::MimetypeApplicationOctet) + 1;
+            }
+            else if (buffer.uri.find(detail::MimetypeGLTFBuffer) == 0)
+            {
+                startPos = std::char_traits<char>::length(detail::MimetypeGLTFBuffer) + 1;
+            }
+
+            const std::size_t base64Length = buffer.uri.length() - startPos;
+            const std::size_t decodedEstimate = base64Length / 4 * 3;
+            if (startPos == 0 || (decodedEstimate - 2) > buffer.byteLength) // we need to give room for padding...
+            {
+                throw invalid_gltf_document("Invalid buffer.uri value", "malformed base64");
+            }
+
+            // Allocated storage always spans byteLength, so a shorter payload would leave its tail uninitialized
+            char const * base64Data = &buffer.uri[startPos];
+            const std::size_t decodedLength = base64::detail::GetDecodedLength(base64Data, base64Length);
+            if (readOptions.BufferAllocator && decodedLength < buffer.byteLength)
+            {
+                throw invalid_gltf_document("Invalid buffer.uri value", "malformed base64");
+            }
+
+            // Decode straight into the final storage; only a payload larger than byteLength needs the intermediate copy
+            bool success = false;
+            if (readOptions.BufferAllocator && decodedLength == buffer.byteLength)
+            {
+                const Span<uint8_t> target = detail::AllocateData(buffer, readOptions);
+                success = base64::detail::Decode(base64Data, base64Length, target.data(), target.size());
+            }
+            else
+            {
+                buffer.data.resize(decodedLength);
+                success = base64::detail::Decode(base64Data, base64Length, buffer.data.data(), buffer.data.size());
+                if (success && readOptions.BufferAllocator)
+                {
+                    const std::vector<uint8_t> decoded = std::move(buffer.data);
+                    const Span<uint8_t> target = detail::AllocateData(buffer, readOptions);
+                    std::memcpy(target.data(), decoded.data(), target.size());
+                }
+            }
+
+            if (!success)
+            {
+                throw invalid_gltf_document("Invalid buffer.uri value", "malformed base64");
+            }
+        }
+
+        // Runs function(0) ... function(count - 1) on up to threadCount threads, the calling thread included. No new
+        // indices are started once one fails; the exception of the lowest failing index is rethrown afterwards
+        template <typename TFunction>
+        inline void ParallelFor(std::size_t count, uint32_t threadCount, TFunction && function)
+        {
+            if (threadCount == 0)
+            {
+                threadCount = std::max(std::thread::hardware_concurrency(), 1u);
+            }
+
+            std::vector<std::exception_ptr> errors(count);
+            std::atomic<std::size_t> next{ 0 };
+            auto worker = [&]() {
+                for (std::size_t index = next++; index < count; index = next++)
+                {
+                    try
+                    {
+                        function(index);
+                    }
+                    catch (...)
+                    {
+                        errors[index] = std::current_exception();
+                        next = count;
+                    }
+                }
+            };
+
+            std::vector<std::thread> threads{};
+            const std::size_t extraThreads = count > 1 ? std::min<std::size_t>(threadCount, count) - 1 : 0;
+            threads.reserve(extraThreads);
+            for (std::size_t i = 0; i < extraThreads; i++)
+            {
+                try
+                {
+                    threads.emplace_back(worker);
+                }
+                catch (std::system_error &)
+                {
+                    break; // Carry on with the threads we have...
+                }
+            }
+
+            worker();
+            for (std::thread & thread : threads)
+            {
+                thread.join();
+            }
+
+            for (std::exception_ptr const & error : errors)
+            {
+                if (error != nullptr)
+                {
+                    std::rethrow_exception(error);
+                }
+            }
+        }
+
+        struct ByteRange
+        {
+            uint64_t offset{};
+            uint64_t length{};
+        };
+
+        // Allocates the buffer's storage and lists the reads filling it: the given ranges, or all of it
+        inline std::vector<ResourceRange> AllocateRequests(Buffer & buffer, std::vector<ByteRange> const * ranges, ReadOptions const & readOptions)
+        {
+            const Span<uint8_t> target = detail::AllocateData(buffer, readOptions);
+            if (ranges == nullptr)
+            {
+                return { { 0, target } };
+            }
+
+            std::vector<ResourceRange> requests{};
+            requests.reserve(ranges->size());
+            for (ByteRange const & range : *ranges)
+            {
+                // Ranges past the end are left for GetData to report once the bufferView is used
+                if (range.offset < buffer.byteLength)
+                {
+                    const uint64_t length = std::min(range.length, buffer.byteLength - range.offset);
+                    requests.push_back({ range.offset, target.subspan(static_cast<std::size_t>(range.offset), static_cast<std::size_t>(length)) });
+                }
+            }
+
+            return requests;
+        }
+
+        inline void WaitForResolver(std::future<void> & read, std::string const & uri)
+        {
+            try
+            {
+                if (read.valid())
+                {
+                    read.get();
+                }
+            }
+            catch (...)
+            {
+                std::throw_with_nested(invalid_gltf_document("Invalid buffer.uri value : resolver read failed", uri));
+            }
+        }
+
+        inline void MaterializeFileData(Buffer & buffer, DataContext const & dataContext)
+        {
+            if (dataContext.useMappedFiles)
+            {
+                std::shared_ptr<MappedFile> fileData = std::make_shared<MappedFile>(detail::CreateBufferUriPath(dataContext.bufferRootPath, buffer.uri));
+                if (!fileData->IsOpen() || fileData->size() < buffer.byteLength)
+                {
+                    throw invalid_gltf_document("Invalid buffer.uri value", buffer.uri);
+                }
+
+                buffer.externalData = std::shared_ptr<uint8_t>(fileData, fileData->data());
+            }
+            else
+            {
+                std::ifstream fileData(detail::CreateBufferUriPath(dataContext.bufferRootPath, buffer.uri), std::ios::binary);
+                if (!fileData.good())
+                {
+                    throw invalid_gltf_document("Invalid buffer.uri value", buffer.uri);
+                }
+
+                const Span<uint8_t> target = detail::AllocateData(buffer, dataContext.readOptions);
+                if (!detail::ReadFully(fileData, target.data(), buffer.byteLength))
+                {
+                    throw invalid_gltf_document("Invalid buffer.uri value : file is smaller than buffer.byteLength", buffer.uri);
+                }
+            }
+        }
+
+        // Hands the loaded contents of a scratch buffer over as shared storage
+        inline std::shared_ptr<uint8_t> DetachData(Buffer & buffer)
+        {
+            if (buffer.externalData != nullptr)
+            {
+                return buffer.externalData;
+            }
+
+            std::shared_ptr<std::vector<uint8_t>> data = std::make_shared<std::vector<uint8_t>>(std::move(buffer.data));
+            return std::shared_ptr<uint8_t>(data, data->data());
+        }
+
+        // Loads an embedded or external buffer; these do not share any state and may run concurrently
+        inline void MaterializeUriData(Buffer & buffer, DataContext const & dataContext)
+        {
+            if (buffer.IsEmbeddedResource())
+            {
+                detail::MaterializeData(buffer, dataContext.readOptions);
+            }
+            else if (dataContext.readOptions.Resolver != nullptr)
+            {
+                std::future<void> read = dataContext.readOptions.Resolver->Read(buffer.uri, detail::AllocateRequests(buffer, nullptr, dataContext.readOptions));
+                detail::WaitForResolver(read, buffer.uri);
+            }
+            else if (dataContext.readOptions.BufferCache != nullptr)
+            {
+                buffer.externalData = dataContext.readOptions.BufferCache->GetOrLoad(
+                    detail::CreateBufferUriPath(dataContext.bufferRootPath, buffer.uri), buffer.byteLength, [&buffer, &dataContext]() {
+                        Buffer loaded{};
+                        loaded.byteLength = buffer.byteLength;
+                        loaded.uri = buffer.uri;
+                        detail::MaterializeFileData(loaded, dataContext);
+
+                        return detail::DetachData(loaded);
+                    });
+                buffer.data.clear();
+            }
+            else
+            {
+                detail::MaterializeFileData(buffer, dataContext);
+            }
+        }
+
+        template <typename TElement>
+        inline TElement const * FindElement(std::vector<TElement> const & elements, int64_t index) noexcept
+        {
+            return index >= 0 && static_cast<uint64_t>(index) < elements.size() ? &elements[static_cast<std::size_t>(index)] : nullptr;
+        }
+
+        // Marks the bufferViews reachable from a scene: mesh indices, attributes and morph targets, skin matrices,
+        // the animations of its nodes and the images of the materials used. Dangling references are skipped.
+        inline std::vector<bool> GetSceneBufferViews(Document const & document, std::size_t sceneIndex)
+        {
+            if (sceneIndex >= document.scenes.size())
+            {
+                throw invalid_gltf_document("Invalid scene index");
+            }
+
+            std::vector<bool> bufferViews(document.bufferViews.size());
+            auto markBufferView = [&bufferViews](int64_t bufferView) {
+                if (bufferView >= 0 && static_cast<uint64_t>(bufferView) < bufferViews.size())
+                {
+                    bufferViews[static_cast<std::size_t>(bufferView)] = true;
+                }
+            };
+
+            auto markAccessor = [&](int64_t accessorIndex) {
+                if (Accessor const * accessor = FindElement(document.accessors, accessorIndex))
+                {
+                    markBufferView(accessor->bufferView);
+                    if (!accessor->sparse.empty())
+                    {
+                        markBufferView(accessor->sparse.indices.bufferView);
+                        markBufferView(accessor->sparse.values.bufferView);
+                    }
+                }
+            };
+
+            auto markTexture = [&](Material::Texture const & textureInfo) {
+                if (Texture const * texture = FindElement(document.textures, textureInfo.index))
+                {
+                    Image const * image = FindElement(document.images, texture->source);
+                    if (image != nullptr && image->uri.empty())
+                    {
+                        markBufferView(image->bufferView);
+                    }
+                }
+            };
+
+            std::vector<bool> nodes(document.nodes.size());
+            std::vector<uint32_t> pending(document.scenes[sceneIndex].nodes);
+            while (!pending.empty())
+            {
+                const uint32_t nodeIndex = pending.back();
+                pending.pop_back();
+                if (nodeIndex >= nodes.size() || nodes[nodeIndex])
+                {
+                    continue;
+                }
+
+                nodes[nodeIndex] = true;
+                Node const & node = document.nodes[nodeIndex];
+                if (Mesh const * mesh = FindElement(document.meshes, node.mesh))
+                {
+                    for (Primitive const & primitive : mesh->primitives)
+                    {
+                        markAccessor(primitive.indices);
+                        for (auto const & attribute : primitive.attributes)
+                        {
+                            markAccessor(attribute.second);
+                        }
+
+                        for (Attributes const & target : primitive.targets)
+                        {
+                            for (auto const & attribute : target)
+                            {
+                                markAccessor(attribute.second);
+                            }
+                        }
+
+                        if (Material const * material = FindElement(document.materials, primitive.material))
+                        {
+                            markTexture(material->pbrMetallicRoughness.baseColorTexture);
+                            markTexture(material->pbrMetallicRoughness.metallicRoughnessTexture);
+                            markTexture(material->normalTexture);
+                            markTexture(material->occlusionTexture);
+                            markTexture(material->emissiveTexture);
+                        }
+                    }
+                }
+
+                if (Skin const * skin = FindElement(document.skins, node.skin))
+                {
+                    markAccessor(skin->inverseBindMatrices);
+                }
+
+                pending.insert(pending.end(), node.children.begin(), node.children.end());
+            }
+
+            for (Animation const & animation : document.animations)
+            {
+                for (Animation::Channel const & channel : animation.channels)
+                {
+                    Animation::Sampler const * sampler = FindElement(animation.samplers, channel.sampler);
+                    if (sampler != nullptr && channel.target.node >= 0 && static_cast<std::size_t>(channel.target.node) < nodes.size() &&
+                        nodes[static_cast<std::size_t>(channel.target.node)])
+                    {
+                        markAccessor(sampler->input);
+                        markAccessor(sampler->output);
+                    }
+                }
+            }
+
+            return bufferViews;
+        }
+
+        // The byte ranges of every buffer used by the ReadOptions::PartialLoadScene, sorted and coalesced. Empty when
+        // no partial load was requested.
+        inline std::vector<std::vector<ByteRange>> GetPartialLoadRanges(Document const & document, ReadOptions const & readOptions)
+        {
+            std::vector<std::vector<ByteRange>> ranges{};
+            if (readOptions.PartialLoadScene < 0)
+            {
+                return ranges;
+            }
+
+            const std::vector<bool> used = GetSceneBufferViews(document, static_cast<std::size_t>(readOptions.PartialLoadScene));
+            ranges.resize(document.buffers.size());
+            for (std::size_t bufferViewIndex = 0; bufferViewIndex < used.size(); bufferViewIndex++)
+            {
+                BufferView const & bufferView = document.bufferViews[bufferViewIndex];
+                if (used[bufferViewIndex] && bufferView.buffer >= 0 && static_cast<std::size_t>(bufferView.buffer) < ranges.size() && bufferView.byteLength != 0)
+                {
+                    ranges[static_cast<std::size_t>(bufferView.buffer)].push_back({ bufferView.byteOffset, bufferView.byteLength });
+                }
+            }
+
+            for (std::vector<ByteRange> & bufferRanges : ranges)
+            {
+                std::sort(bufferRanges.begin(), bufferRanges.end(), [](ByteRange const & a, ByteRange const & b) { return a.offset < b.offset; });
+
+                std::size_t merged = 0;
+                for (std::size_t i = 1; i < bufferRanges.size(); i++)
+                {
+                    ByteRange & last = bufferRanges[merged];
+                    const uint64_t lastEnd = last.offset + last.length;
+                    if (bufferRanges[i].offset <= lastEnd || bufferRanges[i].offset - lastEnd <= readOptions.PartialLoadMaxGap)
+                    {
+                        last.length = std::max(lastEnd, bufferRanges[i].offset + bufferRanges[i].length) - last.offset;
+                    }
+                    else
+                    {
+                        bufferRanges[++merged] = bufferRanges[i];
+                    }
+                }
+
+                if (!bufferRanges.empty())
+                {
+                    bufferRanges.resize(merged + 1);
+                }
+            }
+
+            return ranges;
+        }
+
+        // Reads only the given ranges of an external buffer. Embedded and memory mapped buffers gain nothing from
+        // this and are loaded in full.
+        inline void MaterializeRanges(Buffer & buffer, std::vector<ByteRange> const & ranges, DataContext const & dataContext)
+        {
+            if (buffer.IsEmbeddedResource() || (dataContext.useMappedFiles && dataContext.readOptions.Resolver == nullptr))
+            {
+                detail::MaterializeUriData(buffer, dataContext);
+                return;
+            }
+
+            const std::vector<ResourceRange> requests = detail::AllocateRequests(buffer, &ranges, dataContext.readOptions);
+            if (dataContext.readOptions.Resolver != nullptr)
+            {
+                std::future<void> read = dataContext.readOptions.Resolver->Read(buffer.uri, requests);
+                detail::WaitForResolver(read, buffer.uri);
+                return;
+            }
+
+            std::ifstream fileData(detail::CreateBufferUriPath(dataContext.bufferRootPath, buffer.uri), std::ios::binary);
+            if (!fileData.good())
+            {
+                throw invalid_gltf_document("Invalid buffer.uri value", buffer.uri);
+            }
+
+            for (ResourceRange const & request : requests)
+            {
+                if (!fileData.seekg(static_cast<std::streamoff>(request.offset)) || !detail::ReadFully(fileData, request.target.data(), request.target.size()))
+                {
+                    throw invalid_gltf_document("Invalid buffer.uri value : file is smaller than buffer.byteLength", buffer.uri);
+                }
+            }
+        }
+
+        inline void MaterializeUriBuffer(std::vector<Buffer> & buffers, std::size_t bufferIndex, std::vector<std::vector<ByteRange>> const & ranges, DataContext const & dataContext)
+        {
+            if (ranges.empty())
+            {
+                detail::MaterializeUriData(buffers[bufferIndex], dataContext);
+            }
+            else
+            {
+                detail::MaterializeRanges(buffers[bufferIndex], ranges[bufferIndex], dataContext);
+            }
+        }
+
+        inline std::shared_ptr<DeferredData> DeferUriData(DataContext const & dataContext)
+        {
+            DataContext loadContext{ dataContext.bufferRootPath, dataContext.readQuotas, dataContext.readOptions };
+            loadContext.useMappedFiles = dataContext.useMappedFiles;
+
+            return std::make_shared<DeferredData>([loadContext](Buffer const & buffer) {
+                Buffer loaded{};
+                loaded.byteLength = buffer.byteLength;
+                loaded.uri = buffer.uri;
+                detail::MaterializeUriData(loaded, loadContext);
+
+                return detail::DetachData(loaded);
+            });
+        }
+
+        inline std::shared_ptr<DeferredData> DeferBinaryData(DataContext const & dataContext)
+        {
+            const FX_GLTF_FILESYSTEM::path filePath = dataContext.binaryFilePath;
+            const std::size_t offset = dataContext.binaryFileOffset;
+            const ReadOptions readOptions = dataContext.readOptions;
+
+            return std::make_shared<DeferredData>([filePath, offset, readOptions](Buffer const & buffer) {
+                std::ifstream fileData(filePath, std::ios::binary);
+                if (!fileData.seekg(static_cast<std::streamoff>(offset)))
+                {
+                    throw invalid_gltf_document("Invalid GLB buffer data");
+                }
+
+                Buffer loaded{};
+                loaded.byteLength = buffer.byteLength;
+                const Span<uint8_t> target = detail::AllocateData(loaded, readOptions);
+                if (!detail::ReadFully(fileData, target.data(), buffer.byteLength))
+                {
+                    throw invalid_gltf_document("Invalid GLB buffer data");
+                }
+
+                return detail::DetachData(loaded);
+            });
+        }
+
+        // Validates every buffer and hands out the GLB BIN chunk. The buffers with a uri are left for the caller to
+        // load with MaterializeUriData; their indices are returned
+        inline std::vector<std::size_t> PrepareBuffers(Document & document, DataContext const & dataContext)
+        {
+            if (document.buffers.size() > dataContext.readQuotas.MaxBufferCount)
+            {
+                throw invalid_gltf_document("Quota exceeded : number of buffers > MaxBufferCount");
+            }
+
+            std::vector<std::size_t> uriBuffers{};
+            for (std::size_t bufferIndex = 0; bufferIndex < document.buffers.size(); bufferIndex++)
+            {
+                Buffer & buffer = document.buffers[bufferIndex];
+                if (buffer.byteLength == 0)
+                {
+                    throw invalid_gltf_document("Invalid buffer.byteLength value : 0");
+                }
+
+                if (buffer.byteLength > dataContext.readQuotas.MaxBufferByteLength)
+                {
+                    throw invalid_gltf_document("Quota exceeded : buffer.byteLength > MaxBufferByteLength");
+                }
+
+                if (buffer.byteLength > std::numeric_limits<std::size_t>::max())
+                {
+                    throw invalid_gltf_document("Invalid buffer.byteLength value : exceeds the address space");
+                }
+
+                if (!buffer.uri.empty())
+                {
+                    if (dataContext.readOptions.DeferBufferData)
+                    {
+                        buffer.deferredData = detail::DeferUriData(dataContext);
+                    }
+                    else
+                    {
+                        uriBuffers.push_back(bufferIndex);
+                    }
+                }
+                else if (dataContext.binaryData != nullptr)
+                {
+                    std::vector<uint8_t> & binary = *dataContext.binaryData;
+                    if (binary.size() < buffer.byteLength)
+                    {
+                        throw invalid_gltf_document("Invalid GLB buffer data");
+                    }
+
+                    // Take ownership of the BIN chunk rather than copying it. Trimming the chunk padding
+                    // with a smaller resize does not reallocate...
+                    buffer.data = std::move(binary);
+                    buffer.data.resize(static_cast<std::size_t>(buffer.byteLength));
+                }
+                else if (dataContext.binaryStorage != nullptr)
+                {
+                    if (dataContext.binaryStorageLength < buffer.byteLength)
+                    {
+                        throw invalid_gltf_document("Invalid GLB buffer data");
+                    }
+
+                    buffer.externalData = dataContext.binaryStorage;
+                }
+                else if (!dataContext.binaryFilePath.empty())
+                {
+                    if (dataContext.binaryStorageLength < buffer.byteLength)
+                    {
+                        throw invalid_gltf_document("Invalid GLB buffer data");
+                    }
+
+                    buffer.deferredData = detail::DeferBinaryData(dataContext);
+                }
+            }
+
+            return uriBuffers;
+        }
+
+        // Hands every external read to the resolver before waiting on any, decoding the embedded buffers meanwhile
+        inline void ResolveBuffers(Document & document, std::vector<std::size_t> const & uriBuffers, std::vector<std::vector<ByteRange>> const & ranges, DataContext const & dataContext)
+        {
+            std::vector<std::size_t> embeddedBuffers{};
+            std::vector<std::pair<std::size_t, std::future<void>>> reads{};
+            std::exception_ptr error{};
+            try
+            {
+                for (const std::size_t bufferIndex : uriBuffers)
+                {
+                    Buffer & buffer = document.buffers[bufferIndex];
+                    if (buffer.IsEmbeddedResource())
+                    {
+                        embeddedBuffers.push_back(bufferIndex);
+                        continue;
+                    }
+
+                    const std::vector<ResourceRange> requests = detail::AllocateRequests(buffer, ranges.empty() ? nullptr : &ranges[bufferIndex], dataContext.readOptions);
+                    reads.emplace_back(bufferIndex, dataContext.readOptions.Resolver->Read(buffer.uri, requests));
+                }
+
+                detail::ParallelFor(embeddedBuffers.size(), dataContext.readOptions.MaxThreadCount, [&](std::size_t index) {
+                    detail::MaterializeData(document.buffers[embeddedBuffers[index]], dataContext.readOptions);
+                });
+            }
+            catch (...)
+            {
+                error = std::current_exception();
+            }
+
+            // The reads target the document's buffers; every one must finish before anything is reported
+            for (std::pair<std::size_t, std::future<void>> & read : reads)
+            {
+                try
+                {
+                    detail::WaitForResolver(read.second, document.buffers[read.first].uri);
+                }
+                catch (...)
+                {
+                    if (error == nullptr)
+                    {
+                        error = std::current_exception();
+                    }
+                }
+            }
+
+            if (error != nullptr)
+            {
+                std::rethrow_exception(error);
+            }
+        }
+
+        inline void MaterializeBuffers(Document & document, DataContext const & dataContext)
+        {
+            const std::vector<std::size_t> uriBuffers = detail::PrepareBuffers(document, dataContext);
+            const std::vector<std::vector<ByteRange>> ranges = detail::GetPartialLoadRanges(document, dataContext.readOptions);
+            if (dataContext.readOptions.Resolver != nullptr)
+            {
+                detail::ResolveBuffers(document, uriBuffers, ranges, dataContext);
+                return;
+            }
+
+            detail::ParallelFor(uriBuffers.size(), dataContext.readOptions.MaxThreadCount, [&](std::size_t index) {
+                detail::MaterializeUriBuffer(document.buffers, uriBuffers[index], ranges, dataContext);
+            });
+        }
+
+        inline Document Create(nlohmann::json const & json, DataContext const & dataContext)
+        {
+            Document document = json;
+            detail::MaterializeBuffers(document, dataContext);
+
+            return document;
+        }
+
+        // With a streamed BIN chunk, the first buffer only describes the chunk and needs no data
+        inline void ValidateBuffers(Document const & document, bool useBinaryFormat, bool streamedBinaryChunk = false)
+        {
+            if (document.buffers.empty())
+            {
+                throw invalid_gltf_document("Invalid glTF document. A document must have at least 1 buffer.");
+            }
+
+            bool foundBinaryBuffer = false;
+            for (std::size_t bufferIndex = 0; bufferIndex < document.buffers.size(); bufferIndex++)
+            {
+                Buffer const & buffer = document.buffers[bufferIndex];
+                if (buffer.byteLength == 0)
+                {
+                    throw invalid_gltf_document("Invalid buffer.byteLength value : 0");
+                }
+
+                if (!(streamedBinaryChunk && bufferIndex == 0) && buffer.byteLength != buffer.GetData().size())
+                {
+                    throw invalid_gltf_document("Invalid buffer.byteLength value : does not match buffer.data size");
+                }
+
+                if (buffer.uri.empty())
+                {
+                    foundBinaryBuffer = true;
+                    if (bufferIndex != 0)
+                    {
+                        throw invalid_gltf_document("Invalid glTF document. Only 1 buffer, the very first, is allowed to have an empty buffer.uri field.");
+                    }
+                }
+            }
+
+            if (useBinaryFormat && !foundBinaryBuffer)
+            {
+                throw invalid_gltf_document("Invalid glTF document. No buffer found which can meet the criteria for saving to a .glb file.");
+            }
+        }
+
+        // Keeps track of the size of everything written to it, discarding it or passing it on to `target`
+        class CountingStreamBuffer : public std::streambuf
+        {
+        public:
+            CountingStreamBuffer() noexcept = default;
+
+            explicit CountingStreamBuffer(std::streambuf * target) noexcept
+                : m_target(target)
+            {
+            }
+
+            FX_GLTF_NODISCARD std::size_t size() const noexcept
+            {
+                return m_size;
+            }
+
+        protected:
+            std::streamsize xsputn(char const * data, std::streamsize count) override
+            {
+                if (m_target != nullptr)
+                {
+                    count = m_target->sputn(data, count);
+                }
+
+                m_size += static_cast<std::size_t>(count);
+                return count;
+            }
+
+            int_type overflow(int_type c) override
+            {
+                if (!traits_type::eq_int_type(c, traits_type::eof()))
+                {
+                    if (m_target != nullptr && traits_type::eq_int_type(m_target->sputc(traits_type::to_char_type(c)), traits_type::eof()))
+                    {
+                        return traits_type::eof();
+                    }
+
+                    m_size++;
+                }
+
+                return traits_type::not_eof(c);
+            }
+
+        private:
+            std::streambuf * m_target{};
+            std::size_t m_size{};
+        };
+
+        inline void WriteBinaryChunkPart(std::ostream & output, BinaryChunkPart const & part)
+        {
+            if (!part.write)
+            {
+                detail::WriteFully(output, part.data.data(), part.data.size());
+                return;
+            }
+
+            CountingStreamBuffer counter(output.rdbuf());
+            std::ostream partStream(&counter);
+            part.write(partStream);
+            if (!partStream.good() || counter.size() != part.byteLength)
+            {
+                throw invalid_gltf_document("Invalid binary chunk part : written size does not match byteLength");
+            }
+        }
+
+        // Elements reduced per work item of ComputeBounds: enough to amortize the threading, few enough for the
+        // converted values to stay in cache
+        constexpr std::size_t BoundsChunkSize = 16 * 1024;
+
+        // The overridden element indices of a sparse accessor, in increasing order, and their values as stored
+        struct SparseFloats
+        {
+            std::vector<uint32_t> indices{};
+            std::vector<float> values{};
+        };
+
+        inline SparseFloats ReadSparseFloats(Document const & document, Accessor const & accessor)
+        {
+            SparseFloats sparse{};
+            if (accessor.sparse.empty())
+            {
+                return sparse;
+            }
+
+            Accessor indices{};
+            Accessor values{};
+            GetSparseAccessors(accessor, indices, values);
+            values.normalized = false;
+
+            const uint32_t componentCount = GetComponentCount(accessor.type);
+            std::vector<uint32_t> unorderedIndices(indices.count);
+            std::vector<float> unorderedValues(static_cast<std::size_t>(values.count) * componentCount);
+            ConvertToUInt32(document, indices, { unorderedIndices.data(), unorderedIndices.size() });
+            ConvertToFloat(document, values, { unorderedValues.data(), unorderedValues.size() });
+
+            std::vector<std::size_t> order(unorderedIndices.size());
+            std::iota(order.begin(), order.end(), std::size_t{});
+            std::sort(order.begin(), order.end(), [&](std::size_t a, std::size_t b) { return unorderedIndices[a] < unorderedIndices[b]; });
+
+            sparse.indices.resize(order.size());
+            sparse.values.resize(unorderedValues.size());
+            for (std::size_t i = 0; i < order.size(); i++)
+            {
+                sparse.indices[i] = unorderedIndices[order[i]];
+                if (sparse.indices[i] >= accessor.count || (i > 0 && sparse.indices[i] == sparse.indices[i - 1]))
+                {
+                    throw invalid_gltf_document("Invalid accessor.sparse.indices value");
+                }
+
+                std::copy_n(&unorderedValues[order[i] * componentCount], componentCount, &sparse.values[i * componentCount]);
+            }
+
+            return sparse;
+        }
+
+        // Reads elements [first, first + count) as stored, i.e. ignoring accessor.normalized, with the sparse values
+        // which fall in that range applied
+        inline void ReadBoundsChunk(AccessorLayout const & layout, Accessor const & accessor, SparseFloats const & sparse, std::size_t first, std::size_t count, float * target)
+        {
+            const uint32_t componentCount = GetComponentCount(accessor.type);
+            if (layout.data == nullptr)
+            {
+                std::fill(target, target + count * componentCount, 0.0f);
+            }
+            else if (layout.packed)
+            {
+                ConvertComponents(layout.data + first * layout.stride, accessor.componentType, false, target, count * componentCount);
+            }
+            else
+            {
+                const uint32_t componentSize = GetComponentSize(accessor.componentType);
+                for (std::size_t i = 0; i < count; i++)
+                {
+                    uint8_t const * element = layout.data + (first + i) * layout.stride;
+                    for (uint32_t c = 0; c < componentCount; c++)
+                    {
+                        target[i * componentCount + c] =
+                            ReadComponent<float>(element + GetComponentOffset(accessor.type, componentSize, c), accessor.componentType, false);
+                    }
+                }
+            }
+
+            for (auto index = std::lower_bound(sparse.indices.begin(), sparse.indices.end(), first); index != sparse.indices.end() && *index < first + count; ++index)
+            {
+                const std::size_t s = static_cast<std::size_t>(index - sparse.indices.begin());
+                std::copy_n(&sparse.values[s * componentCount], componentCount, target + (*index - first) * componentCount);
+            }
+        }
+
+        // Splits every accessor into chunks of BoundsChunkSize elements, reduces them with the SIMD kernels on up to
+        // maxThreadCount threads and merges the chunk bounds per accessor
+        inline std::vector<AccessorBounds> ComputeBounds(Document const & document, Span<Accessor const> accessors, uint32_t maxThreadCount)
+        {
+            struct Chunk
+            {
+                std::size_t accessor{};
+                std::size_t first{};
+                std::size_t bounds{};
+            };
+
+            std::vector<AccessorLayout> layouts(accessors.size());
+            std::vector<SparseFloats> sparse(accessors.size());
+            std::vector<Chunk> chunks{};
+            std::size_t boundsSize = 0;
+            for (std::size_t a = 0; a < accessors.size(); a++)
+            {
+                layouts[a] = GetAccessorLayout(document, accessors[a]);
+                sparse[a] = ReadSparseFloats(document, accessors[a]);
+                for (std::size_t first = 0; first < accessors[a].count; first += BoundsChunkSize)
+                {
+                    chunks.push_back({ a, first, boundsSize });
+                    boundsSize += GetComponentCount(accessors[a].type);
+                }
+            }
+
+            std::vector<float> chunkLow(boundsSize, (std::numeric_limits<float>::max)());
+            std::vector<float> chunkHigh(boundsSize, std::numeric_limits<float>::lowest());
+            ParallelFor(chunks.size(), maxThreadCount, [&](std::size_t index) {
+                Chunk const & chunk = chunks[index];
+                Accessor const & accessor = accessors[chunk.accessor];
+                const uint32_t componentCount = GetComponentCount(accessor.type);
+                const std::size_t count = (std::min)(BoundsChunkSize, accessor.count - chunk.first);
+
+                std::vector<float> values(count * componentCount);
+                ReadBoundsChunk(layouts[chunk.accessor], accessor, sparse[chunk.accessor], chunk.first, count, values.data());
+                MinMaxComponents(values.data(), values.size(), componentCount, &chunkLow[chunk.bounds], &chunkHigh[chunk.bounds]);
+            });
+
+            std::vector<AccessorBounds> bounds(accessors.size());
+            for (Chunk const & chunk : chunks)
+            {
+                AccessorBounds & accessorBounds = bounds[chunk.accessor];
+                const uint32_t componentCount = GetComponentCount(accessors[chunk.accessor].type);
+                if (chunk.first == 0)
+                {
+                    accessorBounds.min.assign(&chunkLow[chunk.bounds], &chunkLow[chunk.bounds] + componentCount);
+                    accessorBounds.max.assign(&chunkHigh[chunk.bounds], &chunkHigh[chunk.bounds] + componentCount);
+                    continue;
+                }
+
+                for (uint32_t c = 0; c < componentCount; c++)
+                {
+                    accessorBounds.min[c] = (std::min)(accessorBounds.min[c], chunkLow[chunk.bounds + c]);
+                    accessorBounds.max[c] = (std::max)(accessorBounds.max[c], chunkHigh[chunk.bounds + c]);
+                }
+            }
+
+            return bounds;
+        }
+
+        inline void WriteJson(JsonWriter & writer, Document const & document, std::vector<Accessor> const & accessors)
+        {
+            writer.StartObject();
+            detail::WriteDocument(writer, document, accessors);
+            writer.EndObject();
+            writer.Flush();
+        }
+
+        inline void WriteJson(Document const & document, std::vector<Accessor> const & accessors, std::ostream & output, int indent)
+        {
+            JsonWriter writer(output, indent);
+            detail::WriteJson(writer, document, accessors);
+        }
+
+        // The length of the compact text written by WriteJson, without encoding any embedded-on-save buffers
+        inline std::size_t MeasureJson(Document const & document, std::vector<Accessor> const & accessors)
+        {
+            CountingStreamBuffer counter{};
+            std::ostream counterStream(&counter);
+            JsonWriter writer(counterStream, -1, true);
+            detail::WriteJson(writer, document, accessors);
+            return counter.size() + writer.OmittedLength();
+        }
+
+        // The BIN chunk of a .glb is taken from `binaryChunk` when given, else from the first buffer
+        inline void Save(
+            Document const & document, std::ostream & output, FX_GLTF_FILESYSTEM::path const & documentRootPath, bool useBinaryFormat, SaveOptions const & saveOptions, std::vector<BinaryChunkPart> const * binaryChunk = nullptr)
+        {
+            // There is no way to check if an ostream has been opened in binary mode or not. Just checking
+            // if it's "good" is the best we can do from here...
+            detail::ThrowIfBad(output);
+
+            // Refreshed bounds go into a copy of the accessors only; the document stays const
+            std::vector<Accessor> refreshedAccessors{};
+            if (saveOptions.RefreshBounds)
+            {
+                std::vector<AccessorBounds> bounds = detail::ComputeBounds(document, { document.accessors.data(), document.accessors.size() }, saveOptions.MaxThreadCount);
+                refreshedAccessors = document.accessors;
+                for (std::size_t i = 0; i < refreshedAccessors.size(); i++)
+                {
+                    refreshedAccessors[i].min = std::move(bounds[i].min);
+                    refreshedAccessors[i].max = std::move(bounds[i].max);
+                }
+            }
+
+            std::vector<Accessor> const & accessors = saveOptions.RefreshBounds ? refreshedAccessors : document.accessors;
+
+            std::size_t externalBufferIndex = 0;
+            if (useBinaryFormat)
+            {
+                detail::GLBHeader header{ detail::GLBHeaderMagic, 2, 0, { 0, detail::GLBChunkJSON } };
+                detail::ChunkHeader binHeader{ 0, detail::GLBChunkBIN };
+
+                // The JSON chunk length is needed up front. Rather than holding the text in memory, it is measured
+                // with a first pass which discards the output...
+                const std::size_t measuredLength = detail::MeasureJson(document, accessors);
+
+                std::vector<BinaryChunkPart> bufferChunk{};
+                if (binaryChunk == nullptr)
+                {
+                    bufferChunk.push_back({ document.buffers.front().GetData() });
+                }
+
+                std::vector<BinaryChunkPart> const & parts = binaryChunk != nullptr ? *binaryChunk : bufferChunk;
+
+                uint64_t totalLength = 0;
+                for (BinaryChunkPart const & part : parts)
+                {
+                    totalLength += part.size();
+                }
+
+                if (totalLength != document.buffers.front().byteLength)
+                {
+                    throw invalid_gltf_document("Invalid buffer.byteLength value : does not match the binary chunk size");
+                }
+
+                // Unlike external buffers, the GLB container is limited to 32-bit lengths
+                if (static_cast<uint64_t>(detail::HeaderSize) + measuredLength + detail::ChunkHeaderSize + totalLength + 6 > std::numeric_limits<uint32_t>::max())
+                {
+                    throw invalid_gltf_document("Invalid glTF document. Too large for a .glb file; save the first buffer externally instead.");
+                }
+
+                const uint32_t binLength = static_cast<uint32_t>(totalLength);
+                const uint32_t binPaddedLength = ((binLength + 3) & (~3u));
+                const uint32_t binPadding = binPaddedLength - binLength;
+                binHeader.chunkLength = binPaddedLength;
+
+                const uint32_t jsonLength = static_cast<uint32_t>(measuredLength);
+
+                header.jsonHeader.chunkLength = ((jsonLength + 3) & (~3u));
+                const uint32_t headerPadding = static_cast<uint32_t>(header.jsonHeader.chunkLength - jsonLength);
+                header.length = detail::HeaderSize + header.jsonHeader.chunkLength + detail::ChunkHeaderSize + binHeader.chunkLength;
+
+                constexpr std::array<char, 3> spaces = { ' ', ' ', ' ' };
+                constexpr std::array<char, 3> nulls = { 0, 0, 0 };
+
+                output.write(reinterpret_cast<char *>(&header), detail::HeaderSize);
+                detail::WriteJson(document, accessors, output, -1);
+                output.write(&spaces[0], headerPadding);
+                output.write(reinterpret_cast<char *>(&binHeader), detail::ChunkHeaderSize);
+                for (BinaryChunkPart const & part : parts)
+                {
+                    detail::WriteBinaryChunkPart(output, part);
+                }
+
+                output.write(&nulls[0], binPadding);
+
+                externalBufferIndex = 1;
+            }
+            else
+            {
+                detail::WriteJson(document, accessors, output, 2);
+            }
+
+            // The glTF 2.0 spec allows a document to have more than 1 buffer. However, only the first one will be included in the .glb
+            // All others must be considered as External/Embedded resources. Process them if necessary...
+            for (; externalBufferIndex < document.buffers.size(); externalBufferIndex++)
+            {
+                Buffer const & buffer = document.buffers[externalBufferIndex];
+                if (!buffer.IsEmbeddedResource() && saveOptions.Resolver != nullptr)
+                {
+                    saveOptions.Resolver->Write(buffer.uri, buffer.GetData());
+                }
+                else if (!buffer.IsEmbeddedResource())
+                {
+                    std::ofstream fileData(detail::CreateBufferUriPath(documentRootPath, buffer.uri), std::ios::binary);
+                    if (!fileData.good())
+                    {
+                        throw invalid_gltf_document("Invalid buffer.uri value", buffer.uri);
+                    }
+
+                    detail::WriteFully(fileData, buffer.GetData().data(), buffer.byteLength);
+                }
+            }
+        }
+
+        // Reads the GLB header, the JSON chunk and the BIN chunk header, leaving the stream at the start of the BIN
+        // chunk payload. binaryOffset receives the offset of that payload from the start of the GLB
+        inline Document ReadBinaryJson(std::istream & input, ReadQuotas const & readQuotas, ChunkHeader & binHeader, std::size_t & binaryOffset)
+        {
+            detail::GLBHeader header{};
+            detail::ThrowIfBad(input.read(reinterpret_cast<char *>(&header), detail::HeaderSize));
+            detail::ValidateGLBHeader(header);
+
+            std::vector<uint8_t> json{};
+            json.resize(header.jsonHeader.chunkLength);
+            detail::ThrowIfBad(input.read(reinterpret_cast<char *>(&json[0]), header.jsonHeader.chunkLength));
+
+            const std::size_t totalSize = detail::HeaderSize + header.jsonHeader.chunkLength;
+            detail::ValidateGLBFileSize(totalSize, readQuotas);
+
+            detail::ThrowIfBad(input.read(reinterpret_cast<char *>(&binHeader), detail::ChunkHeaderSize));
+            if (binHeader.chunkType != detail::GLBChunkBIN)
+            {
+                throw invalid_gltf_document("Invalid GLB header");
+            }
+
+            binaryOffset = totalSize + detail::ChunkHeaderSize;
+            detail::ValidateGLBFileSize(binaryOffset + binHeader.chunkLength, readQuotas);
+
+            return detail::ParseDocument(json.data(), json.data() + json.size());
+        }
+
+        // Reads the GLB header, JSON and BIN chunks. The BIN chunk is placed in `binary`, or in storage from the
+        // BufferAllocator, and referenced from the data context for PrepareBuffers
+        inline Document ReadBinary(std::istream & input, DataContext & dataContext, std::vector<uint8_t> & binary)
+        {
+            detail::ChunkHeader binHeader{};
+            std::size_t binaryOffset{};
+            Document document = detail::ReadBinaryJson(input, dataContext.readQuotas, binHeader, binaryOffset);
+
+            if (dataContext.readOptions.DeferBufferData && !dataContext.binaryFilePath.empty())
+            {
+                // Only remember where the BIN chunk lives; it is read from the file on first use...
+                dataContext.binaryFileOffset = binaryOffset;
+                dataContext.binaryStorageLength = binHeader.chunkLength;
+            }
+            else if (dataContext.readOptions.BufferAllocator)
+            {
+                // Read the BIN chunk directly into application provided storage...
+                dataContext.binaryStorage = dataContext.readOptions.BufferAllocator(binHeader.chunkLength);
+                if (dataContext.binaryStorage == nullptr)
+                {
+                    throw std::system_error(std::make_error_code(std::errc::not_enough_memory));
+                }
+
+                dataContext.binaryStorageLength = binHeader.chunkLength;
+                detail::ThrowIfBad(input.read(reinterpret_cast<char *>(dataContext.binaryStorage.get()), binHeader.chunkLength));
+            }
+            else
+            {
+                binary.resize(binHeader.chunkLength);
+                detail::ThrowIfBad(input.read(reinterpret_cast<char *>(&binary[0]), binHeader.chunkLength));
+                dataContext.binaryData = &binary;
+            }
+
+            return document;
+        }
+
+        inline Document LoadBinary(std::istream & input, DataContext & dataContext)
+        {
+            try
+            {
+                std::vector<uint8_t> binary{};
+                Document document = detail::ReadBinary(input, dataContext, binary);
+                detail::MaterializeBuffers(document, dataContext);
+
+                return document;
+            }
+            catch (invalid_gltf_document &)
+            {
+                throw;
+            }
+            catch (std::system_error &)
+            {
+                throw;
+            }
+            catch (...)
+            {
+                std::throw_with_nested(invalid_gltf_document("Invalid glTF document. See nested exception for details."));
+            }
+        }
+    } // namespace detail
+
+    // The result of a header-only load: the document structure without any buffer contents, and for a GLB where
+    // its BIN chunk payload lives. The chunk offset is relative to the start of the GLB.
+    struct DocumentHeader
+    {
+        Document document{};
+
+        std::size_t binaryChunkOffset{};
+        uint32_t binaryChunkLength{};
+    };
+
+    // A document whose buffers are still loading in the background. The structure is complete; buffer data must
+    // only be used once that buffer's future is ready. document.buffers itself must not be resized meanwhile, and
+    // destroying the AsyncDocument waits for the outstanding loads. The document lives on the heap, shared with the
+    // loader thread, so the AsyncDocument may be moved while loads are running.
+    class AsyncDocument
+    {
+    public:
+        AsyncDocument() = default;
+
+        AsyncDocument(Document && document, detail::DataContext const & dataContext)
+            : m_document(std::make_shared<Document>(std::move(document)))
+        {
+            const std::vector<std::size_t> uriBuffers = detail::PrepareBuffers(*m_document, dataContext);
+
+            // Buffers without a uri (GLB BIN chunk) are complete already...
+            std::vector<std::promise<void>> promises(m_document->buffers.size());
+            m_buffers.reserve(promises.size());
+            for (std::promise<void> & promise : promises)
+            {
+                m_buffers.push_back(promise.get_future().share());
+            }
+
+            std::vector<std::promise<void>> pending{};
+            pending.reserve(uriBuffers.size());
+            std::size_t next = 0;
+            for (std::size_t bufferIndex = 0; bufferIndex < promises.size(); bufferIndex++)
+            {
+                if (next < uriBuffers.size() && uriBuffers[next] == bufferIndex)
+                {
+                    pending.push_back(std::move(promises[bufferIndex]));
+                    next++;
+                }
+                else
+                {
+                    promises[bufferIndex].set_value();
+                }
+            }
+
+            if (pending.empty())
+            {
+                return;
+            }
+
+            detail::DataContext loadContext = dataContext;
+            loadContext.binaryData = nullptr;
+
+            std::vector<std::vector<detail::ByteRange>> ranges = detail::GetPartialLoadRanges(*m_document, loadContext.readOptions);
+            m_loader = std::thread([document = m_document, uriBuffers, ranges = std::move(ranges), pending = std::move(pending), loadContext]() mutable {
+                detail::ParallelFor(uriBuffers.size(), loadContext.readOptions.MaxThreadCount, [&](std::size_t index) {
+                    try
+                    {
+                        detail::MaterializeUriBuffer(document->buffers, uriBuffers[index], ranges, loadContext);
+                        pending[index].set_value();
+                    }
+                    catch (...)
+                    {
+                        pending[index].set_exception(std::current_exception());
+                    }
+                });
+            });
+        }
+
+        AsyncDocument(AsyncDocument const &) = delete;
+        AsyncDocument(AsyncDocument &&) = default;
+        AsyncDocument & operator=(AsyncDocument const &) = delete;
+
+        AsyncDocument & operator=(AsyncDocument && other)
+        {
+            if (this != &other)
+            {
+                Join();
+                m_document = std::move(other.m_document);
+                m_buffers = std::move(other.m_buffers);
+                m_loader = std::move(other.m_loader);
+            }
+
+            return *this;
+        }
+
+        ~AsyncDocument()
+        {
+            Join();
+        }
+
+        FX_GLTF_NODISCARD Document const & GetDocument() const noexcept
+        {
+            return *m_document;
+        }
+
+        FX_GLTF_NODISCARD Document & GetDocument() noexcept
+        {
+            return *m_document;
+        }
+
+        // Ready once document.buffers[bufferIndex] is loaded; get() rethrows the error if it failed
+        FX_GLTF_NODISCARD std::shared_future<void> const & GetBufferFuture(std::size_t bufferIndex) const
+        {
+            return m_buffers.at(bufferIndex);
+        }
+
+        FX_GLTF_NODISCARD bool IsBufferReady(std::size_t bufferIndex) const
+        {
+            return GetBufferFuture(bufferIndex).wait_for(std::chrono::seconds(0)) == std::future_status::ready;
+        }
+
+        Buffer & WaitForBuffer(std::size_t bufferIndex)
+        {
+            GetBufferFuture(bufferIndex).get();
+            return m_document->buffers[bufferIndex];
+        }
+
+        // Waits for every buffer, rethrowing the first error in document order
+        void WaitAll()
+        {
+            for (std::shared_future<void> const & buffer : m_buffers)
+            {
+                buffer.get();
+            }
+
+            Join();
+        }
+
+        // Waits for every buffer and hands over the completed document
+        Document Release()
+        {
+            WaitAll();
+            m_buffers.clear();
+            return std::move(*m_document);
+        }
+
+    private:
+        std::shared_ptr<Document> m_document{ std::make_shared<Document>() };
+        std::vector<std::shared_future<void>> m_buffers{};
+        std::thread m_loader{};
+
+        void Join()
+        {
+            if (m_loader.joinable())
+            {
+                m_loader.join();
+            }
+        }
+    };
+
+    inline Document LoadFromText(std::istream & input, FX_GLTF_FILESYSTEM::path const & documentRootPath, ReadQuotas const & readQuotas = {}, ReadOptions const & readOptions = {})
+    {
+        try
+        {
+            detail::ThrowIfBad(input);
+
+            Document document = detail::ParseDocument(input);
+            detail::MaterializeBuffers(document, { documentRootPath, readQuotas, readOptions });
+
+            return document;
+        }
+        catch (invalid_gltf_document &)
+        {
+            throw;
+        }
+        catch (std::system_error &)
+        {
+            throw;
+        }
+        catch (...)
+        {
+            std::throw_with_nested(invalid_gltf_document("Invalid glTF document. See nested exception for details."));
+        }
+    }
+
+    inline Document LoadFromText(FX_GLTF_FILESYSTEM::path const & documentFilePath, ReadQuotas const & readQuotas = {}, ReadOptions const & readOptions = {})
+    {
+        std::ifstream input(documentFilePath);
+        if (!input.is_open())
+        {
+            throw std::system_error(std::make_error_code(std::errc::no_such_file_or_directory));
+        }
+
+        return LoadFromText(input, detail::GetDocumentRootPath(documentFilePath), readQuotas, readOptions);
+    }
+
+    inline Document LoadFromBinary(std::istream & input, FX_GLTF_FILESYSTEM::path const & documentRootPath, ReadQuotas const & readQuotas = {}, ReadOptions const & readOptions = {})
+    {
+        detail::DataContext dataContext{ documentRootPath, readQuotas, readOptions };
+        return detail::LoadBinary(input, dataContext);
+    }
+
+    inline Document LoadFromBinary(FX_GLTF_FILESYSTEM::path const & documentFilePath, ReadQuotas const & readQuotas = {}, ReadOptions const & readOptions = {})
+    {
+        std::ifstream input(documentFilePath, std::ios::binary);
+        if (!input.is_open())
+        {
+            throw std::system_error(std::make_error_code(std::errc::no_such_file_or_directory));
+        }
+
+        detail::DataContext dataContext{ detail::GetDocumentRootPath(documentFilePath), readQuotas, readOptions };
+        dataContext.binaryFilePath = documentFilePath;
+
+        return detail::LoadBinary(input, dataContext);
+    }
+
+    // Parses only the document structure of a .gltf. The buffers are validated against the quotas but none is read.
+    inline DocumentHeader LoadFromTextHeaderOnly(std::istream & input, ReadQuotas const & readQuotas = {})
+    {
+        try
+        {
+            detail::ThrowIfBad(input);
+
+            DocumentHeader header{};
+            header.document = detail::ParseDocument(input);
+            detail::PrepareBuffers(header.document, { {}, readQuotas, {} });
+
+            return header;
+        }
+        catch (invalid_gltf_document &)
+        {
+            throw;
+        }
+        catch (std::system_error &)
+        {
+            throw;
+        }
+        catch (...)
+        {
+            std::throw_with_nested(invalid_gltf_document("Invalid glTF document. See nested exception for details."));
+        }
+    }
+
+    inline DocumentHeader LoadFromTextHeaderOnly(FX_GLTF_FILESYSTEM::path const & documentFilePath, ReadQuotas const & readQuotas = {})
+    {
+        std::ifstream input(documentFilePath);
+        if (!input.is_open())
+        {
+            throw std::system_error(std::make_error_code(std::errc::no_such_file_or_directory));
+        }
+
+        return LoadFromTextHeaderOnly(input, readQuotas);
+    }
+
+    // Parses the JSON chunk of a .glb and stops at the BIN chunk, recording its location instead of reading it.
+    inline DocumentHeader LoadFromBinaryHeaderOnly(std::istream & input, ReadQuotas const & readQuotas = {})
+    {
+        try
+        {
+            DocumentHeader header{};
+            detail::ChunkHeader binHeader{};
+            header.document = detail::ReadBinaryJson(input, readQuotas, binHeader, header.binaryChunkOffset);
+            header.binaryChunkLength = binHeader.chunkLength;
+
+            detail::PrepareBuffers(header.document, { {}, readQuotas, {} });
+            for (Buffer const & buffer : header.document.buffers)
+            {
+                if (buffer.uri.empty() && buffer.byteLength > header.binaryChunkLength)
+                {
+                    throw invalid_gltf_document("Invalid GLB buffer data");
+                }
+            }
+
+            return header;
+        }
+        catch (invalid_gltf_document &)
+        {
+            throw;
+        }
+        catch (std::system_error &)
+        {
+            throw;
+        }
+        catch (...)
+        {
+            std::throw_with_nested(invalid_gltf_document("Invalid glTF document. See nested exception for details."));
+        }
+    }
+
+    inline DocumentHeader LoadFromBinaryHeaderOnly(FX_GLTF_FILESYSTEM::path const & documentFilePath, ReadQuotas const & readQuotas = {})
+    {
+        std::ifstream input(documentFilePath, std::ios::binary);
+        if (!input.is_open())
+        {
+            throw std::system_error(std::make_error_code(std::errc::no_such_file_or_directory));
+        }
+
+        return LoadFromBinaryHeaderOnly(input, readQuotas);
+    }
+
+    // Returns as soon as the json is parsed; external and embedded buffers keep loading on a background
+    // thread (spread over ReadOptions::MaxThreadCount) and are awaited through the AsyncDocument.
+    inline AsyncDocument LoadFromTextAsync(std::istream & input, FX_GLTF_FILESYSTEM::path const & documentRootPath, ReadQuotas const & readQuotas = {}, ReadOptions const & readOptions = {})
+    {
+        try
+        {
+            detail::ThrowIfBad(input);
+
+            return AsyncDocument(detail::ParseDocument(input), { documentRootPath, readQuotas, readOptions });
+        }
+        catch (invalid_gltf_document &)
+        {
+            throw;
+        }
+        catch (std::system_error &)
+        {
+            throw;
+        }
+        catch (...)
+        {
+            std::throw_with_nested(invalid_gltf_document("Invalid glTF document. See nested exception for details."));
+        }
+    }
+
+    inline AsyncDocument LoadFromTextAsync(FX_GLTF_FILESYSTEM::path const & documentFilePath, ReadQuotas const & readQuotas = {}, ReadOptions const & readOptions = {})
+    {
+        std::ifstream input(documentFilePath);
+        if (!input.is_open())
+        {
+            throw std::system_error(std::make_error_code(std::errc::no_such_file_or_directory));
+        }
+
+        return LoadFromTextAsync(input, detail::GetDocumentRootPath(documentFilePath), readQuotas, readOptions);
+    }
+
+    // As LoadFromTextAsync; the BIN chunk is read up front so buffer 0 is ready immediately.
+    inline AsyncDocument LoadFromBinaryAsync(std::istream & input, FX_GLTF_FILESYSTEM::path const & documentRootPath, ReadQuotas const & readQuotas = {}, ReadOptions const & readOptions = {})
+    {
+        try
+        {
+            detail::DataContext dataContext{ documentRootPath, readQuotas, readOptions };
+
+            std::vector<uint8_t> binary{};
+            Document document = detail::ReadBinary(input, dataContext, binary);
+
+            return AsyncDocument(std::move(document), dataContext);
+        }
+        catch (invalid_gltf_document &)
+        {
+            throw;
+        }
+        catch (std::system_error &)
+        {
+            throw;
+        }
+        catch (...)
+        {
+            std::throw_with_nested(invalid_gltf_document("Invalid glTF document. See nested exception for details."));
+        }
+    }
+
+    inline AsyncDocument LoadFromBinaryAsync(FX_GLTF_FILESYSTEM::path const & documentFilePath, ReadQuotas const & readQuotas = {}, ReadOptions const & readOptions = {})
+    {
+        std::ifstream input(documentFilePath, std::ios::binary);
+        if (!input.is_open())
+        {
+            throw std::system_error(std::make_error_code(std::errc::no_such_file_or_directory));
+        }
+
+        return LoadFromBinaryAsync(input, detail::GetDocumentRootPath(documentFilePath), readQuotas, readOptions);
+    }
+
+    // Loads a .gltf document by memory mapping it. External buffers are mapped as well and are exposed
+    // through Buffer::GetData() as views into their mappings; the document keeps the mappings alive.
+    inline Document LoadFromTextMapped(FX_GLTF_FILESYSTEM::path const & documentFilePath, ReadQuotas const & readQuotas = {}, ReadOptions const & readOptions = {})
+    {
+        detail::MappedFile file(documentFilePath);
+        if (!file.IsOpen())
+        {
+            throw std::system_error(std::make_error_code(std::errc::no_such_file_or_directory));
+        }
+
+        try
+        {
+            detail::DataContext dataContext{ detail::GetDocumentRootPath(documentFilePath), readQuotas, readOptions };
+            dataContext.useMappedFiles = true;
+
+            Document document = detail::ParseDocument(file.data(), file.data() + file.size());
+            detail::MaterializeBuffers(document, dataContext);
+
+            return document;
+        }
+        catch (invalid_gltf_document &)
+        {
+            throw;
+        }
+        catch (std::system_error &)
+        {
+            throw;
+        }
+        catch (...)
+        {
+            std::throw_with_nested(invalid_gltf_document("Invalid glTF document. See nested exception for details."));
+        }
+    }
+
+    // Loads a .glb document by memory mapping it. The BIN chunk, and any external buffers, are exposed
+    // through Buffer::GetData() as views into their mappings; the document keeps the mappings alive.
+    inline Document LoadFromBinaryMapped(FX_GLTF_FILESYSTEM::path const & documentFilePath, ReadQuotas const & readQuotas = {}, ReadOptions const & readOptions = {})
+    {
+        std::shared_ptr<detail::MappedFile> file = std::make_shared<detail::MappedFile>(documentFilePath);
+        if (!file->IsOpen())
+        {
+            throw std::system_error(std::make_error_code(std::errc::no_such_file_or_directory));
+        }
+
+        try
+        {
+            detail::GLBHeader header{};
+            if (file->size() < detail::HeaderSize)
+            {
+                throw std::system_error(std::make_error_code(std::errc::io_error));
+            }
+
+            std::memcpy(&header, file->data(), detail::HeaderSize);
+            detail::ValidateGLBHeader(header);
+
+            std::size_t totalSize = detail::HeaderSize + header.jsonHeader.chunkLength;
+            detail::ValidateGLBFileSize(totalSize, readQuotas);
+
+            detail::ChunkHeader binHeader{};
+            if (file->size() < totalSize + detail::ChunkHeaderSize)
+            {
+                throw std::system_error(std::make_error_code(std::errc::io_error));
+            }
+
+            std::memcpy(&binHeader, file->data() + totalSize, detail::ChunkHeaderSize);
+            if (binHeader.chunkType != detail::GLBChunkBIN)
+            {
+                throw invalid_gltf_document("Invalid GLB header");
+            }
+
+            const std::size_t binOffset = totalSize + detail::ChunkHeaderSize;
+            totalSize = binOffset + binHeader.chunkLength;
+            detail::ValidateGLBFileSize(totalSize, readQuotas);
+            if (file->size() < totalSize)
+            {
+                throw std::system_error(std::make_error_code(std::errc::io_error));
+            }
+
+            detail::DataContext dataContext{ detail::GetDocumentRootPath(documentFilePath), readQuotas, readOptions };
+            dataContext.binaryStorage = std::shared_ptr<uint8_t>(file, file->data() + binOffset);
+            dataContext.binaryStorageLength = binHeader.chunkLength;
+            dataContext.useMappedFiles = true;
+
+            uint8_t const * json = file->data() + detail::HeaderSize;
+            Document document = detail::ParseDocument(json, json + header.jsonHeader.chunkLength);
+            detail::MaterializeBuffers(document, dataContext);
+
+            return document;
+        }
+        catch (invalid_gltf_document &)
+        {
+            throw;
+        }
+        catch (std::system_error &)
+        {
+            throw;
+        }
+        catch (...)
+        {
+            std::throw_with_nested(invalid_gltf_document("Invalid glTF document. See nested exception for details."));
+        }
+    }
+
+    // Per component bounds of the accessor's elements, as the specification defines accessor.min and accessor.max: over
+    // the values as stored (accessor.normalized is ignored) with sparse substitution applied. Both are empty for an
+    // accessor without elements. The elements are reduced in chunks on up to maxThreadCount threads (0 uses all
+    // hardware threads).
+    inline AccessorBounds ComputeBounds(Document const & document, Accessor const & accessor, uint32_t maxThreadCount = 1)
+    {
+        return detail::ComputeBounds(document, { &accessor, 1 }, maxThreadCount).front();
+    }
+
+    // Sets min and max of every accessor to its ComputeBounds. The chunks of all accessors share the threads, so many
+    // small accessors are spread over them as well.
+    inline void RefreshBounds(Document & document, uint32_t maxThreadCount = 1)
+    {
+        std::vector<AccessorBounds> bounds = detail::ComputeBounds(document, { document.accessors.data(), document.accessors.size() }, maxThreadCount);
+        for (std::size_t i = 0; i < document.accessors.size(); i++)
+        {
+            document.accessors[i].min = std::move(bounds[i].min);
+            document.accessors[i].max = std::move(bounds[i].max);
+        }
+    }
+
+    // External buffers are written next to the document, or handed to saveOptions.Resolver when one is given
+    inline void Save(
+        Document const & document, std::ostream & output, FX_GLTF_FILESYSTEM::path const & documentRootPath, bool useBinaryFormat, SaveOptions const & saveOptions = {})
+    {
+        try
+        {
+            detail::ValidateBuffers(document, useBinaryFormat);
+
+            detail::Save(document, output, documentRootPath, useBinaryFormat, saveOptions);
+        }
+        catch (invalid_gltf_document &)
+        {
+            throw;
+        }
+        catch (std::system_error &)
+        {
+            throw;
+        }
+        catch (...)
+        {
+            std::throw_with_nested(invalid_gltf_document("Invalid glTF document. See nested exception for details."));
+        }
+    }
+
+    inline void Save(
+        Document const & document, FX_GLTF_FILESYSTEM::path const & documentFilePath, bool useBinaryFormat, SaveOptions const & saveOptions = {})
+    {
+        std::ofstream output(documentFilePath, useBinaryFormat ? std::ios::binary : std::ios::out);
+        Save(document, output, detail::GetDocumentRootPath(documentFilePath), useBinaryFormat, saveOptions);
+    }
+
+    // Saves a .glb whose BIN chunk is streamed from `binaryChunk`, in order, so its pieces (e.g. separately built
+    // meshes) never need to be concatenated into one buffer. document.buffers[0] describes the chunk: an empty uri and
+    // a byteLength equal to the total size of the parts; its data is not used. The bufferView offsets into the chunk,
+    // and any alignment padding between parts, are up to the caller. Other buffers are saved as with Save.
+    inline void SaveBinary(
+        Document const & document, std::vector<BinaryChunkPart> const & binaryChunk, std::ostream & output, FX_GLTF_FILESYSTEM::path const & documentRootPath, SaveOptions const & saveOptions = {})
+    {
+        try
+        {
+            detail::ValidateBuffers(document, true, true);
+
+            detail::Save(document, output, documentRootPath, true, saveOptions, &binaryChunk);
+        }
+        catch (invalid_gltf_document &)
+        {
+            throw;
+        }
+        catch (std::system_error &)
+        {
+            throw;
+        }
+        catch (...)
+        {
+            std::throw_with_nested(invalid_gltf_document("Invalid glTF document. See nested exception for details."));
+        }
+    }
+
+    inline void SaveBinary(
+        Document const & document, std::vector<BinaryChunkPart> const & binaryChunk, FX_GLTF_FILESYSTEM::path const & documentFilePath, SaveOptions const & saveOptions = {})
+    {
+        std::ofstream output(documentFilePath, std::ios::binary);
+        SaveBinary(document, binaryChunk, output, detail::GetDocumentRootPath(documentFilePath), saveOptions);
     }
 
-    inline void from_json(nlohmann::json const & json, Camera & camera)
-    {
-        detail::ReadRequiredField("type", json, camera.type);
+    namespace detail
+    {
+        inline std::vector<uint32_t> GetBufferViewAlignments(Document const & document, bool alignToComponentSize)
+        {
+            constexpr uint32_t VertexAlignment = 4;
+
+            std::vector<uint32_t> alignments(document.bufferViews.size(), alignToComponentSize ? 1 : VertexAlignment);
+            if (!alignToComponentSize)
+            {
+                return alignments;
+            }
+
+            auto require = [&alignments](int64_t bufferView, Accessor::ComponentType componentType) {
+                if (bufferView >= 0 && static_cast<uint64_t>(bufferView) < alignments.size())
+                {
+                    uint32_t & alignment = alignments[static_cast<std::size_t>(bufferView)];
+                    alignment = (std::max)(alignment, GetComponentSize(componentType));
+                }
+            };
+
+            for (Accessor const & accessor : document.accessors)
+            {
+                require(accessor.bufferView, accessor.componentType);
+                if (!accessor.sparse.empty())
+                {
+                    require(accessor.sparse.indices.bufferView, accessor.sparse.indices.componentType);
+                    require(accessor.sparse.values.bufferView, accessor.componentType);
+                }
+            }
+
+            for (std::size_t bufferViewIndex = 0; bufferViewIndex < alignments.size(); bufferViewIndex++)
+            {
+                BufferView const & bufferView = document.bufferViews[bufferViewIndex];
+                if (bufferView.byteStride != 0 || bufferView.target == BufferView::TargetType::ArrayBuffer)
+                {
+                    alignments[bufferViewIndex] = VertexAlignment;
+                }
+            }
+
+            return alignments;
+        }
+
+        // Copies the bufferView contents into new buffers: one for all of them when merging, otherwise one per
+        // existing buffer. Overlapping bufferViews are copied as one range. A range keeps its old offset modulo its
+        // alignment, so accessor offsets which were aligned stay aligned. Buffers whose layout does not change
+        // are not copied.
+        inline void RepackBuffers(Document & document, std::vector<uint32_t> const & alignments, bool mergeBuffers, bool dropUnreferencedBytes)
+        {
+            struct PackRange
+            {
+                uint32_t buffer;
+                uint64_t begin;
+                uint64_t end;
+                uint64_t alignment;
+                uint64_t target;
+            };
+
+            std::vector<BufferView> & bufferViews = document.bufferViews;
+            for (BufferView const & bufferView : bufferViews)
+            {
+                Buffer const * buffer = FindElement(document.buffers, bufferView.buffer);
+                if (buffer == nullptr)
+                {
+                    throw invalid_gltf_document("Invalid bufferView.buffer value");
+                }
+
+                if (bufferView.byteOffset > buffer->byteLength || buffer->byteLength - bufferView.byteOffset < bufferView.byteLength)
+                {
+                    throw invalid_gltf_document("Invalid bufferView.byteLength value : exceeds buffer.byteLength");
+                }
+            }
+
+            std::vector<PackRange> ranges{};
+            std::vector<std::size_t> rangeOfBufferView(bufferViews.size());
+            if (dropUnreferencedBytes)
+            {
+                std::vector<uint32_t> order(bufferViews.size());
+                std::iota(order.begin(), order.end(), 0);
+                std::sort(order.begin(), order.end(), [&bufferViews](uint32_t left, uint32_t right) {
+                    return bufferViews[left].buffer != bufferViews[right].buffer ? bufferViews[left].buffer < bufferViews[right].buffer
+                                                                                 : bufferViews[left].byteOffset < bufferViews[right].byteOffset;
+                });
+
+                for (uint32_t bufferViewIndex : order)
+                {
+                    BufferView const & bufferView = bufferViews[bufferViewIndex];
+                    const uint32_t buffer = static_cast<uint32_t>(bufferView.buffer);
+                    const uint64_t end = bufferView.byteOffset + bufferView.byteLength;
+                    if (ranges.empty() || ranges.back().buffer != buffer || bufferView.byteOffset >= ranges.back().end)
+                    {
+                        ranges.push_back({ buffer, bufferView.byteOffset, end, 1, 0 });
+                    }
+
+                    PackRange & range = ranges.back();
+                    range.end = (std::max)(range.end, end);
+                    range.alignment = (std::max<uint64_t>)(range.alignment, alignments[bufferViewIndex]);
+                    rangeOfBufferView[bufferViewIndex] = ranges.size() - 1;
+                }
+            }
+            else
+            {
+                for (uint32_t bufferIndex = 0; bufferIndex < document.buffers.size(); bufferIndex++)
+                {
+                    ranges.push_back({ bufferIndex, 0, document.buffers[bufferIndex].byteLength, 1, 0 });
+                }
+
+                for (std::size_t bufferViewIndex = 0; bufferViewIndex < bufferViews.size(); bufferViewIndex++)
+                {
+                    PackRange & range = ranges[static_cast<std::size_t>(bufferViews[bufferViewIndex].buffer)];
+                    range.alignment = (std::max<uint64_t>)(range.alignment, alignments[bufferViewIndex]);
+                    rangeOfBufferView[bufferViewIndex] = static_cast<std::size_t>(bufferViews[bufferViewIndex].buffer);
+                }
+            }
+
+            const std::size_t targetCount = mergeBuffers ? 1 : document.buffers.size();
+            std::vector<uint64_t> targetSizes(targetCount);
+            std::vector<bool> targetMoved(targetCount, mergeBuffers);
+            for (PackRange & range : ranges)
+            {
+                const std::size_t targetIndex = mergeBuffers ? 0 : range.buffer;
+                uint64_t & size = targetSizes[targetIndex];
+                size += (range.begin % range.alignment + range.alignment - size % range.alignment) % range.alignment;
+                range.target = size;
+                size += range.end - range.begin;
+                if (range.target != range.begin)
+                {
+                    targetMoved[targetIndex] = true;
+                }
+            }
+
+            std::vector<std::vector<uint8_t>> targets(targetCount);
+            for (std::size_t targetIndex = 0; targetIndex < targetCount; targetIndex++)
+            {
+                if (targetSizes[targetIndex] > std::numeric_limits<std::size_t>::max())
+                {
+                    throw invalid_gltf_document("Invalid buffer.byteLength value : exceeds the address space");
+                }
+
+                if (targetMoved[targetIndex] || targetSizes[targetIndex] != document.buffers[targetIndex].byteLength)
+                {
+                    targetMoved[targetIndex] = true;
+                    targets[targetIndex].resize(static_cast<std::size_t>(targetSizes[targetIndex]));
+                }
+            }
+
+            for (PackRange const & range : ranges)
+            {
+                const std::size_t targetIndex = mergeBuffers ? 0 : range.buffer;
+                if (targetMoved[targetIndex] && range.end != range.begin)
+                {
+                    Buffer const & buffer = document.buffers[range.buffer];
+                    std::memcpy(&targets[targetIndex][static_cast<std::size_t>(range.target)], &buffer.GetData()[static_cast<std::size_t>(range.begin)], static_cast<std::size_t>(range.end - range.begin));
+                }
+            }
+
+            for (std::size_t bufferViewIndex = 0; bufferViewIndex < bufferViews.size(); bufferViewIndex++)
+            {
+                PackRange const & range = ranges[rangeOfBufferView[bufferViewIndex]];
+                bufferViews[bufferViewIndex].byteOffset = range.target + (bufferViews[bufferViewIndex].byteOffset - range.begin);
+                if (mergeBuffers)
+                {
+                    bufferViews[bufferViewIndex].buffer = 0;
+                }
+            }
+
+            if (mergeBuffers)
+            {
+                document.buffers.assign(1, Buffer{});
+            }
+
+            for (std::size_t targetIndex = 0; targetIndex < targetCount; targetIndex++)
+            {
+                if (targetMoved[targetIndex])
+                {
+                    Buffer & buffer = document.buffers[targetIndex];
+                    buffer.byteLength = targetSizes[targetIndex];
+                    buffer.data = std::move(targets[targetIndex]);
+                    buffer.externalData.reset();
+                    buffer.deferredData.reset();
+                    if (buffer.IsEmbeddedResource())
+                    {
+                        buffer.SetEmbeddedResourceOnSave();
+                    }
+                }
+            }
+        }
+
+        inline void MarkUsed(std::vector<bool> & used, int64_t index, char const * field)
+        {
+            if (index < 0)
+            {
+                return;
+            }
 
-        detail::ReadOptionalField("name", json, camera.name);
+            if (static_cast<uint64_t>(index) >= used.size())
+            {
+                throw invalid_gltf_document(field, "out of range");
+            }
 
-        detail::ReadExtensionsAndExtras(json, camera.extensionsAndExtras);
+            used[static_cast<std::size_t>(index)] = true;
+        }
 
-        if (camera.type == Camera::Type::Perspective)
+        // Moves the used elements to the front, in order, and returns the new index of every old one (-1 when removed)
+        template <typename TElement>
+        inline std::vector<int32_t> CompactElements(std::vector<TElement> & elements, std::vector<bool> const & used)
         {
-            detail::ReadRequiredField("perspective", json, camera.perspective);
+            std::vector<int32_t> newIndices(elements.size(), -1);
+            std::size_t count = 0;
+            for (std::size_t index = 0; index < elements.size(); index++)
+            {
+                if (used[index])
+                {
+                    if (count != index)
+                    {
+                        elements[count] = std::move(elements[index]);
+                    }
+
+                    newIndices[index] = static_cast<int32_t>(count++);
+                }
+            }
+
+            elements.erase(elements.begin() + static_cast<std::ptrdiff_t>(count), elements.end());
+            return newIndices;
         }
-        else if (camera.type == Camera::Type::Orthographic)
+
+        template <typename TIndex>
+        inline void RemapIndex(TIndex & index, std::vector<int32_t> const & newIndices) noexcept
         {
-            detail::ReadRequiredField("orthographic", json, camera.orthographic);
+            if (static_cast<int64_t>(index) >= 0 && static_cast<uint64_t>(index) < newIndices.size())
+            {
+                index = static_cast<TIndex>(newIndices[static_cast<std::size_t>(index)]);
+            }
         }
-    }
+    } // namespace detail
 
-    inline void from_json(nlohmann::json const & json, Image & image)
+    // Merges all buffers into one with an empty uri, as the first buffer of a .glb needs, and points every bufferView
+    // at it. Buffer contents are read (and deferred buffers loaded) as part of the copy.
+    inline void PackBuffers(Document & document, PackOptions const & packOptions = {})
     {
-        detail::ReadOptionalField("bufferView", json, image.bufferView);
-        detail::ReadOptionalField("mimeType", json, image.mimeType);
-        detail::ReadOptionalField("name", json, image.name);
-        detail::ReadOptionalField("uri", json, image.uri);
+        if (document.buffers.empty())
+        {
+            return;
+        }
 
-        detail::ReadExtensionsAndExtras(json, image.extensionsAndExtras);
+        detail::RepackBuffers(document, detail::GetBufferViewAlignments(document, packOptions.AlignToComponentSize), true, packOptions.DropUnreferencedBytes);
     }
 
-    inline void from_json(nlohmann::json const & json, Material::AlphaMode & materialAlphaMode)
+    // Removes the meshes, materials, textures, samplers, images, accessors, bufferViews and buffers which no node,
+    // skin or animation reaches, and the buffer bytes no remaining bufferView covers, then rewrites the references to
+    // what is left. Nodes, scenes, cameras, skins and animations are all kept. Indices held in extensions (e.g.
+    // KHR_draco_mesh_compression or KHR_texture_basisu) are neither followed nor rewritten.
+    inline void RemoveUnusedData(Document & document)
     {
-        std::string alphaMode = json.get<std::string>();
-        if (alphaMode == "OPAQUE")
+        std::vector<bool> meshes(document.meshes.size());
+        std::vector<bool> materials(document.materials.size());
+        std::vector<bool> textures(document.textures.size());
+        std::vector<bool> samplers(document.samplers.size());
+        std::vector<bool> images(document.images.size());
+        std::vector<bool> accessors(document.accessors.size());
+        std::vector<bool> bufferViews(document.bufferViews.size());
+        std::vector<bool> buffers(document.buffers.size());
+
+        for (Node const & node : document.nodes)
         {
-            materialAlphaMode = Material::AlphaMode::Opaque;
+            detail::MarkUsed(meshes, node.mesh, "Invalid node.mesh value");
         }
-        else if (alphaMode == "MASK")
+
+        for (std::size_t meshIndex = 0; meshIndex < meshes.size(); meshIndex++)
         {
-            materialAlphaMode = Material::AlphaMode::Mask;
+            if (!meshes[meshIndex])
+            {
+                continue;
+            }
+
+            for (Primitive const & primitive : document.meshes[meshIndex].primitives)
+            {
+                detail::MarkUsed(accessors, primitive.indices, "Invalid primitive.indices value");
+                detail::MarkUsed(materials, primitive.material, "Invalid primitive.material value");
+                for (auto const & attribute : primitive.attributes)
+                {
+                    detail::MarkUsed(accessors, attribute.second, "Invalid primitive.attributes value");
+                }
+
+                for (Attributes const & target : primitive.targets)
+                {
+                    for (auto const & attribute : target)
+                    {
+                        detail::MarkUsed(accessors, attribute.second, "Invalid primitive.targets value");
+                    }
+                }
+            }
         }
-        else if (alphaMode == "BLEND")
+
+        for (Skin const & skin : document.skins)
         {
-            materialAlphaMode = Material::AlphaMode::Blend;
+            detail::MarkUsed(accessors, skin.inverseBindMatrices, "Invalid skin.inverseBindMatrices value");
         }
-        else
+
+        for (Animation const & animation : document.animations)
         {
-            throw invalid_gltf_document("Unknown material.alphaMode value", alphaMode);
+            for (Animation::Sampler const & sampler : animation.samplers)
+            {
+                detail::MarkUsed(accessors, sampler.input, "Invalid animation.sampler.input value");
+                detail::MarkUsed(accessors, sampler.output, "Invalid animation.sampler.output value");
+            }
         }
-    }
 
-    inline void from_json(nlohmann::json const & json, Material::Texture & materialTexture)
-    {
-        detail::ReadRequiredField("index", json, materialTexture.index);
-        detail::ReadOptionalField("texCoord", json, materialTexture.texCoord);
+        for (std::size_t materialIndex = 0; materialIndex < materials.size(); materialIndex++)
+        {
+            if (materials[materialIndex])
+            {
+                Material const & material = document.materials[materialIndex];
+                for (Material::Texture const * texture : { &material.pbrMetallicRoughness.baseColorTexture, &material.pbrMetallicRoughness.metallicRoughnessTexture,
+                         static_cast<Material::Texture const *>(&material.normalTexture), static_cast<Material::Texture const *>(&material.occlusionTexture), &material.emissiveTexture })
+                {
+                    detail::MarkUsed(textures, texture->index, "Invalid material.texture.index value");
+                }
+            }
+        }
 
-        detail::ReadExtensionsAndExtras(json, materialTexture.extensionsAndExtras);
-    }
+        for (std::size_t textureIndex = 0; textureIndex < textures.size(); textureIndex++)
+        {
+            if (textures[textureIndex])
+            {
+                detail::MarkUsed(images, document.textures[textureIndex].source, "Invalid texture.source value");
+                detail::MarkUsed(samplers, document.textures[textureIndex].sampler, "Invalid texture.sampler value");
+            }
+        }
 
-    inline void from_json(nlohmann::json const & json, Material::NormalTexture & materialTexture)
-    {
-        from_json(json, static_cast<Material::Texture &>(materialTexture));
-        detail::ReadOptionalField("scale", json, materialTexture.scale);
+        for (std::size_t imageIndex = 0; imageIndex < images.size(); imageIndex++)
+        {
+            if (images[imageIndex] && document.images[imageIndex].uri.empty())
+            {
+                detail::MarkUsed(bufferViews, document.images[imageIndex].bufferView, "Invalid image.bufferView value");
+            }
+        }
 
-        detail::ReadExtensionsAndExtras(json, materialTexture.extensionsAndExtras);
-    }
+        for (std::size_t accessorIndex = 0; accessorIndex < accessors.size(); accessorIndex++)
+        {
+            Accessor const & accessor = document.accessors[accessorIndex];
+            if (accessors[accessorIndex])
+            {
+                detail::MarkUsed(bufferViews, accessor.bufferView, "Invalid accessor.bufferView value");
+                if (!accessor.sparse.empty())
+                {
+                    detail::MarkUsed(bufferViews, accessor.sparse.indices.bufferView, "Invalid accessor.sparse.indices.bufferView value");
+                    detail::MarkUsed(bufferViews, accessor.sparse.values.bufferView, "Invalid accessor.sparse.values.bufferView value");
+                }
+            }
+        }
 
-    inline void from_json(nlohmann::json const & json, Material::OcclusionTexture & materialTexture)
-    {
-        from_json(json, static_cast<Material::Texture &>(materialTexture));
-        detail::ReadOptionalField("strength", json, materialTexture.strength);
+        for (std::size_t bufferViewIndex = 0; bufferViewIndex < bufferViews.size(); bufferViewIndex++)
+        {
+            if (bufferViews[bufferViewIndex])
+            {
+                detail::MarkUsed(buffers, document.bufferViews[bufferViewIndex].buffer, "Invalid bufferView.buffer value");
+            }
+        }
 
-        detail::ReadExtensionsAndExtras(json, materialTexture.extensionsAndExtras);
-    }
+        const std::vector<int32_t> meshIndices = detail::CompactElements(document.meshes, meshes);
+        const std::vector<int32_t> materialIndices = detail::CompactElements(document.materials, materials);
+        const std::vector<int32_t> textureIndices = detail::CompactElements(document.textures, textures);
+        const std::vector<int32_t> samplerIndices = detail::CompactElements(document.samplers, samplers);
+        const std::vector<int32_t> imageIndices = detail::CompactElements(document.images, images);
+        const std::vector<int32_t> accessorIndices = detail::CompactElements(document.accessors, accessors);
+        const std::vector<int32_t> bufferViewIndices = detail::CompactElements(document.bufferViews, bufferViews);
+        const std::vector<int32_t> bufferIndices = detail::CompactElements(document.buffers, buffers);
 
-    inline void from_json(nlohmann::json const & json, Material::PBRMetallicRoughness & pbrMetallicRoughness)
-    {
-        detail::ReadOptionalField("baseColorFactor", json, pbrMetallicRoughness.baseColorFactor);
-        detail::ReadOptionalField("baseColorTexture", json, pbrMetallicRoughness.baseColorTexture);
-        detail::ReadOptionalField("metallicFactor", json, pbrMetallicRoughness.metallicFactor);
-        detail::ReadOptionalField("metallicRoughnessTexture", json, pbrMetallicRoughness.metallicRoughnessTexture);
-        detail::ReadOptionalField("roughnessFactor", json, pbrMetallicRoughness.roughnessFactor);
+        for (Node & node : document.nodes)
+        {
+            detail::RemapIndex(node.mesh, meshIndices);
+        }
 
-        detail::ReadExtensionsAndExtras(json, pbrMetallicRoughness.extensionsAndExtras);
-    }
+        for (Mesh & mesh : document.meshes)
+        {
+            for (Primitive & primitive : mesh.primitives)
+            {
+                detail::RemapIndex(primitive.indices, accessorIndices);
+                detail::RemapIndex(primitive.material, materialIndices);
+                for (auto & attribute : primitive.attributes)
+                {
+                    detail::RemapIndex(attribute.second, accessorIndices);
+                }
 
-    inline void from_json(nlohmann::json const & json, Material & material)
-    {
-        detail::ReadOptionalField("alphaMode", json, material.alphaMode);
-        detail::ReadOptionalField("alphaCutoff", json, material.alphaCutoff);
-        detail::ReadOptionalField("doubleSided", json, material.doubleSided);
-        detail::ReadOptionalField("emissiveFactor", json, material.emissiveFactor);
-        detail::ReadOptionalField("emissiveTexture", json, material.emissiveTexture);
-        detail::ReadOptionalField("name", json, material.name);
-        detail::ReadOptionalField("normalTexture", json, material.normalTexture);
-        detail::ReadOptionalField("occlusionTexture", json, material.occlusionTexture);
-        detail::ReadOptionalField("pbrMetallicRoughness", json, material.pbrMetallicRoughness);
+                for (Attributes & target : primitive.targets)
+                {
+                    for (auto & attribute : target)
+                    {
+                        detail::RemapIndex(attribute.second, accessorIndices);
+                    }
+                }
+            }
+        }
 
-        detail::ReadExtensionsAndExtras(json, material.extensionsAndExtras);
-    }
+        for (Skin & skin : document.skins)
+        {
+            detail::RemapIndex(skin.inverseBindMatrices, accessorIndices);
+        }
 
-    inline void from_json(nlohmann::json const & json, Mesh & mesh)
-    {
-        detail::ReadRequiredField("primitives", json, mesh.primitives);
+        for (Animation & animation : document.animations)
+        {
+            for (Animation::Sampler & sampler : animation.samplers)
+            {
+                detail::RemapIndex(sampler.input, accessorIndices);
+                detail::RemapIndex(sampler.output, accessorIndices);
+            }
+        }
 
-        detail::ReadOptionalField("name", json, mesh.name);
-        detail::ReadOptionalField("weights", json, mesh.weights);
+        for (Material & material : document.materials)
+        {
+            for (Material::Texture * texture : { &material.pbrMetallicRoughness.baseColorTexture, &material.pbrMetallicRoughness.metallicRoughnessTexture,
+                     static_cast<Material::Texture *>(&material.normalTexture), static_cast<Material::Texture *>(&material.occlusionTexture), &material.emissiveTexture })
+            {
+                detail::RemapIndex(texture->index, textureIndices);
+            }
+        }
 
-        detail::ReadExtensionsAndExtras(json, mesh.extensionsAndExtras);
-    }
+        for (Texture & texture : document.textures)
+        {
+            detail::RemapIndex(texture.source, imageIndices);
+            detail::RemapIndex(texture.sampler, samplerIndices);
+        }
 
-    inline void from_json(nlohmann::json const & json, Node & node)
-    {
-        detail::ReadOptionalField("camera", json, node.camera);
-        detail::ReadOptionalField("children", json, node.children);
-        detail::ReadOptionalField("matrix", json, node.matrix);
-        detail::ReadOptionalField("mesh", json, node.mesh);
-        detail::ReadOptionalField("name", json, node.name);
-        detail::ReadOptionalField("rotation", json, node.rotation);
-        detail::ReadOptionalField("scale", json, node.scale);
-        detail::ReadOptionalField("skin", json, node.skin);
-        detail::ReadOptionalField("translation", json, node.translation);
+        for (Image & image : document.images)
+        {
+            if (image.uri.empty())
+            {
+                detail::RemapIndex(image.bufferView, bufferViewIndices);
+            }
+        }
 
-        detail::ReadExtensionsAndExtras(json, node.extensionsAndExtras);
+        for (Accessor & accessor : document.accessors)
+        {
+            detail::RemapIndex(accessor.bufferView, bufferViewIndices);
+            if (!accessor.sparse.empty())
+            {
+                detail::RemapIndex(accessor.sparse.indices.bufferView, bufferViewIndices);
+                detail::RemapIndex(accessor.sparse.values.bufferView, bufferViewIndices);
+            }
+        }
+
+        for (BufferView & bufferView : document.bufferViews)
+        {
+            detail::RemapIndex(bufferView.buffer, bufferIndices);
+        }
+
+        detail::RepackBuffers(document, detail::GetBufferViewAlignments(document, false), false, true);
     }
 
-    inline void from_json(nlohmann::json const & json, Primitive & primitive)
+    namespace detail
     {
-        detail::ReadRequiredField("attributes", json, primitive.attributes);
+        constexpr std::size_t HashBlockSize = 1024 * 1024;
 
-        detail::ReadOptionalField("indices", json, primitive.indices);
-        detail::ReadOptionalField("material", json, primitive.material);
-        detail::ReadOptionalField("mode", json, primitive.mode);
-        detail::ReadOptionalField("targets", json, primitive.targets);
+        inline uint64_t RotateLeft(uint64_t value, int bits) noexcept
+        {
+            return (value << bits) | (value >> (64 - bits));
+        }
 
-        detail::ReadExtensionsAndExtras(json, primitive.extensionsAndExtras);
-    }
+        // XXH64 (https://github.com/Cyan4973/xxHash). Only used to find candidates for identical data, which are
+        // then compared byte for byte.
+        inline uint64_t Hash64(uint8_t const * data, std::size_t length, uint64_t seed = 0) noexcept
+        {
+            constexpr uint64_t Prime1 = 0x9E3779B185EBCA87ull;
+            constexpr uint64_t Prime2 = 0xC2B2AE3D27D4EB4Full;
+            constexpr uint64_t Prime3 = 0x165667B19E3779F9ull;
+            constexpr uint64_t Prime4 = 0x85EBCA77C2B2AE63ull;
+            constexpr uint64_t Prime5 = 0x27D4EB2F165667C5ull;
+
+            auto read64 = [](uint8_t const * bytes) noexcept {
+                uint64_t value;
+                std::memcpy(&value, bytes, sizeof(value));
+                return value;
+            };
 
-    inline void from_json(nlohmann::json const & json, Sampler & sampler)
-    {
-        detail::ReadOptionalField("magFilter", json, sampler.magFilter);
-        detail::ReadOptionalField("minFilter", json, sampler.minFilter);
-        detail::ReadOptionalField("name", json, sampler.name);
-        detail::ReadOptionalField("wrapS", json, sampler.wrapS);
-        detail::ReadOptionalField("wrapT", json, sampler.wrapT);
+            auto round = [](uint64_t accumulator, uint64_t input) noexcept {
+                return RotateLeft(accumulator + input * Prime2, 31) * Prime1;
+            };
 
-        detail::ReadExtensionsAndExtras(json, sampler.extensionsAndExtras);
-    }
+            auto mergeRound = [&round](uint64_t accumulator, uint64_t value) noexcept {
+                return (accumulator ^ round(0, value)) * Prime1 + Prime4;
+            };
 
-    inline void from_json(nlohmann::json const & json, Scene & scene)
-    {
-        detail::ReadOptionalField("name", json, scene.name);
-        detail::ReadOptionalField("nodes", json, scene.nodes);
+            uint8_t const * const end = data + length;
+            uint64_t hash;
+            if (length >= 32)
+            {
+                uint64_t v1 = seed + Prime1 + Prime2;
+                uint64_t v2 = seed + Prime2;
+                uint64_t v3 = seed;
+                uint64_t v4 = seed - Prime1;
+                for (; end - data >= 32; data += 32)
+                {
+                    v1 = round(v1, read64(data));
+                    v2 = round(v2, read64(data + 8));
+                    v3 = round(v3, read64(data + 16));
+                    v4 = round(v4, read64(data + 24));
+                }
+
+                hash = RotateLeft(v1, 1) + RotateLeft(v2, 7) + RotateLeft(v3, 12) + RotateLeft(v4, 18);
+                hash = mergeRound(mergeRound(mergeRound(mergeRound(hash, v1), v2), v3), v4);
+            }
+            else
+            {
+                hash = seed + Prime5;
+            }
+
+            hash += length;
+            for (; end - data >= 8; data += 8)
+            {
+                hash = RotateLeft(hash ^ round(0, read64(data)), 27) * Prime1 + Prime4;
+            }
+
+            if (end - data >= 4)
+            {
+                uint32_t value;
+                std::memcpy(&value, data, sizeof(value));
+                hash = RotateLeft(hash ^ (value * Prime1), 23) * Prime2 + Prime3;
+                data += 4;
+            }
+
+            for (; data < end; data++)
+            {
+                hash = RotateLeft(hash ^ (*data * Prime5), 11) * Prime1;
+            }
+
+            hash = (hash ^ (hash >> 33)) * Prime2;
+            hash = (hash ^ (hash >> 29)) * Prime3;
+            return hash ^ (hash >> 32);
+        }
+
+        // The index of the first element equal to each element, found among the elements sharing its hash
+        template <typename TEqual>
+        inline std::vector<uint32_t> FindFirstEqual(std::vector<uint64_t> const & hashes, TEqual && equal)
+        {
+            std::vector<uint32_t> order(hashes.size());
+            std::iota(order.begin(), order.end(), 0);
+            std::stable_sort(order.begin(), order.end(), [&hashes](uint32_t left, uint32_t right) { return hashes[left] < hashes[right]; });
+
+            std::vector<uint32_t> firstEqual(order.size());
+            std::iota(firstEqual.begin(), firstEqual.end(), 0);
+            for (std::size_t begin = 0, end = 0; begin < order.size(); begin = end)
+            {
+                while (end < order.size() && hashes[order[end]] == hashes[order[begin]])
+                {
+                    end++;
+                }
+
+                for (std::size_t current = begin + 1; current < end; current++)
+                {
+                    for (std::size_t candidate = begin; candidate < current; candidate++)
+                    {
+                        if (firstEqual[order[candidate]] == order[candidate] && equal(order[candidate], order[current]))
+                        {
+                            firstEqual[order[current]] = order[candidate];
+                            break;
+                        }
+                    }
+                }
+            }
+
+            return firstEqual;
+        }
+
+        // Removes every element equal to an earlier one and returns the new index of every old one
+        template <typename TElement>
+        inline std::vector<int32_t> RemoveDuplicates(std::vector<TElement> & elements, std::vector<uint32_t> const & firstEqual)
+        {
+            std::vector<bool> unique(elements.size());
+            for (std::size_t index = 0; index < elements.size(); index++)
+            {
+                unique[index] = firstEqual[index] == index;
+            }
+
+            std::vector<int32_t> newIndices = CompactElements(elements, unique);
+            for (std::size_t index = 0; index < newIndices.size(); index++)
+            {
+                newIndices[index] = newIndices[firstEqual[index]];
+            }
+
+            return newIndices;
+        }
+
+        // Hashes the bufferView contents in blocks, so large bufferViews are spread over the threads too
+        inline std::vector<uint64_t> HashBufferViews(Document const & document, std::vector<Span<uint8_t const>> const & contents, uint32_t maxThreadCount)
+        {
+            std::vector<std::size_t> firstBlock(contents.size() + 1);
+            for (std::size_t bufferViewIndex = 0; bufferViewIndex < contents.size(); bufferViewIndex++)
+            {
+                firstBlock[bufferViewIndex + 1] = firstBlock[bufferViewIndex] + (contents[bufferViewIndex].size() + HashBlockSize - 1) / HashBlockSize;
+            }
 
-        detail::ReadExtensionsAndExtras(json, scene.extensionsAndExtras);
-    }
+            std::vector<uint64_t> blockHashes(firstBlock.back());
+            ParallelFor(blockHashes.size(), maxThreadCount, [&](std::size_t block) {
+                const std::size_t bufferViewIndex = static_cast<std::size_t>(std::upper_bound(firstBlock.begin(), firstBlock.end(), block) - firstBlock.begin() - 1);
+                const std::size_t offset = (block - firstBlock[bufferViewIndex]) * HashBlockSize;
+                blockHashes[block] = Hash64(contents[bufferViewIndex].data() + offset, (std::min)(contents[bufferViewIndex].size() - offset, HashBlockSize));
+            });
 
-    inline void from_json(nlohmann::json const & json, Skin & skin)
-    {
-        detail::ReadRequiredField("joints", json, skin.joints);
+            std::vector<uint64_t> hashes(contents.size());
+            for (std::size_t bufferViewIndex = 0; bufferViewIndex < contents.size(); bufferViewIndex++)
+            {
+                const std::size_t blockCount = firstBlock[bufferViewIndex + 1] - firstBlock[bufferViewIndex];
+                hashes[bufferViewIndex] = Hash64(
+                    reinterpret_cast<uint8_t const *>(&blockHashes[firstBlock[bufferViewIndex]]), blockCount * sizeof(uint64_t), document.bufferViews[bufferViewIndex].byteLength);
+            }
 
-        detail::ReadOptionalField("inverseBindMatrices", json, skin.inverseBindMatrices);
-        detail::ReadOptionalField("name", json, skin.name);
-        detail::ReadOptionalField("skeleton", json, skin.skeleton);
+            return hashes;
+        }
 
-        detail::ReadExtensionsAndExtras(json, skin.extensionsAndExtras);
-    }
+        inline uint64_t HashAccessor(Accessor const & accessor) noexcept
+        {
+            const std::array<uint64_t, 12> fields{ static_cast<uint64_t>(accessor.bufferView), accessor.byteOffset, accessor.count, accessor.normalized,
+                static_cast<uint64_t>(accessor.componentType), static_cast<uint64_t>(accessor.type), static_cast<uint64_t>(accessor.sparse.count),
+                accessor.sparse.indices.bufferView, accessor.sparse.indices.byteOffset, static_cast<uint64_t>(accessor.sparse.indices.componentType),
+                accessor.sparse.values.bufferView, accessor.sparse.values.byteOffset };
 
-    inline void from_json(nlohmann::json const & json, Texture & texture)
-    {
-        detail::ReadOptionalField("name", json, texture.name);
-        detail::ReadOptionalField("sampler", json, texture.sampler);
-        detail::ReadOptionalField("source", json, texture.source);
+            return Hash64(reinterpret_cast<uint8_t const *>(fields.data()), sizeof(fields));
+        }
 
-        detail::ReadExtensionsAndExtras(json, texture.extensionsAndExtras);
-    }
+        inline bool AccessorsEqual(Accessor const & left, Accessor const & right)
+        {
+            return left.bufferView == right.bufferView && left.byteOffset == right.byteOffset && left.count == right.count && left.normalized == right.normalized &&
+                   left.componentType == right.componentType && left.type == right.type && left.min == right.min && left.max == right.max &&
+                   left.extensionsAndExtras == right.extensionsAndExtras && left.sparse.count == right.sparse.count &&
+                   (left.sparse.empty() ||
+                       (left.sparse.indices.bufferView == right.sparse.indices.bufferView && left.sparse.indices.byteOffset == right.sparse.indices.byteOffset &&
+                           left.sparse.indices.componentType == right.sparse.indices.componentType && left.sparse.values.bufferView == right.sparse.values.bufferView &&
+                           left.sparse.values.byteOffset == right.sparse.values.byteOffset && left.sparse.extensionsAndExtras == right.sparse.extensionsAndExtras &&
+                           left.sparse.indices.extensionsAndExtras == right.sparse.indices.extensionsAndExtras &&
+                           left.sparse.values.extensionsAndExtras == right.sparse.values.extensionsAndExtras));
+        }
+    } // namespace detail
 
-    inline void from_json(nlohmann::json const & json, Document & document)
+    // Merges the bufferViews holding identical bytes (with the same byteStride, target and extensions), then the
+    // accessors which describe identical data, and points every reference at the first of each. Names of the removed
+    // duplicates are lost. The duplicate bytes stay in their buffers until PackBuffers with DropUnreferencedBytes or
+    // RemoveUnusedData runs. Contents are hashed on up to maxThreadCount threads (0 uses all hardware threads).
+    // Indices held in extensions are neither followed nor rewritten.
+    inline void DeduplicateData(Document & document, uint32_t maxThreadCount = 1)
     {
-        detail::ReadRequiredField("asset", json, document.asset);
+        std::vector<Span<uint8_t const>> contents(document.bufferViews.size());
+        for (std::size_t bufferViewIndex = 0; bufferViewIndex < contents.size(); bufferViewIndex++)
+        {
+            contents[bufferViewIndex] = GetData(static_cast<Document const &>(document), document.bufferViews[bufferViewIndex]);
+        }
 
-        detail::ReadOptionalField("accessors", json, document.accessors);
-        detail::ReadOptionalField("animations", json, document.animations);
-        detail::ReadOptionalField("buffers", json, document.buffers);
-        detail::ReadOptionalField("bufferViews", json, document.bufferViews);
-        detail::ReadOptionalField("cameras", json, document.cameras);
-        detail::ReadOptionalField("materials", json, document.materials);
-        detail::ReadOptionalField("meshes", json, document.meshes);
-        detail::ReadOptionalField("nodes", json, document.nodes);
-        detail::ReadOptionalField("images", json, document.images);
-        detail::ReadOptionalField("samplers", json, document.samplers);
-        detail::ReadOptionalField("scene", json, document.scene);
-        detail::ReadOptionalField("scenes", json, document.scenes);
-        detail::ReadOptionalField("skins", json, document.skins);
-        detail::ReadOptionalField("textures", json, document.textures);
+        const std::vector<uint32_t> firstEqualBufferView =
+            detail::FindFirstEqual(detail::HashBufferViews(document, contents, maxThreadCount), [&](uint32_t left, uint32_t right) {
+                BufferView const & leftView = document.bufferViews[left];
+                BufferView const & rightView = document.bufferViews[right];
+                return leftView.byteLength == rightView.byteLength && leftView.byteStride == rightView.byteStride && leftView.target == rightView.target &&
+                       leftView.extensionsAndExtras == rightView.extensionsAndExtras &&
+                       (contents[left].data() == contents[right].data() || std::memcmp(contents[left].data(), contents[right].data(), contents[left].size()) == 0);
+            });
+
+        const std::vector<int32_t> bufferViewIndices = detail::RemoveDuplicates(document.bufferViews, firstEqualBufferView);
+        for (Accessor & accessor : document.accessors)
+        {
+            detail::RemapIndex(accessor.bufferView, bufferViewIndices);
+            if (!accessor.sparse.empty())
+            {
+                detail::RemapIndex(accessor.sparse.indices.bufferView, bufferViewIndices);
+                detail::RemapIndex(accessor.sparse.values.bufferView, bufferViewIndices);
+            }
+        }
 
-        detail::ReadOptionalField("extensionsUsed", json, document.extensionsUsed);
-        detail::ReadOptionalField("extensionsRequired", json, document.extensionsRequired);
-        detail::ReadExtensionsAndExtras(json, document.extensionsAndExtras);
-    }
+        for (Image & image : document.images)
+        {
+            if (image.uri.empty())
+            {
+                detail::RemapIndex(image.bufferView, bufferViewIndices);
+            }
+        }
 
-    inline void to_json(nlohmann::json & json, Accessor::ComponentType const & accessorComponentType)
-    {
-        if (accessorComponentType == Accessor::ComponentType::None)
+        std::vector<uint64_t> accessorHashes(document.accessors.size());
+        for (std::size_t accessorIndex = 0; accessorIndex < accessorHashes.size(); accessorIndex++)
         {
-            throw invalid_gltf_document("Unknown accessor.componentType value");
+            accessorHashes[accessorIndex] = detail::HashAccessor(document.accessors[accessorIndex]);
         }
 
-        json = static_cast<uint16_t>(accessorComponentType);
-    }
+        const std::vector<uint32_t> firstEqualAccessor = detail::FindFirstEqual(accessorHashes, [&document](uint32_t left, uint32_t right) {
+            return detail::AccessorsEqual(document.accessors[left], document.accessors[right]);
+        });
 
-    inline void to_json(nlohmann::json & json, Accessor::Type const & accessorType)
-    {
-        switch (accessorType)
+        const std::vector<int32_t> accessorIndices = detail::RemoveDuplicates(document.accessors, firstEqualAccessor);
+        for (Mesh & mesh : document.meshes)
         {
-        case Accessor::Type::Scalar:
-            json = "SCALAR";
-            break;
-        case Accessor::Type::Vec2:
-            json = "VEC2";
-            break;
-        case Accessor::Type::Vec3:
-            json = "VEC3";
-            break;
-        case Accessor::Type::Vec4:
-            json = "VEC4";
-            break;
-        case Accessor::Type::Mat2:
-            json = "MAT2";
-            break;
-        case Accessor::Type::Mat3:
-            json = "MAT3";
-            break;
-        case Accessor::Type::Mat4:
-            json = "MAT4";
-            break;
-        default:
-            throw invalid_gltf_document("Unknown accessor.type value");
-        }
-    }
+            for (Primitive & primitive : mesh.primitives)
+            {
+                detail::RemapIndex(primitive.indices, accessorIndices);
+                for (auto & attribute : primitive.attributes)
+                {
+                    detail::RemapIndex(attribute.second, accessorIndices);
+                }
 
-    inline void to_json(nlohmann::json & json, Accessor::Sparse::Values const & values)
-    {
-        detail::WriteField("bufferView", json, values.bufferView, static_cast<uint32_t>(-1));
-        detail::WriteField("byteOffset", json, values.byteOffset, {});
-        detail::WriteExtensions(json, values.extensionsAndExtras);
-    }
+                for (Attributes & target : primitive.targets)
+                {
+                    for (auto & attribute : target)
+                    {
+                        detail::RemapIndex(attribute.second, accessorIndices);
+                    }
+                }
+            }
+        }
 
-    inline void to_json(nlohmann::json & json, Accessor::Sparse::Indices const & indices)
-    {
-        detail::WriteField("componentType", json, indices.componentType, Accessor::ComponentType::None);
-        detail::WriteField("bufferView", json, indices.bufferView, static_cast<uint32_t>(-1));
-        detail::WriteField("byteOffset", json, indices.byteOffset, {});
-        detail::WriteExtensions(json, indices.extensionsAndExtras);
-    }
+        for (Skin & skin : document.skins)
+        {
+            detail::RemapIndex(skin.inverseBindMatrices, accessorIndices);
+        }
 
-    inline void to_json(nlohmann::json & json, Accessor::Sparse const & sparse)
-    {
-        detail::WriteField("count", json, sparse.count, -1);
-        detail::WriteField("indices", json, sparse.indices);
-        detail::WriteField("values", json, sparse.values);
-        detail::WriteExtensions(json, sparse.extensionsAndExtras);
+        for (Animation & animation : document.animations)
+        {
+            for (Animation::Sampler & sampler : animation.samplers)
+            {
+                detail::RemapIndex(sampler.input, accessorIndices);
+                detail::RemapIndex(sampler.output, accessorIndices);
+            }
+        }
     }
 
     namespace detail
     {
-        template <typename TType>
-        inline void WriteMinMaxConvert(nlohmann::json & json, Accessor const & accessor)
+        inline Accessor const & GetIndexAccessor(Document const & document, Primitive const & primitive)
         {
-            if (!accessor.min.empty())
+            Accessor const * accessor = FindElement(document.accessors, primitive.indices);
+            if (accessor == nullptr)
             {
-                auto & item = json["min"];
-                for (float v : accessor.min)
-                {
-                    item.push_back(static_cast<TType>(v));
-                }
+                throw invalid_gltf_document("Invalid primitive.indices value");
             }
 
-            if (!accessor.max.empty())
+            if (accessor->bufferView < 0 || !accessor->sparse.empty() || accessor->type != Accessor::Type::Scalar ||
+                (accessor->componentType != Accessor::ComponentType::UnsignedByte && accessor->componentType != Accessor::ComponentType::UnsignedShort &&
+                    accessor->componentType != Accessor::ComponentType::UnsignedInt))
             {
-                auto & item = json["max"];
-                for (float v : accessor.max)
-                {
-                    item.push_back(static_cast<TType>(v));
-                }
+                throw invalid_gltf_document("Invalid primitive.indices value : not a plain unsigned scalar accessor");
             }
+
+            return *accessor;
         }
 
-        inline void WriteAccessorMinMax(nlohmann::json & json, Accessor const & accessor)
+        inline std::vector<uint32_t> ReadIndices(Document const & document, Accessor const & accessor)
         {
-            switch (accessor.componentType)
+            std::vector<uint32_t> indices(accessor.count);
+            ConvertToUInt32(document, accessor, { indices.data(), indices.size() });
+            return indices;
+        }
+
+        // Copies contents held outside of Buffer::data (mapped, deferred, or shared with other documents through a
+        // SharedBufferCache) into it, so they can be modified without affecting anything else. Embedded buffers are
+        // re-encoded on save.
+        inline void DetachBufferData(Buffer & buffer)
+        {
+            if (buffer.externalData != nullptr || buffer.deferredData != nullptr)
             {
-            // fast path
-            case Accessor::ComponentType::Float:
-                detail::WriteField("max", json, accessor.max);
-                detail::WriteField("min", json, accessor.min);
-                break;
+                const Span<uint8_t const> contents = static_cast<Buffer const &>(buffer).GetData();
+                std::vector<uint8_t> data(contents.begin(), contents.end());
+                buffer.data.swap(data);
+                buffer.externalData.reset();
+                buffer.deferredData.reset();
+            }
 
-            // slow path conversions...
-            case Accessor::ComponentType::Byte:
-                WriteMinMaxConvert<int8_t>(json, accessor);
-                break;
-            case Accessor::ComponentType::UnsignedByte:
-                WriteMinMaxConvert<uint8_t>(json, accessor);
-                break;
-            case Accessor::ComponentType::Short:
-                WriteMinMaxConvert<int16_t>(json, accessor);
-                break;
-            case Accessor::ComponentType::UnsignedShort:
-                WriteMinMaxConvert<uint16_t>(json, accessor);
-                break;
-            case Accessor::ComponentType::UnsignedInt:
-                WriteMinMaxConvert<uint32_t>(json, accessor);
-                break;
-            case Accessor::ComponentType::None:
-                break;
+            if (buffer.IsEmbeddedResource())
+            {
+                buffer.SetEmbeddedResourceOnSave();
             }
         }
-    } // namespace detail
 
-    inline void to_json(nlohmann::json & json, Accessor const & accessor)
-    {
-        detail::WriteField("bufferView", json, accessor.bufferView, -1);
-        detail::WriteField("byteOffset", json, accessor.byteOffset, {});
-        detail::WriteField("componentType", json, accessor.componentType, Accessor::ComponentType::None);
-        detail::WriteField("count", json, accessor.count, {});
-        detail::WriteAccessorMinMax(json, accessor);
-        detail::WriteField("name", json, accessor.name);
-        detail::WriteField("normalized", json, accessor.normalized, false);
-        detail::WriteField("sparse", json, accessor.sparse);
-        detail::WriteField("type", json, accessor.type, Accessor::Type::None);
-        detail::WriteExtensions(json, accessor.extensionsAndExtras);
-    }
+        // The accessor's bytes, as GetData, once its buffer is detached for writing in place
+        inline Span<uint8_t> GetWritableData(Document & document, Accessor const & accessor)
+        {
+            BufferView const * bufferView = FindElement(document.bufferViews, accessor.bufferView);
+            if (bufferView != nullptr && FindElement(document.buffers, bufferView->buffer) != nullptr)
+            {
+                DetachBufferData(document.buffers[static_cast<std::size_t>(bufferView->buffer)]);
+            }
 
-    inline void to_json(nlohmann::json & json, Animation::Channel::Target const & animationChannelTarget)
-    {
-        detail::WriteField("node", json, animationChannelTarget.node, -1);
-        detail::WriteField("path", json, animationChannelTarget.path);
-        detail::WriteExtensions(json, animationChannelTarget.extensionsAndExtras);
-    }
+            return GetData(document, accessor);
+        }
 
-    inline void to_json(nlohmann::json & json, Animation::Channel const & animationChannel)
-    {
-        detail::WriteField("sampler", json, animationChannel.sampler, -1);
-        detail::WriteField("target", json, animationChannel.target);
-        detail::WriteExtensions(json, animationChannel.extensionsAndExtras);
-    }
+        // Throws unless the bufferViews of the given accessors are used by nothing but those accessors, so their
+        // bytes can be rewritten in place
+        inline void CheckExclusiveBufferViews(Document const & document, std::vector<uint32_t> const & accessors)
+        {
+            std::vector<bool> written(document.bufferViews.size());
+            for (uint32_t accessorIndex : accessors)
+            {
+                const int32_t bufferView = document.accessors[accessorIndex].bufferView;
+                if (FindElement(document.bufferViews, bufferView) != nullptr)
+                {
+                    written[static_cast<std::size_t>(bufferView)] = true;
+                }
+            }
 
-    inline void to_json(nlohmann::json & json, Animation::Sampler::Type const & animationSamplerType)
-    {
-        switch (animationSamplerType)
+            auto check = [&written](int64_t bufferView) {
+                if (bufferView >= 0 && static_cast<uint64_t>(bufferView) < written.size() && written[static_cast<std::size_t>(bufferView)])
+                {
+                    throw invalid_gltf_document("Invalid primitive : bufferView data is shared with other accessors or images");
+                }
+            };
+
+            for (std::size_t accessorIndex = 0; accessorIndex < document.accessors.size(); accessorIndex++)
+            {
+                Accessor const & accessor = document.accessors[accessorIndex];
+                if (std::find(accessors.begin(), accessors.end(), static_cast<uint32_t>(accessorIndex)) == accessors.end())
+                {
+                    check(accessor.bufferView);
+                }
+
+                check(accessor.sparse.empty() ? -1 : accessor.sparse.indices.bufferView);
+                check(accessor.sparse.empty() ? -1 : accessor.sparse.values.bufferView);
+            }
+
+            for (Image const & image : document.images)
+            {
+                check(image.uri.empty() ? image.bufferView : -1);
+            }
+        }
+
+        // Writes the values back in the accessor's component type; glTF data is always little endian
+        inline void WriteIndices(Document & document, Accessor const & accessor, std::vector<uint32_t> const & indices)
         {
-        case Animation::Sampler::Type::Linear:
-            json = "LINEAR";
-            break;
-        case Animation::Sampler::Type::Step:
-            json = "STEP";
-            break;
-        case Animation::Sampler::Type::CubicSpline:
-            json = "CUBICSPLINE";
-            break;
+            const AccessorLayout layout = GetAccessorLayout(document, accessor);
+            const uint32_t componentSize = GetComponentSize(accessor.componentType);
+            uint8_t * data = GetWritableData(document, accessor).data();
+            for (std::size_t i = 0; i < indices.size(); i++)
+            {
+                for (uint32_t byte = 0; byte < componentSize; byte++)
+                {
+                    data[i * layout.stride + byte] = static_cast<uint8_t>(indices[i] >> (8 * byte));
+                }
+            }
         }
-    }
 
-    inline void to_json(nlohmann::json & json, Animation::Sampler const & animationSampler)
-    {
-        detail::WriteField("input", json, animationSampler.input, -1);
-        detail::WriteField("interpolation", json, animationSampler.interpolation, Animation::Sampler::Type::Linear);
-        detail::WriteField("output", json, animationSampler.output, -1);
-        detail::WriteExtensions(json, animationSampler.extensionsAndExtras);
-    }
+        // Tipsify (Sander, Nehab and Barczak, "Fast Triangle Reordering for Vertex Locality and Reduced Overdraw").
+        // Fans around a vertex, then continues with the neighbour most likely to still be in a FIFO cache of
+        // cacheSize entries. Runs in time linear to the index count and keeps the winding of every triangle.
+        inline std::vector<uint32_t> ReorderTriangles(std::vector<uint32_t> const & indices, uint32_t vertexCount, uint32_t cacheSize)
+        {
+            std::vector<uint32_t> liveTriangles(vertexCount);
+            for (uint32_t index : indices)
+            {
+                liveTriangles[index]++;
+            }
 
-    inline void to_json(nlohmann::json & json, Animation const & animation)
-    {
-        detail::WriteField("channels", json, animation.channels);
-        detail::WriteField("name", json, animation.name);
-        detail::WriteField("samplers", json, animation.samplers);
-        detail::WriteExtensions(json, animation.extensionsAndExtras);
-    }
+            std::vector<std::size_t> adjacencyOffsets(static_cast<std::size_t>(vertexCount) + 1);
+            for (uint32_t vertex = 0; vertex < vertexCount; vertex++)
+            {
+                adjacencyOffsets[vertex + 1] = adjacencyOffsets[vertex] + liveTriangles[vertex];
+            }
 
-    inline void to_json(nlohmann::json & json, Asset const & asset)
-    {
-        detail::WriteField("copyright", json, asset.copyright);
-        detail::WriteField("generator", json, asset.generator);
-        detail::WriteField("minVersion", json, asset.minVersion);
-        detail::WriteField("version", json, asset.version);
-        detail::WriteExtensions(json, asset.extensionsAndExtras);
-    }
+            std::vector<uint32_t> adjacency(indices.size());
+            std::vector<std::size_t> adjacencyEnds(adjacencyOffsets.begin(), adjacencyOffsets.end() - 1);
+            for (std::size_t corner = 0; corner < indices.size(); corner++)
+            {
+                adjacency[adjacencyEnds[indices[corner]]++] = static_cast<uint32_t>(corner / 3);
+            }
 
-    inline void to_json(nlohmann::json & json, Buffer const & buffer)
-    {
-        detail::WriteField("byteLength", json, buffer.byteLength, {});
-        detail::WriteField("name", json, buffer.name);
-        detail::WriteField("uri", json, buffer.uri);
-        detail::WriteExtensions(json, buffer.extensionsAndExtras);
-    }
+            std::vector<uint32_t> cacheTime(vertexCount);
+            std::vector<bool> emitted(indices.size() / 3);
+            std::vector<uint32_t> deadEnds{};
+            std::vector<uint32_t> candidates{};
+            std::vector<uint32_t> output{};
+            output.reserve(indices.size());
+
+            uint32_t time = cacheSize + 1;
+            uint32_t cursor = 0;
+            int64_t fanning = vertexCount > 0 ? 0 : -1;
+            while (fanning >= 0)
+            {
+                candidates.clear();
+                const std::size_t vertex = static_cast<std::size_t>(fanning);
+                for (std::size_t next = adjacencyOffsets[vertex]; next < adjacencyOffsets[vertex + 1]; next++)
+                {
+                    const uint32_t triangle = adjacency[next];
+                    if (emitted[triangle])
+                    {
+                        continue;
+                    }
 
-    inline void to_json(nlohmann::json & json, BufferView const & bufferView)
-    {
-        detail::WriteField("buffer", json, bufferView.buffer, -1);
-        detail::WriteField("byteLength", json, bufferView.byteLength, {});
-        detail::WriteField("byteOffset", json, bufferView.byteOffset, {});
-        detail::WriteField("byteStride", json, bufferView.byteStride, {});
-        detail::WriteField("name", json, bufferView.name);
-        detail::WriteField("target", json, bufferView.target, BufferView::TargetType::None);
-        detail::WriteExtensions(json, bufferView.extensionsAndExtras);
-    }
+                    emitted[triangle] = true;
+                    for (std::size_t corner = triangle * std::size_t{ 3 }; corner < triangle * std::size_t{ 3 } + 3; corner++)
+                    {
+                        const uint32_t cornerVertex = indices[corner];
+                        output.push_back(cornerVertex);
+                        deadEnds.push_back(cornerVertex);
+                        candidates.push_back(cornerVertex);
+                        liveTriangles[cornerVertex]--;
+                        if (time - cacheTime[cornerVertex] > cacheSize)
+                        {
+                            cacheTime[cornerVertex] = time++;
+                        }
+                    }
+                }
+
+                // Prefer the candidate which stays in the cache longest once its remaining triangles are emitted
+                fanning = -1;
+                int64_t bestPriority = -1;
+                for (uint32_t candidate : candidates)
+                {
+                    if (liveTriangles[candidate] > 0)
+                    {
+                        const int64_t age = static_cast<int64_t>(time) - cacheTime[candidate];
+                        const int64_t priority = age + 2 * static_cast<int64_t>(liveTriangles[candidate]) <= cacheSize ? age : 0;
+                        if (priority > bestPriority)
+                        {
+                            bestPriority = priority;
+                            fanning = candidate;
+                        }
+                    }
+                }
 
-    inline void to_json(nlohmann::json & json, Camera::Type const & cameraType)
-    {
-        switch (cameraType)
-        {
-        case Camera::Type::Orthographic:
-            json = "orthographic";
-            break;
-        case Camera::Type::Perspective:
-            json = "perspective";
-            break;
-        default:
-            throw invalid_gltf_document("Unknown camera.type value");
-        }
-    }
+                while (fanning < 0 && !deadEnds.empty())
+                {
+                    if (liveTriangles[deadEnds.back()] > 0)
+                    {
+                        fanning = deadEnds.back();
+                    }
 
-    inline void to_json(nlohmann::json & json, Camera::Orthographic const & camera)
-    {
-        detail::WriteField("xmag", json, camera.xmag, defaults::FloatSentinel);
-        detail::WriteField("ymag", json, camera.ymag, defaults::FloatSentinel);
-        detail::WriteField("zfar", json, camera.zfar, -defaults::FloatSentinel);
-        detail::WriteField("znear", json, camera.znear, -defaults::FloatSentinel);
-        detail::WriteExtensions(json, camera.extensionsAndExtras);
-    }
+                    deadEnds.pop_back();
+                }
 
-    inline void to_json(nlohmann::json & json, Camera::Perspective const & camera)
-    {
-        detail::WriteField("aspectRatio", json, camera.aspectRatio, {});
-        detail::WriteField("yfov", json, camera.yfov, {});
-        detail::WriteField("zfar", json, camera.zfar, {});
-        detail::WriteField("znear", json, camera.znear, {});
-        detail::WriteExtensions(json, camera.extensionsAndExtras);
-    }
+                while (fanning < 0 && cursor < vertexCount)
+                {
+                    if (liveTriangles[cursor] > 0)
+                    {
+                        fanning = cursor;
+                    }
 
-    inline void to_json(nlohmann::json & json, Camera const & camera)
-    {
-        detail::WriteField("name", json, camera.name);
-        detail::WriteField("type", json, camera.type, Camera::Type::None);
-        detail::WriteExtensions(json, camera.extensionsAndExtras);
+                    cursor++;
+                }
+            }
 
-        if (camera.type == Camera::Type::Perspective)
-        {
-            detail::WriteField("perspective", json, camera.perspective);
+            return output;
         }
-        else if (camera.type == Camera::Type::Orthographic)
+
+        // The distinct, sorted attribute and morph target accessors of a primitive which rewrites its vertex data in
+        // place. They (and the index accessor) must not be used by another primitive, must not be sparse and must all
+        // have the same count. Their bufferViews must not hold data of any other accessor or image.
+        inline std::vector<uint32_t> GetExclusiveVertexAccessors(Document const & document, Primitive const & primitive)
         {
-            detail::WriteField("orthographic", json, camera.orthographic);
-        }
-    }
+            std::vector<uint32_t> vertexAccessors{};
+            for (auto const & attribute : primitive.attributes)
+            {
+                vertexAccessors.push_back(attribute.second);
+            }
 
-    inline void to_json(nlohmann::json & json, Image const & image)
-    {
-        detail::WriteField("bufferView", json, image.bufferView, image.uri.empty() ? -1 : 0); // bufferView or uri need to be written; even if default 0
-        detail::WriteField("mimeType", json, image.mimeType);
-        detail::WriteField("name", json, image.name);
-        detail::WriteField("uri", json, image.uri);
-        detail::WriteExtensions(json, image.extensionsAndExtras);
-    }
+            for (Attributes const & target : primitive.targets)
+            {
+                for (auto const & attribute : target)
+                {
+                    vertexAccessors.push_back(attribute.second);
+                }
+            }
 
-    inline void to_json(nlohmann::json & json, Material::AlphaMode const & materialAlphaMode)
-    {
-        switch (materialAlphaMode)
-        {
-        case Material::AlphaMode::Opaque:
-            json = "OPAQUE";
-            break;
-        case Material::AlphaMode::Mask:
-            json = "MASK";
-            break;
-        case Material::AlphaMode::Blend:
-            json = "BLEND";
-            break;
-        }
-    }
+            std::sort(vertexAccessors.begin(), vertexAccessors.end());
+            vertexAccessors.erase(std::unique(vertexAccessors.begin(), vertexAccessors.end()), vertexAccessors.end());
+            if (vertexAccessors.empty())
+            {
+                throw invalid_gltf_document("Invalid primitive.attributes value : no attributes");
+            }
 
-    inline void to_json(nlohmann::json & json, Material::Texture const & materialTexture)
-    {
-        detail::WriteField("index", json, materialTexture.index, -1);
-        detail::WriteField("texCoord", json, materialTexture.texCoord, 0);
-        detail::WriteExtensions(json, materialTexture.extensionsAndExtras);
-    }
+            for (uint32_t accessorIndex : vertexAccessors)
+            {
+                Accessor const * accessor = FindElement(document.accessors, accessorIndex);
+                if (accessor == nullptr)
+                {
+                    throw invalid_gltf_document("Invalid primitive.attributes value");
+                }
 
-    inline void to_json(nlohmann::json & json, Material::NormalTexture const & materialTexture)
-    {
-        to_json(json, static_cast<Material::Texture const &>(materialTexture));
-        detail::WriteField("scale", json, materialTexture.scale, defaults::IdentityScalar);
-        detail::WriteExtensions(json, materialTexture.extensionsAndExtras);
-    }
+                if (!accessor->sparse.empty() || accessor->count != document.accessors[vertexAccessors.front()].count)
+                {
+                    throw invalid_gltf_document("Invalid primitive.attributes value : sparse or differing vertex counts");
+                }
+            }
 
-    inline void to_json(nlohmann::json & json, Material::OcclusionTexture const & materialTexture)
-    {
-        to_json(json, static_cast<Material::Texture const &>(materialTexture));
-        detail::WriteField("strength", json, materialTexture.strength, defaults::IdentityScalar);
-        detail::WriteExtensions(json, materialTexture.extensionsAndExtras);
-    }
+            for (Mesh const & mesh : document.meshes)
+            {
+                for (Primitive const & other : mesh.primitives)
+                {
+                    if (&other == &primitive)
+                    {
+                        continue;
+                    }
 
-    inline void to_json(nlohmann::json & json, Material::PBRMetallicRoughness const & pbrMetallicRoughness)
-    {
-        detail::WriteField("baseColorFactor", json, pbrMetallicRoughness.baseColorFactor, defaults::IdentityVec4);
-        detail::WriteField("baseColorTexture", json, pbrMetallicRoughness.baseColorTexture);
-        detail::WriteField("metallicFactor", json, pbrMetallicRoughness.metallicFactor, defaults::IdentityScalar);
-        detail::WriteField("metallicRoughnessTexture", json, pbrMetallicRoughness.metallicRoughnessTexture);
-        detail::WriteField("roughnessFactor", json, pbrMetallicRoughness.roughnessFactor, defaults::IdentityScalar);
-        detail::WriteExtensions(json, pbrMetallicRoughness.extensionsAndExtras);
-    }
+                    bool shared = primitive.indices >= 0 && other.indices == primitive.indices;
+                    auto check = [&shared, &vertexAccessors](Attributes const & attributes) {
+                        for (auto const & attribute : attributes)
+                        {
+                            shared = shared || std::binary_search(vertexAccessors.begin(), vertexAccessors.end(), attribute.second);
+                        }
+                    };
 
-    inline void to_json(nlohmann::json & json, Material const & material)
-    {
-        detail::WriteField("alphaCutoff", json, material.alphaCutoff, defaults::MaterialAlphaCutoff);
-        detail::WriteField("alphaMode", json, material.alphaMode, Material::AlphaMode::Opaque);
-        detail::WriteField("doubleSided", json, material.doubleSided, defaults::MaterialDoubleSided);
-        detail::WriteField("emissiveTexture", json, material.emissiveTexture);
-        detail::WriteField("emissiveFactor", json, material.emissiveFactor, defaults::NullVec3);
-        detail::WriteField("name", json, material.name);
-        detail::WriteField("normalTexture", json, material.normalTexture);
-        detail::WriteField("occlusionTexture", json, material.occlusionTexture);
-        detail::WriteField("pbrMetallicRoughness", json, material.pbrMetallicRoughness);
+                    check(other.attributes);
+                    for (Attributes const & target : other.targets)
+                    {
+                        check(target);
+                    }
 
-        detail::WriteExtensions(json, material.extensionsAndExtras);
-    }
+                    if (shared)
+                    {
+                        throw invalid_gltf_document("Invalid primitive : accessors are shared with another primitive");
+                    }
+                }
+            }
 
-    inline void to_json(nlohmann::json & json, Mesh const & mesh)
-    {
-        detail::WriteField("name", json, mesh.name);
-        detail::WriteField("primitives", json, mesh.primitives);
-        detail::WriteField("weights", json, mesh.weights);
-        detail::WriteExtensions(json, mesh.extensionsAndExtras);
-    }
+            std::vector<uint32_t> writtenAccessors = vertexAccessors;
+            if (FindElement(document.accessors, primitive.indices) != nullptr)
+            {
+                writtenAccessors.push_back(static_cast<uint32_t>(primitive.indices));
+            }
 
-    inline void to_json(nlohmann::json & json, Node const & node)
-    {
-        detail::WriteField("camera", json, node.camera, -1);
-        detail::WriteField("children", json, node.children);
-        detail::WriteField("matrix", json, node.matrix, defaults::IdentityMatrix);
-        detail::WriteField("mesh", json, node.mesh, -1);
-        detail::WriteField("name", json, node.name);
-        detail::WriteField("rotation", json, node.rotation, defaults::IdentityRotation);
-        detail::WriteField("scale", json, node.scale, defaults::IdentityVec3);
-        detail::WriteField("skin", json, node.skin, -1);
-        detail::WriteField("translation", json, node.translation, defaults::NullVec3);
-        detail::WriteField("weights", json, node.weights);
-        detail::WriteExtensions(json, node.extensionsAndExtras);
-    }
+            CheckExclusiveBufferViews(document, writtenAccessors);
+            return vertexAccessors;
+        }
 
-    inline void to_json(nlohmann::json & json, Primitive const & primitive)
-    {
-        detail::WriteField("attributes", json, primitive.attributes);
-        detail::WriteField("indices", json, primitive.indices, -1);
-        detail::WriteField("material", json, primitive.material, -1);
-        detail::WriteField("mode", json, primitive.mode, Primitive::Mode::Triangles);
-        detail::WriteField("targets", json, primitive.targets);
-        detail::WriteExtensions(json, primitive.extensionsAndExtras);
-    }
+        // Moves element i of the accessor to position newIndices[i]
+        inline void PermuteElements(Document & document, Accessor const & accessor, std::vector<uint32_t> const & newIndices)
+        {
+            const AccessorLayout layout = GetAccessorLayout(document, accessor);
+            if (layout.data == nullptr)
+            {
+                return;
+            }
+
+            std::vector<uint8_t> elements(static_cast<std::size_t>(accessor.count) * layout.elementSize);
+            for (std::size_t i = 0; i < accessor.count; i++)
+            {
+                std::memcpy(&elements[i * layout.elementSize], layout.data + i * layout.stride, layout.elementSize);
+            }
+
+            uint8_t * data = GetWritableData(document, accessor).data();
+            for (std::size_t i = 0; i < accessor.count; i++)
+            {
+                std::memcpy(data + newIndices[i] * layout.stride, &elements[i * layout.elementSize], layout.elementSize);
+            }
+        }
+    } // namespace detail
 
-    inline void to_json(nlohmann::json & json, Sampler const & sampler)
+    // Reorders the triangles of an indexed triangle list so that vertices are reused while still in the GPU's
+    // post-transform cache (Tipsify; cacheSize is the number of vertices that cache holds). Only the index data is
+    // rewritten, in place; any other primitive sharing the index accessor sees the same triangles in the new order.
+    // No other accessor or image may use the index bufferView. Buffers shared with other documents are copied first.
+    inline void OptimizeVertexCache(Document & document, Primitive const & primitive, uint32_t cacheSize = 16)
     {
-        if (!sampler.empty())
+        if (primitive.mode != Primitive::Mode::Triangles)
         {
-            detail::WriteField("name", json, sampler.name);
-            detail::WriteField("magFilter", json, sampler.magFilter, Sampler::MagFilter::None);
-            detail::WriteField("minFilter", json, sampler.minFilter, Sampler::MinFilter::None);
-            detail::WriteField("wrapS", json, sampler.wrapS, Sampler::WrappingMode::Repeat);
-            detail::WriteField("wrapT", json, sampler.wrapT, Sampler::WrappingMode::Repeat);
-            detail::WriteExtensions(json, sampler.extensionsAndExtras);
+            throw invalid_gltf_document("Invalid primitive.mode value : only triangle lists can be reordered");
         }
-        else
+
+        Accessor const & indexAccessor = detail::GetIndexAccessor(document, primitive);
+        detail::CheckExclusiveBufferViews(document, { static_cast<uint32_t>(primitive.indices) });
+
+        std::vector<uint32_t> indices = detail::ReadIndices(document, indexAccessor);
+        if (indices.size() % 3 != 0)
         {
-            // If a sampler is completely empty we still need to write out an empty object for the encompassing array...
-            json = nlohmann::json::object();
+            throw invalid_gltf_document("Invalid accessor.count value : not a multiple of 3");
         }
-    }
 
-    inline void to_json(nlohmann::json & json, Scene const & scene)
-    {
-        detail::WriteField("name", json, scene.name);
-        detail::WriteField("nodes", json, scene.nodes);
-        detail::WriteExtensions(json, scene.extensionsAndExtras);
-    }
+        const uint32_t maxIndex = indices.empty() ? 0 : *std::max_element(indices.begin(), indices.end());
+        if (maxIndex == std::numeric_limits<uint32_t>::max())
+        {
+            throw invalid_gltf_document("Invalid primitive.indices value : primitive restart value");
+        }
 
-    inline void to_json(nlohmann::json & json, Skin const & skin)
-    {
-        detail::WriteField("inverseBindMatrices", json, skin.inverseBindMatrices, -1);
-        detail::WriteField("name", json, skin.name);
-        detail::WriteField("skeleton", json, skin.skeleton, -1);
-        detail::WriteField("joints", json, skin.joints);
-        detail::WriteExtensions(json, skin.extensionsAndExtras);
+        const uint32_t vertexCount = indices.empty() ? 0 : maxIndex + 1;
+        detail::WriteIndices(document, indexAccessor, detail::ReorderTriangles(indices, vertexCount, cacheSize));
     }
 
-    inline void to_json(nlohmann::json & json, Texture const & texture)
+    // Renumbers the vertices of an indexed primitive in the order its indices first use them and moves the data of
+    // every attribute and morph target accessor to match, so vertices are fetched from memory sequentially. Vertices
+    // no index uses keep their relative order at the end. Run after OptimizeVertexCache. The accessors are rewritten
+    // in place and must not be used by any other primitive, nor share bufferViews with other accessors. Buffers
+    // shared with other documents are copied first.
+    inline void OptimizeVertexFetch(Document & document, Primitive const & primitive)
     {
-        detail::WriteField("name", json, texture.name);
-        detail::WriteField("sampler", json, texture.sampler, -1);
-        detail::WriteField("source", json, texture.source, -1);
-        detail::WriteExtensions(json, texture.extensionsAndExtras);
-    }
+        const std::vector<uint32_t> vertexAccessors = detail::GetExclusiveVertexAccessors(document, primitive);
+        Accessor const & indexAccessor = detail::GetIndexAccessor(document, primitive);
+
+        const uint32_t vertexCount = document.accessors[vertexAccessors.front()].count;
+        std::vector<uint32_t> indices = detail::ReadIndices(document, indexAccessor);
+        std::vector<uint32_t> newIndices(vertexCount, std::numeric_limits<uint32_t>::max());
+        uint32_t nextIndex = 0;
+        for (uint32_t & index : indices)
+        {
+            if (index >= vertexCount)
+            {
+                throw invalid_gltf_document("Invalid primitive.indices value : index exceeds the vertex count");
+            }
 
-    inline void to_json(nlohmann::json & json, Document const & document)
-    {
-        detail::WriteField("accessors", json, document.accessors);
-        detail::WriteField("animations", json, document.animations);
-        detail::WriteField("asset", json, document.asset);
-        detail::WriteField("buffers", json, document.buffers);
-        detail::WriteField("bufferViews", json, document.bufferViews);
-        detail::WriteField("cameras", json, document.cameras);
-        detail::WriteField("images", json, document.images);
-        detail::WriteField("materials", json, document.materials);
-        detail::WriteField("meshes", json, document.meshes);
-        detail::WriteField("nodes", json, document.nodes);
-        detail::WriteField("samplers", json, document.samplers);
-        detail::WriteField("scene", json, document.scene, -1);
-        detail::WriteField("scenes", json, document.scenes);
-        detail::WriteField("skins", json, document.skins);
-        detail::WriteField("textures", json, document.textures);
+            if (newIndices[index] == std::numeric_limits<uint32_t>::max())
+            {
+                newIndices[index] = nextIndex++;
+            }
+
+            index = newIndices[index];
+        }
+
+        for (uint32_t & newIndex : newIndices)
+        {
+            if (newIndex == std::numeric_limits<uint32_t>::max())
+            {
+                newIndex = nextIndex++;
+            }
+        }
 
-        detail::WriteField("extensionsUsed", json, document.extensionsUsed);
-        detail::WriteField("extensionsRequired", json, document.extensionsRequired);
-        detail::WriteExtensions(json, document.extensionsAndExtras);
+        for (uint32_t accessorIndex : vertexAccessors)
+        {
+            detail::PermuteElements(document, document.accessors[accessorIndex], newIndices);
+        }
+
+        detail::WriteIndices(document, indexAccessor, indices);
     }
 
     namespace detail
     {
-        struct DataContext
+        // Appends bytes at the end of a buffer, aligned to `alignment`, and returns their offset. Contents held
+        // outside of Buffer::data (mapped, deferred) are copied into it first, and embedded buffers are re-encoded
+        // on save.
+        inline uint64_t AppendToBuffer(Buffer & buffer, uint8_t const * bytes, std::size_t length, uint32_t alignment)
         {
-            FX_GLTF_FILESYSTEM::path bufferRootPath{};
-            ReadQuotas readQuotas;
+            DetachBufferData(buffer);
 
-            std::vector<uint8_t> * binaryData{};
-        };
+            const std::size_t offset = (buffer.data.size() + alignment - 1) / alignment * alignment;
+            buffer.data.resize(offset);
+            buffer.data.insert(buffer.data.end(), bytes, bytes + length);
+            buffer.byteLength = buffer.data.size();
+            return offset;
+        }
 
-        inline void ThrowIfBad(std::ios const & io)
+        // Adds a bufferView over new data appended to `bufferIndex`, or to the first buffer when that one does not
+        // exist (creating it for empty documents). Returns the index of the new bufferView.
+        inline int32_t AppendBufferView(Document & document, int32_t bufferIndex, std::vector<uint8_t> const & bytes, BufferView::TargetType target, uint32_t byteStride = 0)
         {
-            if (!io.good())
+            if (FindElement(document.buffers, bufferIndex) == nullptr)
             {
-                throw std::system_error(std::make_error_code(std::errc::io_error));
+                if (document.buffers.empty())
+                {
+                    document.buffers.emplace_back();
+                }
+
+                bufferIndex = 0;
             }
+
+            BufferView bufferView{};
+            bufferView.buffer = bufferIndex;
+            bufferView.byteOffset = AppendToBuffer(document.buffers[static_cast<std::size_t>(bufferIndex)], bytes.data(), bytes.size(), 4);
+            bufferView.byteLength = bytes.size();
+            bufferView.byteStride = byteStride;
+            bufferView.target = target;
+            document.bufferViews.push_back(std::move(bufferView));
+            return static_cast<int32_t>(document.bufferViews.size() - 1);
         }
 
-        inline void MaterializeData(Buffer & buffer)
+        // Adds a tightly packed accessor over new data; see AppendBufferView. Returns the index of the new accessor.
+        inline int32_t AppendAccessor(Document & document, int32_t bufferIndex, Accessor accessor, std::vector<uint8_t> const & bytes, BufferView::TargetType target)
         {
-            std::size_t startPos = 0;
-            if (buffer.uri.find(detail::MimetypeApplicationOctet) == 0)
-            {
-                startPos = std::char_traits<char>::length(detail::MimetypeApplicationOctet) + 1;
-            }
-            else if (buffer.uri.find(detail::MimetypeGLTFBuffer) == 0)
-            {
-                startPos = std::char_traits<char>::length(detail::MimetypeGLTFBuffer) + 1;
-            }
+            accessor.bufferView = AppendBufferView(document, bufferIndex, bytes, target);
+            accessor.byteOffset = 0;
+            document.accessors.push_back(std::move(accessor));
+            return static_cast<int32_t>(document.accessors.size() - 1);
+        }
 
-            const std::size_t base64Length = buffer.uri.length() - startPos;
-            const std::size_t decodedEstimate = base64Length / 4 * 3;
-            if (startPos == 0 || (decodedEstimate - 2) > buffer.byteLength) // we need to give room for padding...
+        // Shortens the bufferViews which only the given accessors use to the bytes those accessors still cover
+        inline void TrimBufferViews(Document & document, std::vector<uint32_t> const & accessors)
+        {
+            std::vector<uint64_t> usedLength(document.bufferViews.size());
+            std::vector<bool> trimmable(document.bufferViews.size());
+            for (uint32_t accessorIndex : accessors)
             {
-                throw invalid_gltf_document("Invalid buffer.uri value", "malformed base64");
+                Accessor const & accessor = document.accessors[accessorIndex];
+                if (accessor.bufferView >= 0 && accessor.count > 0)
+                {
+                    const AccessorLayout layout = GetAccessorLayout(document, accessor);
+                    const std::size_t bufferView = static_cast<std::size_t>(accessor.bufferView);
+                    trimmable[bufferView] = true;
+                    usedLength[bufferView] = (std::max)(usedLength[bufferView], accessor.byteOffset + layout.stride * (accessor.count - 1) + layout.elementSize);
+                }
             }
 
-#if defined(FX_GLTF_HAS_CPP_17)
-            const bool success = base64::TryDecode({ &buffer.uri[startPos], base64Length }, buffer.data);
-#else
-            const bool success = base64::TryDecode(buffer.uri.substr(startPos), buffer.data);
-#endif
-            if (!success)
+            auto keep = [&trimmable](int64_t bufferView) {
+                if (bufferView >= 0 && static_cast<uint64_t>(bufferView) < trimmable.size())
+                {
+                    trimmable[static_cast<std::size_t>(bufferView)] = false;
+                }
+            };
+
+            for (std::size_t accessorIndex = 0; accessorIndex < document.accessors.size(); accessorIndex++)
             {
-                throw invalid_gltf_document("Invalid buffer.uri value", "malformed base64");
-            }
-        }
+                Accessor const & accessor = document.accessors[accessorIndex];
+                if (!std::binary_search(accessors.begin(), accessors.end(), static_cast<uint32_t>(accessorIndex)))
+                {
+                    keep(accessor.bufferView);
+                }
 
-        inline Document Create(nlohmann::json const & json, DataContext const & dataContext)
-        {
-            Document document = json;
+                keep(accessor.sparse.empty() ? -1 : accessor.sparse.indices.bufferView);
+                keep(accessor.sparse.empty() ? -1 : accessor.sparse.values.bufferView);
+            }
 
-            if (document.buffers.size() > dataContext.readQuotas.MaxBufferCount)
+            for (Image const & image : document.images)
             {
-                throw invalid_gltf_document("Quota exceeded : number of buffers > MaxBufferCount");
+                keep(image.uri.empty() ? image.bufferView : -1);
             }
 
-            for (auto & buffer : document.buffers)
+            for (std::size_t bufferView = 0; bufferView < trimmable.size(); bufferView++)
             {
-                if (buffer.byteLength == 0)
+                if (trimmable[bufferView])
                 {
-                    throw invalid_gltf_document("Invalid buffer.byteLength value : 0");
+                    document.bufferViews[bufferView].byteLength = usedLength[bufferView];
                 }
+            }
+        }
 
-                if (buffer.byteLength > dataContext.readQuotas.MaxBufferByteLength)
+        // An open addressing (linear probing) set of vertex indices, keyed by the hash of all their attribute values
+        class VertexTable
+        {
+        public:
+            explicit VertexTable(std::size_t vertexCount)
+            {
+                std::size_t capacity = 16;
+                while (capacity < vertexCount * 2)
                 {
-                    throw invalid_gltf_document("Quota exceeded : buffer.byteLength > MaxBufferByteLength");
+                    capacity *= 2;
                 }
 
-                if (!buffer.uri.empty())
+                m_slots.resize(capacity);
+                m_mask = capacity - 1;
+            }
+
+            // Returns the stored vertex for which equal(vertex) holds, or stores and returns `vertex`
+            template <typename TEqual>
+            uint32_t Insert(uint64_t hash, uint32_t vertex, TEqual && equal)
+            {
+                for (std::size_t slot = static_cast<std::size_t>(hash) & m_mask;; slot = (slot + 1) & m_mask)
                 {
-                    if (buffer.IsEmbeddedResource())
+                    Slot & entry = m_slots[slot];
+                    if (entry.vertex == Empty)
                     {
-                        detail::MaterializeData(buffer);
+                        entry = { hash, vertex };
+                        return vertex;
                     }
-                    else
-                    {
-                        std::ifstream fileData(detail::CreateBufferUriPath(dataContext.bufferRootPath, buffer.uri), std::ios::binary);
-                        if (!fileData.good())
-                        {
-                            throw invalid_gltf_document("Invalid buffer.uri value", buffer.uri);
-                        }
 
-                        buffer.data.resize(buffer.byteLength);
-                        fileData.read(reinterpret_cast<char *>(&buffer.data[0]), buffer.byteLength);
-                    }
-                }
-                else if (dataContext.binaryData != nullptr)
-                {
-                    std::vector<uint8_t> & binary = *dataContext.binaryData;
-                    if (binary.size() < buffer.byteLength)
+                    if (entry.hash == hash && equal(entry.vertex))
                     {
-                        throw invalid_gltf_document("Invalid GLB buffer data");
+                        return entry.vertex;
                     }
-
-                    buffer.data.resize(buffer.byteLength);
-                    std::memcpy(&buffer.data[0], &binary[0], buffer.byteLength);
                 }
             }
 
-            return document;
+        private:
+            static constexpr uint32_t Empty = std::numeric_limits<uint32_t>::max();
+
+            struct Slot
+            {
+                uint64_t hash{};
+                uint32_t vertex{ Empty };
+            };
+
+            std::vector<Slot> m_slots{};
+            std::size_t m_mask{};
+        };
+    } // namespace detail
+
+    // Merges the vertices of a primitive whose attribute and morph target values are bit-identical. Every accessor
+    // is compacted in place to the unique vertices, in order of first use, and its count reduced; bufferViews used by
+    // nothing else are shortened to match, leaving the remaining bytes for RemoveUnusedData or PackBuffers to drop.
+    // Existing indices are rewritten in place. An unindexed primitive gets a new index accessor (UnsignedShort, or
+    // UnsignedInt when needed), appended to the buffer holding its vertices. The accessors must not be used by any
+    // other primitive, nor share bufferViews with other accessors. Buffers shared with other documents are copied
+    // first. Invalid input throws before anything is modified.
+    inline void WeldVertices(Document & document, Primitive & primitive)
+    {
+        const std::vector<uint32_t> vertexAccessors = detail::GetExclusiveVertexAccessors(document, primitive);
+        Accessor const * indexAccessor = primitive.indices >= 0 ? &detail::GetIndexAccessor(document, primitive) : nullptr;
+
+        const uint32_t vertexCount = document.accessors[vertexAccessors.front()].count;
+        std::vector<uint32_t> indices{};
+        if (indexAccessor != nullptr)
+        {
+            indices = detail::ReadIndices(document, *indexAccessor);
+            if (std::any_of(indices.begin(), indices.end(), [vertexCount](uint32_t index) { return index >= vertexCount; }))
+            {
+                throw invalid_gltf_document("Invalid primitive.indices value : index exceeds the vertex count");
+            }
         }
 
-        inline void ValidateBuffers(Document const & document, bool useBinaryFormat)
+        struct Stream
         {
-            if (document.buffers.empty())
+            uint8_t * data;
+            std::size_t stride;
+            uint32_t elementSize;
+        };
+
+        std::vector<Stream> streams{};
+        int32_t vertexBuffer = -1;
+        for (uint32_t accessorIndex : vertexAccessors)
+        {
+            Accessor const & accessor = document.accessors[accessorIndex];
+            const detail::AccessorLayout layout = detail::GetAccessorLayout(document, accessor);
+            if (layout.data != nullptr)
             {
-                throw invalid_gltf_document("Invalid glTF document. A document must have at least 1 buffer.");
+                streams.push_back({ detail::GetWritableData(document, accessor).data(), layout.stride, layout.elementSize });
+                vertexBuffer = vertexBuffer < 0 ? document.bufferViews[static_cast<std::size_t>(accessor.bufferView)].buffer : vertexBuffer;
             }
+        }
 
-            bool foundBinaryBuffer = false;
-            for (std::size_t bufferIndex = 0; bufferIndex < document.buffers.size(); bufferIndex++)
+        auto equal = [&streams](std::size_t left, std::size_t right) {
+            for (Stream const & stream : streams)
             {
-                Buffer const & buffer = document.buffers[bufferIndex];
-                if (buffer.byteLength == 0)
+                if (std::memcmp(stream.data + left * stream.stride, stream.data + right * stream.stride, stream.elementSize) != 0)
                 {
-                    throw invalid_gltf_document("Invalid buffer.byteLength value : 0");
+                    return false;
                 }
+            }
 
-                if (buffer.byteLength != buffer.data.size())
-                {
-                    throw invalid_gltf_document("Invalid buffer.byteLength value : does not match buffer.data size");
-                }
+            return true;
+        };
 
-                if (buffer.uri.empty())
-                {
-                    foundBinaryBuffer = true;
-                    if (bufferIndex != 0)
-                    {
-                        throw invalid_gltf_document("Invalid glTF document. Only 1 buffer, the very first, is allowed to have an empty buffer.uri field.");
-                    }
-                }
+        // The table holds the new index of each unique vertex, whose data has already moved there: unique vertices
+        // only ever move towards the front, over ones which were already read
+        std::vector<uint32_t> newIndices(vertexCount);
+        detail::VertexTable table(vertexCount);
+        uint32_t uniqueCount = 0;
+        for (uint32_t vertex = 0; vertex < vertexCount; vertex++)
+        {
+            uint64_t hash = 0;
+            for (Stream const & stream : streams)
+            {
+                hash = detail::Hash64(stream.data + static_cast<std::size_t>(vertex) * stream.stride, stream.elementSize, hash);
             }
 
-            if (useBinaryFormat && !foundBinaryBuffer)
+            newIndices[vertex] = table.Insert(hash, uniqueCount, [&equal, vertex](uint32_t unique) { return equal(unique, vertex); });
+            if (newIndices[vertex] == uniqueCount)
             {
-                throw invalid_gltf_document("Invalid glTF document. No buffer found which can meet the criteria for saving to a .glb file.");
+                for (Stream const & stream : streams)
+                {
+                    std::memmove(stream.data + static_cast<std::size_t>(uniqueCount) * stream.stride, stream.data + static_cast<std::size_t>(vertex) * stream.stride, stream.elementSize);
+                }
+
+                uniqueCount++;
             }
         }
 
-        inline void Save(Document const & document, std::ostream & output, FX_GLTF_FILESYSTEM::path const & documentRootPath, bool useBinaryFormat)
+        for (uint32_t accessorIndex : vertexAccessors)
         {
-            // There is no way to check if an ostream has been opened in binary mode or not. Just checking
-            // if it's "good" is the best we can do from here...
-            detail::ThrowIfBad(output);
+            document.accessors[accessorIndex].count = uniqueCount;
+        }
 
-            nlohmann::json json = document;
+        detail::TrimBufferViews(document, vertexAccessors);
 
-            std::size_t externalBufferIndex = 0;
-            if (useBinaryFormat)
+        if (indexAccessor != nullptr)
+        {
+            for (uint32_t & index : indices)
             {
-                detail::GLBHeader header{ detail::GLBHeaderMagic, 2, 0, { 0, detail::GLBChunkJSON } };
-                detail::ChunkHeader binHeader{ 0, detail::GLBChunkBIN };
+                index = newIndices[index];
+            }
 
-                std::string jsonText = json.dump();
+            detail::WriteIndices(document, *indexAccessor, indices);
+        }
+        else
+        {
+            Accessor accessor{};
+            accessor.count = vertexCount;
+            accessor.type = Accessor::Type::Scalar;
+            accessor.componentType = uniqueCount <= std::numeric_limits<uint16_t>::max() ? Accessor::ComponentType::UnsignedShort : Accessor::ComponentType::UnsignedInt;
+
+            const uint32_t componentSize = GetComponentSize(accessor.componentType);
+            std::vector<uint8_t> bytes(static_cast<std::size_t>(vertexCount) * componentSize);
+            for (std::size_t i = 0; i < newIndices.size(); i++)
+            {
+                for (uint32_t byte = 0; byte < componentSize; byte++)
+                {
+                    bytes[i * componentSize + byte] = static_cast<uint8_t>(newIndices[i] >> (8 * byte));
+                }
+            }
 
-                Buffer const & binBuffer = document.buffers.front();
-                const uint32_t binPaddedLength = ((binBuffer.byteLength + 3) & (~3u));
-                const uint32_t binPadding = binPaddedLength - binBuffer.byteLength;
-                binHeader.chunkLength = binPaddedLength;
+            primitive.indices = detail::AppendAccessor(document, vertexBuffer, std::move(accessor), bytes, BufferView::TargetType::ElementArrayBuffer);
+        }
+    }
 
-                header.jsonHeader.chunkLength = ((jsonText.length() + 3) & (~3u));
-                const uint32_t headerPadding = static_cast<uint32_t>(header.jsonHeader.chunkLength - jsonText.length());
-                header.length = detail::HeaderSize + header.jsonHeader.chunkLength + detail::ChunkHeaderSize + binHeader.chunkLength;
+    namespace detail
+    {
+        // How the meshes use an accessor; anything used in more than one way is Other
+        enum class QuantizeRole : uint8_t
+        {
+            None,
+            Position,
+            PositionDelta,
+            Normal,
+            TexCoord,
+            Other
+        };
 
-                constexpr std::array<char, 3> spaces = { ' ', ' ', ' ' };
-                constexpr std::array<char, 3> nulls = { 0, 0, 0 };
+        inline void AddUnique(std::vector<std::string> & names, char const * name)
+        {
+            if (std::find(names.begin(), names.end(), name) == names.end())
+            {
+                names.emplace_back(name);
+            }
+        }
 
-                output.write(reinterpret_cast<char *>(&header), detail::HeaderSize);
-                output.write(jsonText.c_str(), jsonText.length());
-                output.write(&spaces[0], headerPadding);
-                output.write(reinterpret_cast<char *>(&binHeader), detail::ChunkHeaderSize);
-                output.write(reinterpret_cast<char const *>(&binBuffer.data[0]), binBuffer.byteLength);
-                output.write(&nulls[0], binPadding);
+        inline std::vector<float> ReadFloats(Document const & document, Accessor const & accessor)
+        {
+            std::vector<float> values(static_cast<std::size_t>(accessor.count) * GetComponentCount(accessor.type));
+            ConvertToFloat(document, accessor, { values.data(), values.size() });
+            return values;
+        }
 
-                externalBufferIndex = 1;
+        // Per component bounds, from accessor.min/max when present
+        inline void GetBounds(Accessor const & accessor, std::vector<float> const & values, uint32_t componentCount, float * low, float * high)
+        {
+            if (accessor.min.size() == componentCount && accessor.max.size() == componentCount)
+            {
+                std::copy(accessor.min.begin(), accessor.min.end(), low);
+                std::copy(accessor.max.begin(), accessor.max.end(), high);
+                return;
             }
-            else
+
+            std::fill(low, low + componentCount, values.empty() ? 0.0f : (std::numeric_limits<float>::max)());
+            std::fill(high, high + componentCount, values.empty() ? 0.0f : std::numeric_limits<float>::lowest());
+            for (std::size_t i = 0; i < values.size(); i++)
             {
-                output << json.dump(2);
+                low[i % componentCount] = (std::min)(low[i % componentCount], values[i]);
+                high[i % componentCount] = (std::max)(high[i % componentCount], values[i]);
             }
+        }
 
-            // The glTF 2.0 spec allows a document to have more than 1 buffer. However, only the first one will be included in the .glb
-            // All others must be considered as External/Embedded resources. Process them if necessary...
-            for (; externalBufferIndex < document.buffers.size(); externalBufferIndex++)
+        // Points the accessor at a new bufferView holding the quantized values as `componentType`, with elements padded
+        // to 4 bytes as vertex attributes require. min/max become the quantized bounds, or are dropped for normalized data.
+        inline void StoreQuantized(Document & document, Accessor & accessor, std::vector<int32_t> const & values, Accessor::ComponentType componentType, bool normalized)
+        {
+            const uint32_t componentCount = GetComponentCount(accessor.type);
+            const uint32_t componentSize = GetComponentSize(componentType);
+            const uint32_t elementSize = componentCount * componentSize;
+            const uint32_t stride = (elementSize + 3) / 4 * 4;
+
+            std::vector<uint8_t> bytes(static_cast<std::size_t>(accessor.count) * stride);
+            std::vector<float> low(componentCount, (std::numeric_limits<float>::max)());
+            std::vector<float> high(componentCount, std::numeric_limits<float>::lowest());
+            for (std::size_t i = 0; i < accessor.count; i++)
             {
-                Buffer const & buffer = document.buffers[externalBufferIndex];
-                if (!buffer.IsEmbeddedResource())
+                for (uint32_t component = 0; component < componentCount; component++)
                 {
-                    std::ofstream fileData(detail::CreateBufferUriPath(documentRootPath, buffer.uri), std::ios::binary);
-                    if (!fileData.good())
+                    const int32_t value = values[i * componentCount + component];
+                    for (uint32_t byte = 0; byte < componentSize; byte++)
                     {
-                        throw invalid_gltf_document("Invalid buffer.uri value", buffer.uri);
+                        bytes[i * stride + component * componentSize + byte] = static_cast<uint8_t>(static_cast<uint32_t>(value) >> (8 * byte));
                     }
 
-                    fileData.write(reinterpret_cast<char const *>(&buffer.data[0]), buffer.byteLength);
+                    low[component] = (std::min)(low[component], static_cast<float>(value));
+                    high[component] = (std::max)(high[component], static_cast<float>(value));
                 }
             }
+
+            const int32_t buffer = document.bufferViews[static_cast<std::size_t>(accessor.bufferView)].buffer;
+            accessor.bufferView = AppendBufferView(document, buffer, bytes, BufferView::TargetType::ArrayBuffer, stride != elementSize ? stride : 0);
+            accessor.byteOffset = 0;
+            accessor.componentType = componentType;
+            accessor.normalized = normalized;
+            accessor.min.clear();
+            accessor.max.clear();
+            if (!normalized && accessor.count > 0)
+            {
+                accessor.min = low;
+                accessor.max = high;
+            }
         }
     } // namespace detail
 
-    inline Document LoadFromText(std::istream & input, FX_GLTF_FILESYSTEM::path const & documentRootPath, ReadQuotas const & readQuotas = {})
+    // Converts float vertex attributes to the smaller types KHR_mesh_quantization allows, and adds the extension to
+    // extensionsUsed and extensionsRequired. Positions of a mesh (and its morph target positions) share one offset and
+    // uniform scale, taken from accessor.min/max or computed, and are stored as Short. Every node using the mesh gets
+    // a child node which holds the mesh, its weights (and their animations) and the transform undoing the
+    // quantization. Meshes that are skinned, unused by any node, or whose position accessors are used elsewhere keep
+    // float positions. The quantized data goes into new bufferViews; the float data stays behind until
+    // RemoveUnusedData runs. Accessors shared between attribute kinds, or sparse, are left alone.
+    inline void QuantizeMeshes(Document & document, QuantizeOptions const & quantizeOptions = {})
     {
-        try
-        {
-            detail::ThrowIfBad(input);
+        using detail::QuantizeRole;
 
-            nlohmann::json json;
-            input >> json;
+        std::vector<QuantizeRole> roles(document.accessors.size());
+        std::vector<int64_t> owners(document.accessors.size(), -1);
+        auto assign = [&roles, &owners](int64_t accessorIndex, QuantizeRole role, int64_t mesh) {
+            if (accessorIndex < 0 || static_cast<uint64_t>(accessorIndex) >= roles.size())
+            {
+                return;
+            }
 
-            return detail::Create(json, { documentRootPath, readQuotas });
-        }
-        catch (invalid_gltf_document &)
-        {
-            throw;
-        }
-        catch (std::system_error &)
+            QuantizeRole & current = roles[static_cast<std::size_t>(accessorIndex)];
+            current = current == QuantizeRole::None || current == role ? role : QuantizeRole::Other;
+            int64_t & owner = owners[static_cast<std::size_t>(accessorIndex)];
+            owner = owner == -1 || owner == mesh ? mesh : -2;
+        };
+
+        for (std::size_t meshIndex = 0; meshIndex < document.meshes.size(); meshIndex++)
         {
-            throw;
+            const int64_t mesh = static_cast<int64_t>(meshIndex);
+            for (Primitive const & primitive : document.meshes[meshIndex].primitives)
+            {
+                assign(primitive.indices, QuantizeRole::Other, mesh);
+                for (auto const & attribute : primitive.attributes)
+                {
+                    const QuantizeRole role = attribute.first == "POSITION" ? QuantizeRole::Position
+                                              : attribute.first == "NORMAL" ? QuantizeRole::Normal
+                                              : attribute.first.compare(0, 9, "TEXCOORD_") == 0 ? QuantizeRole::TexCoord
+                                                                                                : QuantizeRole::Other;
+                    assign(attribute.second, role, mesh);
+                }
+
+                for (Attributes const & target : primitive.targets)
+                {
+                    for (auto const & attribute : target)
+                    {
+                        assign(attribute.second, attribute.first == "POSITION" ? QuantizeRole::PositionDelta : QuantizeRole::Other, mesh);
+                    }
+                }
+            }
         }
-        catch (...)
+
+        for (Skin const & skin : document.skins)
         {
-            std::throw_with_nested(invalid_gltf_document("Invalid glTF document. See nested exception for details."));
+            assign(skin.inverseBindMatrices, QuantizeRole::Other, -2);
         }
-    }
 
-    inline Document LoadFromText(FX_GLTF_FILESYSTEM::path const & documentFilePath, ReadQuotas const & readQuotas = {})
-    {
-        std::ifstream input(documentFilePath);
-        if (!input.is_open())
+        for (Animation const & animation : document.animations)
         {
-            throw std::system_error(std::make_error_code(std::errc::no_such_file_or_directory));
+            for (Animation::Sampler const & sampler : animation.samplers)
+            {
+                assign(sampler.input, QuantizeRole::Other, -2);
+                assign(sampler.output, QuantizeRole::Other, -2);
+            }
         }
 
-        return LoadFromText(input, detail::GetDocumentRootPath(documentFilePath), readQuotas);
-    }
+        auto isFloat = [&document](uint32_t accessorIndex, Accessor::Type type) {
+            Accessor const & accessor = document.accessors[accessorIndex];
+            return accessor.componentType == Accessor::ComponentType::Float && accessor.type == type && accessor.sparse.empty() && accessor.bufferView >= 0;
+        };
 
-    inline Document LoadFromBinary(std::istream & input, FX_GLTF_FILESYSTEM::path const & documentRootPath, ReadQuotas const & readQuotas = {})
-    {
-        try
+        bool quantized = false;
+        std::vector<int32_t> meshNodes(document.nodes.size(), -1);
+        for (std::size_t meshIndex = 0; quantizeOptions.Positions && meshIndex < document.meshes.size(); meshIndex++)
         {
-            detail::GLBHeader header{};
-            detail::ThrowIfBad(input.read(reinterpret_cast<char *>(&header), detail::HeaderSize));
-            if (header.magic != detail::GLBHeaderMagic ||
-                header.jsonHeader.chunkType != detail::GLBChunkJSON ||
-                header.jsonHeader.chunkLength + detail::HeaderSize > header.length)
+            std::vector<uint32_t> positions{};
+            std::vector<uint32_t> deltas{};
+            for (Primitive const & primitive : document.meshes[meshIndex].primitives)
             {
-                throw invalid_gltf_document("Invalid GLB header");
+                auto position = primitive.attributes.find("POSITION");
+                if (position != primitive.attributes.end())
+                {
+                    positions.push_back(position->second);
+                }
+
+                for (Attributes const & target : primitive.targets)
+                {
+                    auto delta = target.find("POSITION");
+                    if (delta != target.end())
+                    {
+                        deltas.push_back(delta->second);
+                    }
+                }
             }
 
-            std::vector<uint8_t> json{};
-            json.resize(header.jsonHeader.chunkLength);
-            detail::ThrowIfBad(input.read(reinterpret_cast<char *>(&json[0]), header.jsonHeader.chunkLength));
+            bool eligible = !positions.empty();
+            for (std::vector<uint32_t> * accessors : { &positions, &deltas })
+            {
+                std::sort(accessors->begin(), accessors->end());
+                accessors->erase(std::unique(accessors->begin(), accessors->end()), accessors->end());
+                for (uint32_t accessorIndex : *accessors)
+                {
+                    eligible = eligible && accessorIndex < roles.size() && owners[accessorIndex] == static_cast<int64_t>(meshIndex) &&
+                               roles[accessorIndex] == (accessors == &positions ? QuantizeRole::Position : QuantizeRole::PositionDelta) &&
+                               isFloat(accessorIndex, Accessor::Type::Vec3);
+                }
+            }
 
-            std::size_t totalSize = detail::HeaderSize + header.jsonHeader.chunkLength;
-            if (totalSize > readQuotas.MaxFileSize)
+            std::vector<uint32_t> instances{};
+            for (std::size_t nodeIndex = 0; nodeIndex < meshNodes.size(); nodeIndex++)
             {
-                throw invalid_gltf_document("Quota exceeded : file size > MaxFileSize");
+                if (document.nodes[nodeIndex].mesh == static_cast<int32_t>(meshIndex))
+                {
+                    instances.push_back(static_cast<uint32_t>(nodeIndex));
+                    eligible = eligible && document.nodes[nodeIndex].skin < 0;
+                }
             }
 
-            detail::ChunkHeader binHeader{};
-            detail::ThrowIfBad(input.read(reinterpret_cast<char *>(&binHeader), detail::ChunkHeaderSize));
-            if (binHeader.chunkType != detail::GLBChunkBIN)
+            if (!eligible || instances.empty())
             {
-                throw invalid_gltf_document("Invalid GLB header");
+                continue;
             }
 
-            totalSize += detail::ChunkHeaderSize + binHeader.chunkLength;
-            if (totalSize > readQuotas.MaxFileSize)
+            std::array<float, 3> low = { (std::numeric_limits<float>::max)(), (std::numeric_limits<float>::max)(), (std::numeric_limits<float>::max)() };
+            std::array<float, 3> high = { std::numeric_limits<float>::lowest(), std::numeric_limits<float>::lowest(), std::numeric_limits<float>::lowest() };
+            float range = 0;
+            std::vector<std::vector<float>> values{};
+            for (uint32_t accessorIndex : positions)
             {
-                throw invalid_gltf_document("Quota exceeded : file size > MaxFileSize");
+                std::array<float, 3> accessorLow{};
+                std::array<float, 3> accessorHigh{};
+                values.push_back(detail::ReadFloats(document, document.accessors[accessorIndex]));
+                detail::GetBounds(document.accessors[accessorIndex], values.back(), 3, accessorLow.data(), accessorHigh.data());
+                for (std::size_t component = 0; component < 3; component++)
+                {
+                    low[component] = (std::min)(low[component], accessorLow[component]);
+                    high[component] = (std::max)(high[component], accessorHigh[component]);
+                }
             }
 
-            std::vector<uint8_t> binary{};
-            binary.resize(binHeader.chunkLength);
-            detail::ThrowIfBad(input.read(reinterpret_cast<char *>(&binary[0]), binHeader.chunkLength));
+            for (uint32_t accessorIndex : deltas)
+            {
+                std::array<float, 3> accessorLow{};
+                std::array<float, 3> accessorHigh{};
+                values.push_back(detail::ReadFloats(document, document.accessors[accessorIndex]));
+                detail::GetBounds(document.accessors[accessorIndex], values.back(), 3, accessorLow.data(), accessorHigh.data());
+                for (std::size_t component = 0; component < 3; component++)
+                {
+                    range = (std::max)({ range, std::fabs(accessorLow[component]), std::fabs(accessorHigh[component]) });
+                }
+            }
 
-            return detail::Create(
-                nlohmann::json::parse(json.begin(), json.end()),
-                { documentRootPath, readQuotas, &binary });
-        }
-        catch (invalid_gltf_document &)
-        {
-            throw;
-        }
-        catch (std::system_error &)
-        {
-            throw;
-        }
-        catch (...)
-        {
-            std::throw_with_nested(invalid_gltf_document("Invalid glTF document. See nested exception for details."));
-        }
-    }
+            std::array<float, 3> center{};
+            for (std::size_t component = 0; component < 3; component++)
+            {
+                center[component] = (low[component] + high[component]) * 0.5f;
+                range = (std::max)(range, (high[component] - low[component]) * 0.5f);
+            }
 
-    inline Document LoadFromBinary(FX_GLTF_FILESYSTEM::path const & documentFilePath, ReadQuotas const & readQuotas = {})
-    {
-        std::ifstream input(documentFilePath, std::ios::binary);
-        if (!input.is_open())
-        {
-            throw std::system_error(std::make_error_code(std::errc::no_such_file_or_directory));
-        }
+            if (!(range > 0) || !std::isfinite(range))
+            {
+                range = 1;
+            }
 
-        return LoadFromBinary(input, detail::GetDocumentRootPath(documentFilePath), readQuotas);
-    }
+            constexpr float ShortMax = 32767.0f;
+            const std::array<float, 3> noOffset{};
+            for (std::size_t i = 0; i < values.size(); i++)
+            {
+                const uint32_t accessorIndex = i < positions.size() ? positions[i] : deltas[i - positions.size()];
+                std::vector<int32_t> quantizedValues(values[i].size());
+                detail::QuantizeComponents(values[i].data(), values[i].size(), 3, i < positions.size() ? center.data() : noOffset.data(), ShortMax / range, -ShortMax, ShortMax,
+                    quantizedValues.data());
+                detail::StoreQuantized(document, document.accessors[accessorIndex], quantizedValues, Accessor::ComponentType::Short, false);
+            }
 
-    inline void Save(Document const & document, std::ostream & output, FX_GLTF_FILESYSTEM::path const & documentRootPath, bool useBinaryFormat)
-    {
-        try
-        {
-            detail::ValidateBuffers(document, useBinaryFormat);
+            const float scale = range / ShortMax;
+            for (uint32_t nodeIndex : instances)
+            {
+                Node child{};
+                child.mesh = static_cast<int32_t>(meshIndex);
+                child.translation = center;
+                child.scale = { scale, scale, scale };
+                child.weights = std::move(document.nodes[nodeIndex].weights);
+
+                meshNodes[nodeIndex] = static_cast<int32_t>(document.nodes.size());
+                document.nodes[nodeIndex].weights.clear();
+                document.nodes[nodeIndex].mesh = -1;
+                document.nodes[nodeIndex].children.push_back(static_cast<int32_t>(document.nodes.size()));
+                document.nodes.push_back(std::move(child));
+            }
 
-            detail::Save(document, output, documentRootPath, useBinaryFormat);
+            quantized = true;
         }
-        catch (invalid_gltf_document &)
+
+        // Morph weights moved to the new child nodes, and so do their animations
+        for (Animation & animation : document.animations)
         {
-            throw;
+            for (Animation::Channel & channel : animation.channels)
+            {
+                const int32_t node = channel.target.node;
+                if (node >= 0 && static_cast<std::size_t>(node) < meshNodes.size() && meshNodes[static_cast<std::size_t>(node)] >= 0 && channel.target.path == "weights")
+                {
+                    channel.target.node = meshNodes[static_cast<std::size_t>(node)];
+                }
+            }
         }
-        catch (std::system_error &)
+
+        for (uint32_t accessorIndex = 0; accessorIndex < roles.size(); accessorIndex++)
         {
-            throw;
+            if (quantizeOptions.Normals && roles[accessorIndex] == QuantizeRole::Normal && isFloat(accessorIndex, Accessor::Type::Vec3))
+            {
+                constexpr float ByteMax = 127.0f;
+                const std::array<float, 3> noOffset{};
+                const std::vector<float> values = detail::ReadFloats(document, document.accessors[accessorIndex]);
+                std::vector<int32_t> quantizedValues(values.size());
+                detail::QuantizeComponents(values.data(), values.size(), 3, noOffset.data(), ByteMax, -ByteMax, ByteMax, quantizedValues.data());
+                detail::StoreQuantized(document, document.accessors[accessorIndex], quantizedValues, Accessor::ComponentType::Byte, true);
+                quantized = true;
+            }
+            else if (quantizeOptions.TexCoords && roles[accessorIndex] == QuantizeRole::TexCoord && isFloat(accessorIndex, Accessor::Type::Vec2))
+            {
+                constexpr float UnsignedShortMax = 65535.0f;
+                const std::vector<float> values = detail::ReadFloats(document, document.accessors[accessorIndex]);
+                std::array<float, 2> low{};
+                std::array<float, 2> high{};
+                detail::GetBounds(document.accessors[accessorIndex], values, 2, low.data(), high.data());
+                if ((std::min)(low[0], low[1]) >= 0.0f && (std::max)(high[0], high[1]) <= 1.0f)
+                {
+                    const std::array<float, 2> noOffset{};
+                    std::vector<int32_t> quantizedValues(values.size());
+                    detail::QuantizeComponents(values.data(), values.size(), 2, noOffset.data(), UnsignedShortMax, 0.0f, UnsignedShortMax, quantizedValues.data());
+                    detail::StoreQuantized(document, document.accessors[accessorIndex], quantizedValues, Accessor::ComponentType::UnsignedShort, true);
+                    quantized = true;
+                }
+            }
         }
-        catch (...)
+
+        if (quantized)
         {
-            std::throw_with_nested(invalid_gltf_document("Invalid glTF document. See nested exception for details."));
+            detail::AddUnique(document.extensionsUsed, "KHR_mesh_quantization");
+            detail::AddUnique(document.extensionsRequired, "KHR_mesh_quantization");
         }
     }
-
-    inline void Save(Document const & document, FX_GLTF_FILESYSTEM::path const & documentFilePath, bool useBinaryFormat)
-    {
-        std::ofstream output(documentFilePath, useBinaryFormat ? std::ios::binary : std::ios::out);
-        Save(document, output, detail::GetDocumentRootPath(documentFilePath), useBinaryFormat);
-    }
 } // namespace gltf
 
 // A general-purpose utility to format an exception hierarchy into a string for output
@@ -2015,3 +9076,7 @@ inline void FormatException(std::string & output, std::exception const & ex, int
 #undef FX_GLTF_INLINE_CONSTEXPR
 #undef FX_GLTF_EXPERIMENTAL_FILESYSTEM
 #undef FX_GLTF_FILESYSTEM
+#undef FX_GLTF_SIMD_AVX2
+#undef FX_GLTF_SIMD_SSE2
+#undef FX_GLTF_SIMD_SSSE3
+#undef FX_GLTF_SIMD_NEON
@@ -0,0 +1,119 @@
+// ------------------------------------------------------------
+// Copyright(c) 2018-2022 Jesse Yurkovich
+// Licensed under the MIT License <http://opensource.org/licenses/MIT>.
+// See the LICENSE file in the repo root for full license information.
+// ------------------------------------------------------------
+
+#include <array>
+#include <catch2/catch.hpp>
+#include <cstdint>
+#include <fx/gltf.h>
+#include <vector>
+
+namespace
+{
+    constexpr std::size_t ElementCount = 1 << 20;
+
+    fx::gltf::Document CreateDocument()
+    {
+        fx::gltf::Document document{};
+        document.buffers.push_back({});
+        document.buffers[0].byteLength = ElementCount * 4 * sizeof(uint16_t);
+        document.buffers[0].data.resize(document.buffers[0].byteLength);
+        for (std::size_t i = 0; i < document.buffers[0].data.size(); i++)
+        {
+            document.buffers[0].data[i] = static_cast<uint8_t>(i * 37 + 11);
+        }
+
+        document.bufferViews.push_back({});
+        document.bufferViews[0].buffer = 0;
+        document.bufferViews[0].byteLength = document.buffers[0].byteLength;
+        return document;
+    }
+
+    fx::gltf::Accessor CreateAccessor(fx::gltf::Accessor::ComponentType componentType, fx::gltf::Accessor::Type type, bool normalized)
+    {
+        fx::gltf::Accessor accessor{};
+        accessor.bufferView = 0;
+        accessor.count = ElementCount;
+        accessor.componentType = componentType;
+        accessor.type = type;
+        accessor.normalized = normalized;
+        return accessor;
+    }
+
+    // The per-element path AccessorView takes for data it cannot hand to the bulk kernels
+    template <typename TElement>
+    std::size_t ReadPerElement(fx::gltf::AccessorView<TElement> const & view, std::vector<TElement> & output)
+    {
+        for (std::size_t i = 0; i < view.size(); i++)
+        {
+            output[i] = view[i];
+        }
+
+        return output.size();
+    }
+} // namespace
+
+TEST_CASE("accessor conversion", "[benchmark]")
+{
+    const fx::gltf::Document document = CreateDocument();
+
+    const fx::gltf::Accessor colors = CreateAccessor(fx::gltf::Accessor::ComponentType::UnsignedByte, fx::gltf::Accessor::Type::Vec4, true);
+    const fx::gltf::Accessor texCoords = CreateAccessor(fx::gltf::Accessor::ComponentType::UnsignedShort, fx::gltf::Accessor::Type::Vec2, true);
+    const fx::gltf::Accessor normals = CreateAccessor(fx::gltf::Accessor::ComponentType::Short, fx::gltf::Accessor::Type::Vec4, true);
+    const fx::gltf::Accessor indices = CreateAccessor(fx::gltf::Accessor::ComponentType::UnsignedShort, fx::gltf::Accessor::Type::Scalar, false);
+
+    std::vector<std::array<float, 4>> float4(ElementCount);
+    std::vector<std::array<float, 2>> float2(ElementCount);
+    std::vector<uint32_t> uint32(ElementCount);
+
+    const fx::gltf::AccessorView<std::array<float, 4>> colorView(document, colors);
+    const fx::gltf::AccessorView<std::array<float, 2>> texCoordView(document, texCoords);
+    const fx::gltf::AccessorView<std::array<float, 4>> normalView(document, normals);
+    const fx::gltf::AccessorView<uint32_t> indexView(document, indices);
+
+    BENCHMARK("u8x4 normalized - per element")
+    {
+        return ReadPerElement(colorView, float4);
+    };
+
+    BENCHMARK("u8x4 normalized - bulk")
+    {
+        fx::gltf::ConvertToFloat(document, colors, { float4.front().data(), float4.size() * 4 });
+        return float4.back()[0];
+    };
+
+    BENCHMARK("u16x2 normalized - per element")
+    {
+        return ReadPerElement(texCoordView, float2);
+    };
+
+    BENCHMARK("u16x2 normalized - bulk")
+    {
+        texCoordView.CopyTo({ float2.data(), float2.size() });
+        return float2.back()[0];
+    };
+
+    BENCHMARK("i16x4 normalized - per element")
+    {
+        return ReadPerElement(normalView, float4);
+    };
+
+    BENCHMARK("i16x4 normalized - bulk")
+    {
+        normalView.CopyTo({ float4.data(), float4.size() });
+        return float4.back()[0];
+    };
+
+    BENCHMARK("u16 indices to u32 - per element")
+    {
+        return ReadPerElement(indexView, uint32);
+    };
+
+    BENCHMARK("u16 indices to u32 - bulk")
+    {
+        fx::gltf::ConvertToUInt32(document, indices, { uint32.data(), uint32.size() });
+        return uint32.back();
+    };
+}
@@ -0,0 +1,158 @@
+// ------------------------------------------------------------
+// Copyright(c) 2018-2022 Jesse Yurkovich
+// Licensed under the MIT License <http://opensource.org/licenses/MIT>.
+// See the LICENSE file in the repo root for full license information.
+// ------------------------------------------------------------
+
+#include <algorithm>
+#include <catch2/catch.hpp>
+#include <cstdint>
+#include <fx/gltf.h>
+#include <random>
+#include <sstream>
+#include <string>
+#include <vector>
+
+namespace
+{
+    constexpr std::size_t DecodedSize = 16 * 1024 * 1024;
+
+    // The previous decoder: one checked lookup and one push_back per character
+    bool ReferenceDecode(std::string const & in, std::vector<uint8_t> & out)
+    {
+        out.clear();
+
+        const std::size_t length = in.length();
+        if (length % 4 != 0)
+        {
+            return false;
+        }
+
+        out.reserve((length / 4) * 3);
+
+        uint32_t value = 0;
+        int32_t bitCount = -8;
+        for (std::size_t i = 0; i < length; i++)
+        {
+            const uint8_t c = static_cast<uint8_t>(in[i]);
+            const char map = fx::base64::detail::DecodeMap.at(c);
+            if (map == -1)
+            {
+                return c == '=';
+            }
+
+            value = (value << 6u) + map;
+            bitCount += 6;
+            if (bitCount >= 0)
+            {
+                const uint32_t shiftOperand = bitCount;
+                out.push_back(static_cast<uint8_t>(value >> shiftOperand));
+                bitCount -= 8;
+            }
+        }
+
+        return true;
+    }
+
+    // The previous encoder: bit accumulation with one checked lookup and one push_back per character
+    std::string ReferenceEncode(std::vector<uint8_t> const & bytes)
+    {
+        std::string out{};
+        out.reserve(((bytes.size() * 4 / 3) + 3) & (~3u));
+
+        uint32_t value = 0;
+        int32_t bitCount = -6;
+        for (uint8_t byte : bytes)
+        {
+            value = (value << 8u) + byte;
+            bitCount += 8;
+            while (bitCount >= 0)
+            {
+                const uint32_t shiftOperand = bitCount;
+                out.push_back(fx::base64::detail::EncodeMap.at((value >> shiftOperand) & 0x3fu));
+                bitCount -= 6;
+            }
+        }
+
+        if (bitCount > -6)
+        {
+            const uint32_t shiftOperand = bitCount + 8;
+            out.push_back(fx::base64::detail::EncodeMap.at(((value << 8u) >> shiftOperand) & 0x3fu));
+        }
+
+        while (out.size() % 4 != 0)
+        {
+            out.push_back('=');
+        }
+
+        return out;
+    }
+} // namespace
+
+TEST_CASE("base64 decode throughput (16 MiB)", "[benchmark]")
+{
+    std::mt19937 gen(29);
+    std::uniform_int_distribution<> dist(0, 255);
+
+    std::vector<uint8_t> bytes(DecodedSize);
+    std::generate(bytes.begin(), bytes.end(), [&dist, &gen] { return static_cast<uint8_t>(dist(gen)); });
+    const std::string encoded = fx::base64::Encode(bytes);
+
+    std::vector<uint8_t> decoded{};
+    std::vector<uint8_t> preSized(fx::base64::GetDecodedLength(encoded));
+
+    BENCHMARK("reference")
+    {
+        return ReferenceDecode(encoded, decoded);
+    };
+
+    BENCHMARK("TryDecode - vector")
+    {
+        return fx::base64::TryDecode(encoded, decoded);
+    };
+
+    BENCHMARK("TryDecode - pre-sized")
+    {
+        return fx::base64::TryDecode(encoded, preSized.data(), preSized.size());
+    };
+
+    REQUIRE(fx::base64::TryDecode(encoded, preSized.data(), preSized.size()));
+    REQUIRE(preSized == bytes);
+}
+
+TEST_CASE("base64 encode throughput (16 MiB)", "[benchmark]")
+{
+    std::mt19937 gen(29);
+    std::uniform_int_distribution<> dist(0, 255);
+
+    std::vector<uint8_t> bytes(DecodedSize);
+    std::generate(bytes.begin(), bytes.end(), [&dist, &gen] { return static_cast<uint8_t>(dist(gen)); });
+
+    std::string preSized(fx::base64::GetEncodedLength(bytes.size()), '\0');
+    std::ostringstream stream{};
+
+    BENCHMARK("reference")
+    {
+        return ReferenceEncode(bytes);
+    };
+
+    BENCHMARK("Encode - string")
+    {
+        return fx::base64::Encode(bytes);
+    };
+
+    BENCHMARK("Encode - pre-sized")
+    {
+        fx::base64::Encode(bytes.data(), bytes.size(), &preSized[0]);
+        return preSized.back();
+    };
+
+    BENCHMARK("Encode - stream")
+    {
+        stream.str({});
+        fx::base64::Encode(bytes.data(), bytes.size(), stream);
+        return stream.tellp();
+    };
+
+    REQUIRE(preSized == ReferenceEncode(bytes));
+}
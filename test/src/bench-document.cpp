@@ -0,0 +1,114 @@
+// ------------------------------------------------------------
+// Copyright(c) 2018-2022 Jesse Yurkovich
+// Licensed under the MIT License <http://opensource.org/licenses/MIT>.
+// See the LICENSE file in the repo root for full license information.
+// ------------------------------------------------------------
+
+#include <catch2/catch.hpp>
+#include <cstdint>
+#include <fx/gltf.h>
+#include <nlohmann/json.hpp>
+#include <sstream>
+#include <string>
+
+namespace
+{
+    constexpr uint32_t NodeCount = 50000;
+
+    // A scene graph sized like a large export: one mesh, accessor and node per object
+    fx::gltf::Document CreateDocument()
+    {
+        fx::gltf::Document document{};
+        document.asset.generator = "fx-gltf benchmark";
+
+        // Only the json is of interest: keep the buffer tiny and embedded so nothing else is written
+        document.buffers.push_back({});
+        document.buffers[0].byteLength = 12;
+        document.buffers[0].data.resize(12);
+        document.buffers[0].SetEmbeddedResource();
+
+        document.bufferViews.push_back({});
+        document.bufferViews[0].buffer = 0;
+        document.bufferViews[0].byteLength = NodeCount * 12;
+
+        document.scenes.push_back({});
+        document.scene = 0;
+
+        for (uint32_t i = 0; i < NodeCount; i++)
+        {
+            fx::gltf::Accessor accessor{};
+            accessor.bufferView = 0;
+            accessor.byteOffset = i * 12;
+            accessor.count = 1;
+            accessor.componentType = fx::gltf::Accessor::ComponentType::Float;
+            accessor.type = fx::gltf::Accessor::Type::Vec3;
+            accessor.min = { -0.5f * static_cast<float>(i), -1.0f, -1.0f };
+            accessor.max = { 0.5f * static_cast<float>(i), 1.0f, 1.0f };
+            document.accessors.push_back(accessor);
+
+            fx::gltf::Primitive primitive{};
+            primitive.attributes["POSITION"] = i;
+            document.meshes.push_back({});
+            document.meshes.back().name = "mesh" + std::to_string(i);
+            document.meshes.back().primitives.push_back(primitive);
+
+            fx::gltf::Node node{};
+            node.mesh = static_cast<int32_t>(i);
+            node.name = "node" + std::to_string(i);
+            node.translation = { static_cast<float>(i) * 0.25f, 0.1f, -3.3f };
+            node.rotation = { 0.0f, 0.7071068f, 0.0f, 0.7071068f };
+            document.nodes.push_back(node);
+            document.scenes[0].nodes.push_back(i);
+        }
+
+        return document;
+    }
+} // namespace
+
+TEST_CASE("document save (50k nodes)", "[benchmark]")
+{
+    const fx::gltf::Document document = CreateDocument();
+
+    std::ostringstream stream{};
+
+    BENCHMARK("json tree - dump")
+    {
+        stream.str({});
+        nlohmann::json json = document;
+        stream << json.dump(2);
+        return stream.tellp();
+    };
+
+    BENCHMARK("Save - streamed")
+    {
+        stream.str({});
+        fx::gltf::Save(document, stream, "", false);
+        return stream.tellp();
+    };
+
+    REQUIRE(nlohmann::json::parse(stream.str()) == nlohmann::json(document));
+}
+
+TEST_CASE("document load (50k nodes)", "[benchmark]")
+{
+    std::ostringstream saved{};
+    fx::gltf::Save(CreateDocument(), saved, "", false);
+    const std::string text = saved.str();
+
+    BENCHMARK("json tree - from_json")
+    {
+        std::istringstream input(text);
+        nlohmann::json json;
+        input >> json;
+        return fx::gltf::detail::Create(json, {});
+    };
+
+    BENCHMARK("LoadFromText - sax")
+    {
+        std::istringstream input(text);
+        return fx::gltf::LoadFromText(input, "");
+    };
+
+    std::istringstream input(text);
+    REQUIRE(nlohmann::json(fx::gltf::LoadFromText(input, "")) == nlohmann::json::parse(text));
+}
@@ -0,0 +1,894 @@
+// ------------------------------------------------------------
+// Copyright(c) 2018-2022 Jesse Yurkovich
+// Licensed under the MIT License <http://opensource.org/licenses/MIT>.
+// See the LICENSE file in the repo root for full license information.
+// ------------------------------------------------------------
+
+#include <algorithm>
+#include <array>
+#include <catch2/catch.hpp>
+#include <cmath>
+#include <cstring>
+#include <limits>
+#include <memory>
+#include <deque>
+#include <fx/gltf.h>
+#include <nlohmann/json.hpp>
+#include <random>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "utility.h"
+
+namespace
+{
+    struct Vertex
+    {
+        std::array<float, 3> position;
+        std::array<uint8_t, 4> color;
+        std::array<uint16_t, 2> texCoord;
+    };
+
+    // Builds a document with a single interleaved vertex buffer and a tightly packed index buffer
+    fx::gltf::Document CreateInterleavedDocument(std::vector<Vertex> const & vertices, std::vector<uint16_t> const & indices)
+    {
+        fx::gltf::Document document{};
+
+        const std::size_t vertexBytes = vertices.size() * sizeof(Vertex);
+        const std::size_t indexBytes = indices.size() * sizeof(uint16_t);
+
+        fx::gltf::Buffer buffer{};
+        buffer.byteLength = static_cast<uint32_t>(vertexBytes + indexBytes);
+        buffer.data.resize(buffer.byteLength);
+        std::memcpy(buffer.data.data(), vertices.data(), vertexBytes);
+        std::memcpy(buffer.data.data() + vertexBytes, indices.data(), indexBytes);
+        document.buffers.push_back(buffer);
+
+        fx::gltf::BufferView vertexView{};
+        vertexView.buffer = 0;
+        vertexView.byteLength = static_cast<uint32_t>(vertexBytes);
+        vertexView.byteStride = sizeof(Vertex);
+        document.bufferViews.push_back(vertexView);
+
+        fx::gltf::BufferView indexView{};
+        indexView.buffer = 0;
+        indexView.byteOffset = static_cast<uint32_t>(vertexBytes);
+        indexView.byteLength = static_cast<uint32_t>(indexBytes);
+        document.bufferViews.push_back(indexView);
+
+        fx::gltf::Accessor position{};
+        position.bufferView = 0;
+        position.count = static_cast<uint32_t>(vertices.size());
+        position.componentType = fx::gltf::Accessor::ComponentType::Float;
+        position.type = fx::gltf::Accessor::Type::Vec3;
+        document.accessors.push_back(position);
+
+        fx::gltf::Accessor color{};
+        color.bufferView = 0;
+        color.byteOffset = offsetof(Vertex, color);
+        color.count = static_cast<uint32_t>(vertices.size());
+        color.componentType = fx::gltf::Accessor::ComponentType::UnsignedByte;
+        color.type = fx::gltf::Accessor::Type::Vec4;
+        color.normalized = true;
+        document.accessors.push_back(color);
+
+        fx::gltf::Accessor texCoord{};
+        texCoord.bufferView = 0;
+        texCoord.byteOffset = offsetof(Vertex, texCoord);
+        texCoord.count = static_cast<uint32_t>(vertices.size());
+        texCoord.componentType = fx::gltf::Accessor::ComponentType::UnsignedShort;
+        texCoord.type = fx::gltf::Accessor::Type::Vec2;
+        texCoord.normalized = true;
+        document.accessors.push_back(texCoord);
+
+        fx::gltf::Accessor index{};
+        index.bufferView = 1;
+        index.count = static_cast<uint32_t>(indices.size());
+        index.componentType = fx::gltf::Accessor::ComponentType::UnsignedShort;
+        index.type = fx::gltf::Accessor::Type::Scalar;
+        document.accessors.push_back(index);
+
+        return document;
+    }
+
+    std::vector<Vertex> CreateVertices(std::size_t count)
+    {
+        std::vector<Vertex> vertices(count);
+        for (std::size_t i = 0; i < count; i++)
+        {
+            const float f = static_cast<float>(i);
+            vertices[i].position = { f, f * 2, -f };
+            vertices[i].color = { static_cast<uint8_t>(i), 0, 128, 255 };
+            vertices[i].texCoord = { static_cast<uint16_t>(i * 100), 65535 };
+        }
+
+        return vertices;
+    }
+
+    // Vertices transformed per triangle with a FIFO post-transform cache
+    double GetCacheMissRatio(std::vector<uint32_t> const & indices, std::size_t cacheSize)
+    {
+        std::deque<uint32_t> cache{};
+        std::size_t misses = 0;
+        for (uint32_t index : indices)
+        {
+            if (std::find(cache.begin(), cache.end(), index) == cache.end())
+            {
+                misses++;
+                cache.push_back(index);
+                if (cache.size() > cacheSize)
+                {
+                    cache.pop_front();
+                }
+            }
+        }
+
+        return static_cast<double>(misses) / static_cast<double>(indices.size() / 3);
+    }
+
+    // A single bufferView over `byteLength` bytes of pseudo random data, covering every value of each component type
+    fx::gltf::Document CreatePackedDocument(std::size_t byteLength)
+    {
+        fx::gltf::Document document{};
+        document.buffers.push_back({});
+        document.buffers[0].byteLength = static_cast<uint32_t>(byteLength);
+        document.buffers[0].data.resize(byteLength);
+        for (std::size_t i = 0; i < byteLength; i++)
+        {
+            document.buffers[0].data[i] = static_cast<uint8_t>(i * 37 + 11);
+        }
+
+        document.bufferViews.push_back({});
+        document.bufferViews[0].buffer = 0;
+        document.bufferViews[0].byteLength = static_cast<uint32_t>(byteLength);
+        return document;
+    }
+} // namespace
+
+TEST_CASE("accessor")
+{
+    SECTION("element sizes")
+    {
+        fx::gltf::Accessor accessor{};
+        accessor.componentType = fx::gltf::Accessor::ComponentType::Float;
+        accessor.type = fx::gltf::Accessor::Type::Vec3;
+        REQUIRE(fx::gltf::GetElementSize(accessor) == 12);
+
+        accessor.type = fx::gltf::Accessor::Type::Mat4;
+        REQUIRE(fx::gltf::GetElementSize(accessor) == 64);
+
+        // Matrix columns are padded to 4-byte boundaries...
+        accessor.componentType = fx::gltf::Accessor::ComponentType::Byte;
+        accessor.type = fx::gltf::Accessor::Type::Mat2;
+        REQUIRE(fx::gltf::GetElementSize(accessor) == 8);
+
+        accessor.type = fx::gltf::Accessor::Type::Mat3;
+        REQUIRE(fx::gltf::GetElementSize(accessor) == 12);
+
+        accessor.componentType = fx::gltf::Accessor::ComponentType::Short;
+        REQUIRE(fx::gltf::GetElementSize(accessor) == 24);
+
+        accessor.type = fx::gltf::Accessor::Type::None;
+        REQUIRE(fx::gltf::GetElementSize(accessor) == 0);
+    }
+
+    SECTION("view - strided")
+    {
+        const std::vector<Vertex> vertices = CreateVertices(17);
+        fx::gltf::Document document = CreateInterleavedDocument(vertices, { 0, 1, 2 });
+
+        fx::gltf::AccessorView<std::array<float, 3>> positions(document, document.accessors[0]);
+        REQUIRE(positions.size() == vertices.size());
+        REQUIRE(positions.stride() == sizeof(Vertex));
+        REQUIRE_FALSE(positions.IsContiguous());
+
+        std::size_t i = 0;
+        for (std::array<float, 3> position : positions)
+        {
+            REQUIRE(position == vertices[i++].position);
+        }
+
+        REQUIRE(i == vertices.size());
+        REQUIRE((positions.begin() + 5)[2] == vertices[7].position);
+        REQUIRE(positions.end() - positions.begin() == static_cast<std::ptrdiff_t>(vertices.size()));
+
+        std::vector<std::array<float, 3>> copied(positions.size());
+        positions.CopyTo({ copied.data(), copied.size() });
+        REQUIRE(std::equal(copied.begin(), copied.end(), positions.begin()));
+    }
+
+    SECTION("view - contiguous")
+    {
+        const std::vector<uint16_t> indices = { 0, 1, 2, 2, 3, 0, 65535 };
+        fx::gltf::Document document = CreateInterleavedDocument(CreateVertices(4), indices);
+
+        fx::gltf::AccessorView<uint16_t> view(document, document.accessors[3]);
+        REQUIRE(view.IsContiguous());
+        REQUIRE(std::vector<uint16_t>(view.begin(), view.end()) == indices);
+
+        std::vector<uint16_t> copied(view.size());
+        view.CopyTo({ copied.data(), copied.size() });
+        REQUIRE(copied == indices);
+
+        // Arbitrary types of the correct size are read as-is...
+        struct Pair
+        {
+            uint16_t a;
+            uint16_t b;
+        };
+
+        fx::gltf::Accessor pairs = document.accessors[3];
+        pairs.type = fx::gltf::Accessor::Type::Vec2;
+        pairs.count = 3;
+        fx::gltf::AccessorView<Pair> pairView(document, pairs);
+        REQUIRE(pairView[1].a == 2);
+        REQUIRE(pairView[1].b == 2);
+    }
+
+    SECTION("view - conversions")
+    {
+        const std::vector<uint16_t> indices = { 0, 1, 2, 2, 3, 0, 65535 };
+        const std::vector<Vertex> vertices = CreateVertices(4);
+        fx::gltf::Document document = CreateInterleavedDocument(vertices, indices);
+
+        // Index widening...
+        fx::gltf::AccessorView<uint32_t> wideIndices(document, document.accessors[3]);
+        REQUIRE_FALSE(wideIndices.IsContiguous());
+        REQUIRE(std::vector<uint32_t>(wideIndices.begin(), wideIndices.end()) == std::vector<uint32_t>(indices.begin(), indices.end()));
+
+        // Normalized unsigned byte and short...
+        fx::gltf::AccessorView<std::array<float, 4>> colors(document, document.accessors[1]);
+        REQUIRE(colors[3] == std::array<float, 4>{ 3 / 255.0f, 0.0f, 128 / 255.0f, 1.0f });
+
+        fx::gltf::AccessorView<std::array<float, 2>> texCoords(document, document.accessors[2]);
+        REQUIRE(texCoords[2] == std::array<float, 2>{ 200 / 65535.0f, 1.0f });
+
+        // Normalized signed values clamp to -1...
+        fx::gltf::Accessor signedColor = document.accessors[1];
+        signedColor.componentType = fx::gltf::Accessor::ComponentType::Byte;
+        fx::gltf::AccessorView<std::array<float, 4>> signedColors(document, signedColor);
+        REQUIRE(signedColors[3] == std::array<float, 4>{ 3 / 127.0f, 0.0f, -1.0f, -1 / 127.0f });
+
+        // Incompatible conversions...
+        REQUIRE_THROWS_AS(fx::gltf::AccessorView<uint8_t>(document, document.accessors[3]), fx::gltf::invalid_gltf_document);
+        using UShort4 = std::array<uint16_t, 4>;
+        using UInt3 = std::array<uint32_t, 3>;
+        using Float2 = std::array<float, 2>;
+        REQUIRE_THROWS_AS(fx::gltf::AccessorView<UShort4>(document, document.accessors[1]), fx::gltf::invalid_gltf_document);
+        REQUIRE_THROWS_AS(fx::gltf::AccessorView<UInt3>(document, document.accessors[0]), fx::gltf::invalid_gltf_document);
+        REQUIRE_THROWS_AS(fx::gltf::AccessorView<Float2>(document, document.accessors[0]), fx::gltf::invalid_gltf_document);
+
+        // Widening keeps every value: unsigned data fits a larger signed type, signed data never fits an unsigned one
+        using Short4 = std::array<int16_t, 4>;
+        using SByte4 = std::array<int8_t, 4>;
+        using UInt4 = std::array<uint32_t, 4>;
+        fx::gltf::Accessor unsignedColor = document.accessors[1];
+        unsignedColor.normalized = false;
+        REQUIRE(fx::gltf::AccessorView<Short4>(document, unsignedColor)[3] == Short4{ 3, 0, 128, 255 });
+        REQUIRE_THROWS_AS(fx::gltf::AccessorView<SByte4>(document, unsignedColor), fx::gltf::invalid_gltf_document);
+        REQUIRE_THROWS_AS(fx::gltf::AccessorView<int16_t>(document, document.accessors[3]), fx::gltf::invalid_gltf_document);
+
+        fx::gltf::Accessor shortIndices = document.accessors[3];
+        shortIndices.componentType = fx::gltf::Accessor::ComponentType::Short;
+        REQUIRE(fx::gltf::AccessorView<int16_t>(document, shortIndices)[6] == -1);
+        REQUIRE_THROWS_AS(fx::gltf::AccessorView<uint16_t>(document, shortIndices), fx::gltf::invalid_gltf_document);
+        REQUIRE_THROWS_AS(fx::gltf::AccessorView<uint32_t>(document, shortIndices), fx::gltf::invalid_gltf_document);
+
+        signedColor.normalized = false;
+        REQUIRE_THROWS_AS(fx::gltf::AccessorView<UInt4>(document, signedColor), fx::gltf::invalid_gltf_document);
+    }
+
+    SECTION("view - padded matrices")
+    {
+        fx::gltf::Document document{};
+        document.buffers.push_back({});
+        document.buffers[0].byteLength = 16;
+        document.buffers[0].data = { 1, 2, 0xff, 0xff, 3, 4, 0xff, 0xff, 5, 6, 0xff, 0xff, 7, 8, 0xff, 0xff };
+        document.bufferViews.push_back({});
+        document.bufferViews[0].buffer = 0;
+        document.bufferViews[0].byteLength = 16;
+
+        fx::gltf::Accessor accessor{};
+        accessor.bufferView = 0;
+        accessor.count = 2;
+        accessor.componentType = fx::gltf::Accessor::ComponentType::UnsignedByte;
+        accessor.type = fx::gltf::Accessor::Type::Mat2;
+
+        fx::gltf::AccessorView<std::array<uint8_t, 4>> view(document, accessor);
+        REQUIRE(view[0] == std::array<uint8_t, 4>{ 1, 2, 3, 4 });
+        REQUIRE(view[1] == std::array<uint8_t, 4>{ 5, 6, 7, 8 });
+    }
+
+    SECTION("view - invalid ranges")
+    {
+        fx::gltf::Document document = CreateInterleavedDocument(CreateVertices(4), { 0, 1, 2 });
+
+        fx::gltf::Accessor accessor = document.accessors[0];
+        accessor.count = 5;
+        using Float3 = std::array<float, 3>;
+        REQUIRE_THROWS_AS(fx::gltf::AccessorView<Float3>(document, accessor), fx::gltf::invalid_gltf_document);
+
+        // Accessors without a bufferView read as zeros...
+        accessor.bufferView = -1;
+        fx::gltf::AccessorView<std::array<float, 3>> zeros(document, accessor);
+        REQUIRE(zeros.size() == 5);
+        REQUIRE(zeros[4] == std::array<float, 3>{ 0, 0, 0 });
+    }
+
+    SECTION("view - loaded document")
+    {
+#ifdef __cpp_lib_char8_t
+        FX_GLTF_FILESYSTEM::path originalFile{ "data/unιcode-ρath/Box.gltf" };
+#else
+        FX_GLTF_FILESYSTEM::path originalFile{ FX_GLTF_FILESYSTEM::u8path("data/unιcode-ρath/Box.gltf") };
+#endif
+
+        fx::gltf::Document document = fx::gltf::LoadFromTextMapped(originalFile);
+
+        fx::gltf::AccessorView<uint32_t> indices(document, document.accessors[0]);
+        REQUIRE(*std::max_element(indices.begin(), indices.end()) == 23);
+
+        fx::gltf::AccessorView<std::array<float, 3>> positions(document, document.accessors[2]);
+        for (std::array<float, 3> position : positions)
+        {
+            REQUIRE(std::abs(position[0]) == 0.5f);
+            REQUIRE(std::abs(position[1]) == 0.5f);
+            REQUIRE(std::abs(position[2]) == 0.5f);
+        }
+    }
+
+    SECTION("convert - packed kernels")
+    {
+        // Counts that are not a multiple of the vector width exercise the scalar tail as well...
+        fx::gltf::Document document = CreatePackedDocument(3 * 4 * 43);
+
+        fx::gltf::Accessor accessor{};
+        accessor.bufferView = 0;
+        accessor.type = fx::gltf::Accessor::Type::Vec3;
+
+        for (fx::gltf::Accessor::ComponentType componentType : { fx::gltf::Accessor::ComponentType::Byte,
+                 fx::gltf::Accessor::ComponentType::UnsignedByte,
+                 fx::gltf::Accessor::ComponentType::Short,
+                 fx::gltf::Accessor::ComponentType::UnsignedShort,
+                 fx::gltf::Accessor::ComponentType::UnsignedInt })
+        {
+            accessor.componentType = componentType;
+            accessor.count = 4 * 43 / fx::gltf::GetComponentSize(componentType);
+
+            for (bool normalized : { false, true })
+            {
+                accessor.normalized = normalized;
+
+                std::vector<float> converted(accessor.count * 3);
+                fx::gltf::ConvertToFloat(document, accessor, { converted.data(), converted.size() });
+
+                fx::gltf::AccessorView<std::array<float, 3>> view(document, accessor);
+                for (std::size_t i = 0; i < view.size(); i++)
+                {
+                    const std::array<float, 3> expected = view[i];
+                    REQUIRE(std::memcmp(&converted[i * 3], expected.data(), sizeof(expected)) == 0);
+                }
+
+                std::vector<std::array<float, 3>> copied(view.size());
+                view.CopyTo({ copied.data(), copied.size() });
+                REQUIRE(std::memcmp(copied.data(), converted.data(), converted.size() * sizeof(float)) == 0);
+            }
+
+            if (componentType != fx::gltf::Accessor::ComponentType::Byte && componentType != fx::gltf::Accessor::ComponentType::Short)
+            {
+                accessor.normalized = false;
+
+                std::vector<uint32_t> widened(accessor.count * 3);
+                fx::gltf::ConvertToUInt32(document, accessor, { widened.data(), widened.size() });
+
+                fx::gltf::AccessorView<std::array<uint32_t, 3>> view(document, accessor);
+                for (std::size_t i = 0; i < view.size(); i++)
+                {
+                    const std::array<uint32_t, 3> expected = view[i];
+                    REQUIRE(std::equal(expected.begin(), expected.end(), widened.begin() + static_cast<std::ptrdiff_t>(i * 3)));
+                }
+            }
+        }
+    }
+
+    SECTION("convert - strided and invalid")
+    {
+        const std::vector<Vertex> vertices = CreateVertices(19);
+        fx::gltf::Document document = CreateInterleavedDocument(vertices, { 0, 1, 2, 65535 });
+
+        std::vector<float> texCoords(vertices.size() * 2);
+        fx::gltf::ConvertToFloat(document, document.accessors[2], { texCoords.data(), texCoords.size() });
+        REQUIRE(texCoords[2 * 2] == 200 / 65535.0f);
+        REQUIRE(texCoords[2 * 2 + 1] == 1.0f);
+
+        std::vector<uint32_t> indices(4);
+        fx::gltf::ConvertToUInt32(document, document.accessors[3], { indices.data(), indices.size() });
+        REQUIRE(indices == std::vector<uint32_t>{ 0, 1, 2, 65535 });
+
+        REQUIRE_THROWS_AS(fx::gltf::ConvertToUInt32(document, document.accessors[0], { indices.data(), indices.size() }), fx::gltf::invalid_gltf_document);
+
+        // Signed data would wrap around rather than widen
+        fx::gltf::Accessor signedIndices = document.accessors[3];
+        signedIndices.componentType = fx::gltf::Accessor::ComponentType::Short;
+        REQUIRE_THROWS_AS(fx::gltf::ConvertToUInt32(document, signedIndices, { indices.data(), indices.size() }), fx::gltf::invalid_gltf_document);
+        signedIndices.componentType = fx::gltf::Accessor::ComponentType::Byte;
+        REQUIRE_THROWS_AS(fx::gltf::ConvertToUInt32(document, signedIndices, { indices.data(), indices.size() }), fx::gltf::invalid_gltf_document);
+        REQUIRE_THROWS_AS(fx::gltf::ConvertToFloat(document, document.accessors[2], { texCoords.data(), texCoords.size() - 1 }), std::out_of_range);
+
+        fx::gltf::Accessor empty = document.accessors[0];
+        empty.bufferView = -1;
+        std::vector<float> zeros(vertices.size() * 3, 1.0f);
+        fx::gltf::ConvertToFloat(document, empty, { zeros.data(), zeros.size() });
+        REQUIRE(std::all_of(zeros.begin(), zeros.end(), [](float value) { return value == 0.0f; }));
+    }
+
+    SECTION("optimize - vertex cache and fetch order")
+    {
+        // A 16x16 quad grid with its triangles shuffled
+        constexpr uint16_t Size = 17;
+        std::vector<std::array<uint16_t, 3>> triangles{};
+        for (uint16_t y = 0; y + 1 < Size; y++)
+        {
+            for (uint16_t x = 0; x + 1 < Size; x++)
+            {
+                const uint16_t corner = static_cast<uint16_t>(y * Size + x);
+                triangles.push_back({ corner, static_cast<uint16_t>(corner + Size), static_cast<uint16_t>(corner + 1) });
+                triangles.push_back({ static_cast<uint16_t>(corner + 1), static_cast<uint16_t>(corner + Size), static_cast<uint16_t>(corner + Size + 1) });
+            }
+        }
+
+        std::shuffle(triangles.begin(), triangles.end(), std::mt19937(42));
+        std::vector<uint16_t> shuffled{};
+        for (std::array<uint16_t, 3> const & triangle : triangles)
+        {
+            shuffled.insert(shuffled.end(), triangle.begin(), triangle.end());
+        }
+
+        const std::vector<Vertex> vertices = CreateVertices(Size * Size);
+        fx::gltf::Document document = CreateInterleavedDocument(vertices, shuffled);
+        document.meshes.resize(1);
+        document.meshes[0].primitives.resize(1);
+        fx::gltf::Primitive & primitive = document.meshes[0].primitives[0];
+        primitive.attributes = { { "POSITION", 0 }, { "COLOR_0", 1 }, { "TEXCOORD_0", 2 } };
+        primitive.indices = 3;
+
+        auto readIndices = [&document]() {
+            std::vector<uint32_t> indices(document.accessors[3].count);
+            fx::gltf::ConvertToUInt32(document, document.accessors[3], { indices.data(), indices.size() });
+            return indices;
+        };
+
+        const std::vector<uint32_t> original = readIndices();
+        fx::gltf::OptimizeVertexCache(document, primitive);
+        const std::vector<uint32_t> reordered = readIndices();
+        REQUIRE(GetCacheMissRatio(reordered, 16) < GetCacheMissRatio(original, 16) * 0.6);
+
+        // The same triangles, with the same winding
+        auto sortedTriangles = [](std::vector<uint32_t> const & indices) {
+            std::vector<std::array<uint32_t, 3>> result{};
+            for (std::size_t i = 0; i < indices.size(); i += 3)
+            {
+                result.push_back({ indices[i], indices[i + 1], indices[i + 2] });
+            }
+
+            std::sort(result.begin(), result.end());
+            return result;
+        };
+
+        REQUIRE(sortedTriangles(reordered) == sortedTriangles(original));
+
+        fx::gltf::OptimizeVertexFetch(document, primitive);
+        const std::vector<uint32_t> renumbered = readIndices();
+        uint32_t nextVertex = 0;
+        fx::gltf::AccessorView<std::array<float, 3>> positions(document, document.accessors[0]);
+        fx::gltf::AccessorView<std::array<uint16_t, 2>> texCoords(document, document.accessors[2]);
+        for (std::size_t i = 0; i < renumbered.size(); i++)
+        {
+            REQUIRE(renumbered[i] <= nextVertex);
+            nextVertex = std::max(nextVertex, renumbered[i] + 1);
+
+            // The vertex data moved along with the index
+            REQUIRE(positions[renumbered[i]] == vertices[reordered[i]].position);
+            REQUIRE(texCoords[renumbered[i]] == vertices[reordered[i]].texCoord);
+        }
+
+        // Storage shared with other documents (e.g. through a SharedBufferCache) is copied rather than written
+        fx::gltf::Document shared = CreateInterleavedDocument(vertices, shuffled);
+        const std::vector<uint8_t> sharedBytes = shared.buffers[0].data;
+        std::shared_ptr<uint8_t> storage(new uint8_t[sharedBytes.size()], std::default_delete<uint8_t[]>());
+        std::memcpy(storage.get(), sharedBytes.data(), sharedBytes.size());
+        shared.buffers[0].data.clear();
+        shared.buffers[0].externalData = storage;
+        shared.meshes = document.meshes;
+
+        fx::gltf::OptimizeVertexCache(shared, shared.meshes[0].primitives[0]);
+        fx::gltf::OptimizeVertexFetch(shared, shared.meshes[0].primitives[0]);
+        REQUIRE(std::memcmp(storage.get(), sharedBytes.data(), sharedBytes.size()) == 0);
+        REQUIRE(shared.buffers[0].externalData == nullptr);
+        REQUIRE(shared.buffers[0].data == document.buffers[0].data);
+
+        // Neither can bufferViews which also hold another accessor's data, as DeduplicateData may leave behind
+        shared.accessors.push_back(shared.accessors[0]);
+        REQUIRE_THROWS_AS(fx::gltf::OptimizeVertexFetch(shared, shared.meshes[0].primitives[0]), fx::gltf::invalid_gltf_document);
+        shared.accessors.back() = shared.accessors[3];
+        REQUIRE_THROWS_AS(fx::gltf::OptimizeVertexCache(shared, shared.meshes[0].primitives[0]), fx::gltf::invalid_gltf_document);
+
+        // Accessors used by another primitive cannot be renumbered
+        document.meshes[0].primitives.push_back(primitive);
+        document.meshes[0].primitives[1].indices = -1;
+        REQUIRE_THROWS_AS(fx::gltf::OptimizeVertexFetch(document, document.meshes[0].primitives[0]), fx::gltf::invalid_gltf_document);
+    }
+
+    SECTION("optimize - weld unindexed vertices")
+    {
+        // An unindexed 8x8 quad grid: every triangle carries its own copies of shared vertices
+        constexpr uint32_t Size = 9;
+        const std::vector<Vertex> grid = CreateVertices(Size * Size);
+        std::vector<Vertex> expanded{};
+        for (uint32_t y = 0; y + 1 < Size; y++)
+        {
+            for (uint32_t x = 0; x + 1 < Size; x++)
+            {
+                const uint32_t corner = y * Size + x;
+                for (uint32_t index : { corner, corner + Size, corner + 1, corner + 1, corner + Size, corner + Size + 1 })
+                {
+                    expanded.push_back(grid[index]);
+                }
+            }
+        }
+
+        fx::gltf::Document document = CreateInterleavedDocument(expanded, {});
+        document.meshes.resize(1);
+        document.meshes[0].primitives.resize(1);
+        fx::gltf::Primitive & primitive = document.meshes[0].primitives[0];
+        primitive.attributes = { { "POSITION", 0 }, { "COLOR_0", 1 }, { "TEXCOORD_0", 2 } };
+
+        fx::gltf::WeldVertices(document, primitive);
+        REQUIRE(primitive.indices == 4);
+        REQUIRE(document.accessors[0].count == Size * Size);
+        REQUIRE(document.accessors[2].count == Size * Size);
+        REQUIRE(document.bufferViews[0].byteLength == Size * Size * sizeof(Vertex));
+
+        fx::gltf::Accessor const & indexAccessor = document.accessors[4];
+        REQUIRE(indexAccessor.count == expanded.size());
+        REQUIRE(indexAccessor.componentType == fx::gltf::Accessor::ComponentType::UnsignedShort);
+        REQUIRE(document.bufferViews[indexAccessor.bufferView].target == fx::gltf::BufferView::TargetType::ElementArrayBuffer);
+
+        std::vector<uint32_t> indices(indexAccessor.count);
+        fx::gltf::ConvertToUInt32(document, indexAccessor, { indices.data(), indices.size() });
+        fx::gltf::AccessorView<std::array<float, 3>> positions(document, document.accessors[0]);
+        fx::gltf::AccessorView<std::array<uint8_t, 4>> colors(document, document.accessors[1]);
+        for (std::size_t i = 0; i < indices.size(); i++)
+        {
+            REQUIRE(positions[indices[i]] == expanded[i].position);
+            REQUIRE(colors[indices[i]] == expanded[i].color);
+        }
+
+        // Welding again changes nothing, also with a morph target whose accessor has no data
+        fx::gltf::WeldVertices(document, primitive);
+        REQUIRE(document.accessors[0].count == Size * Size);
+
+        primitive.targets.push_back({ { "POSITION", 3 } });
+        fx::gltf::Accessor & target = document.accessors[3];
+        target = document.accessors[0];
+        target.bufferView = -1;
+        fx::gltf::WeldVertices(document, primitive);
+        REQUIRE(document.accessors[0].count == Size * Size);
+        REQUIRE(target.count == Size * Size);
+
+        // Out of range indices are rejected before anything is modified...
+        fx::gltf::Document indexed = CreateInterleavedDocument(expanded, { 0, 1, 2, 2, 1, static_cast<uint16_t>(expanded.size()) });
+        indexed.meshes.resize(1);
+        indexed.meshes[0].primitives.resize(1);
+        indexed.meshes[0].primitives[0].attributes = primitive.attributes;
+        indexed.meshes[0].primitives[0].indices = 3;
+
+        const std::vector<uint8_t> indexedBytes = indexed.buffers[0].data;
+        REQUIRE_THROWS_AS(fx::gltf::WeldVertices(indexed, indexed.meshes[0].primitives[0]), fx::gltf::invalid_gltf_document);
+        REQUIRE(indexed.accessors[0].count == expanded.size());
+        REQUIRE(indexed.bufferViews[0].byteLength == expanded.size() * sizeof(Vertex));
+        REQUIRE(indexed.buffers[0].data == indexedBytes);
+
+        // ...and storage shared with other documents is copied rather than compacted in place
+        indexed.buffers[0].data[indexedBytes.size() - 2] = 4;
+        indexed.buffers[0].data[indexedBytes.size() - 1] = 0;
+        std::shared_ptr<uint8_t> storage(new uint8_t[indexedBytes.size()], std::default_delete<uint8_t[]>());
+        std::memcpy(storage.get(), indexed.buffers[0].data.data(), indexedBytes.size());
+        const std::vector<uint8_t> sharedBytes = indexed.buffers[0].data;
+        indexed.buffers[0].data.clear();
+        indexed.buffers[0].externalData = storage;
+
+        fx::gltf::WeldVertices(indexed, indexed.meshes[0].primitives[0]);
+        REQUIRE(indexed.accessors[0].count < expanded.size());
+        REQUIRE(indexed.buffers[0].externalData == nullptr);
+        REQUIRE(std::memcmp(storage.get(), sharedBytes.data(), sharedBytes.size()) == 0);
+    }
+
+    SECTION("optimize - quantize positions, normals and texcoords")
+    {
+        // 37 vertices: whole vector groups plus a scalar tail
+        constexpr std::size_t Count = 37;
+        std::vector<float> positions{};
+        std::vector<float> normals{};
+        std::vector<float> texCoords{};
+        std::vector<float> deltas{};
+        for (std::size_t i = 0; i < Count; i++)
+        {
+            const float f = static_cast<float>(i);
+            positions.insert(positions.end(), { f * 0.5f - 3.0f, std::sin(f), 10.0f + f * 0.01f });
+            normals.insert(normals.end(), { std::cos(f) * 0.6f, std::sin(f) * 0.6f, 0.8f });
+            texCoords.insert(texCoords.end(), { f / (Count - 1), 1.0f - f / (Count - 1) });
+            deltas.insert(deltas.end(), { 0.0f, f * 0.001f, -0.25f });
+        }
+
+        fx::gltf::Document document{};
+        document.buffers.resize(1);
+        for (std::vector<float> const * values : { &positions, &normals, &texCoords, &deltas })
+        {
+            fx::gltf::BufferView bufferView{};
+            bufferView.buffer = 0;
+            bufferView.byteOffset = document.buffers[0].data.size();
+            bufferView.byteLength = values->size() * sizeof(float);
+            document.bufferViews.push_back(bufferView);
+
+            fx::gltf::Accessor accessor{};
+            accessor.bufferView = static_cast<int32_t>(document.bufferViews.size() - 1);
+            accessor.count = Count;
+            accessor.componentType = fx::gltf::Accessor::ComponentType::Float;
+            accessor.type = values == &texCoords ? fx::gltf::Accessor::Type::Vec2 : fx::gltf::Accessor::Type::Vec3;
+            document.accessors.push_back(accessor);
+
+            uint8_t const * bytes = reinterpret_cast<uint8_t const *>(values->data());
+            document.buffers[0].data.insert(document.buffers[0].data.end(), bytes, bytes + bufferView.byteLength);
+        }
+
+        document.buffers[0].byteLength = document.buffers[0].data.size();
+        document.meshes.resize(1);
+        document.meshes[0].primitives.resize(1);
+        document.meshes[0].primitives[0].attributes = { { "POSITION", 0 }, { "NORMAL", 1 }, { "TEXCOORD_0", 2 } };
+        document.meshes[0].primitives[0].targets.push_back({ { "POSITION", 3 } });
+        document.nodes.resize(2);
+        document.nodes[0].mesh = 0;
+        document.nodes[0].weights = { 0.5f };
+        document.nodes[1].mesh = 0;
+        document.nodes[1].translation = { 1, 2, 3 };
+        document.animations.resize(1);
+        document.animations[0].channels.resize(1);
+        document.animations[0].channels[0].target.node = 0;
+        document.animations[0].channels[0].target.path = "weights";
+
+        fx::gltf::QuantizeMeshes(document);
+        REQUIRE(document.extensionsUsed == std::vector<std::string>{ "KHR_mesh_quantization" });
+        REQUIRE(document.extensionsRequired == std::vector<std::string>{ "KHR_mesh_quantization" });
+
+        // Each instance holds the mesh through a child undoing the quantization; weights and their animation follow
+        REQUIRE(document.nodes.size() == 4);
+        REQUIRE(document.nodes[0].mesh == -1);
+        REQUIRE(document.nodes[0].children == std::vector<int32_t>{ 2 });
+        REQUIRE(document.nodes[0].weights.empty());
+        REQUIRE(document.nodes[1].children == std::vector<int32_t>{ 3 });
+        REQUIRE(document.nodes[1].translation == std::array<float, 3>{ 1, 2, 3 });
+        REQUIRE(document.nodes[2].mesh == 0);
+        REQUIRE(document.nodes[2].weights == std::vector<float>{ 0.5f });
+        REQUIRE(document.animations[0].channels[0].target.node == 2);
+
+        fx::gltf::Node const & transform = document.nodes[2];
+        const float scale = transform.scale[0];
+        fx::gltf::Accessor const & position = document.accessors[0];
+        REQUIRE(position.componentType == fx::gltf::Accessor::ComponentType::Short);
+        REQUIRE_FALSE(position.normalized);
+        REQUIRE(document.bufferViews[position.bufferView].byteStride == 8);
+        REQUIRE(position.min.size() == 3);
+        REQUIRE(document.accessors[1].componentType == fx::gltf::Accessor::ComponentType::Byte);
+        REQUIRE(document.accessors[1].normalized);
+        REQUIRE(document.bufferViews[document.accessors[1].bufferView].byteStride == 4);
+        REQUIRE(document.accessors[2].componentType == fx::gltf::Accessor::ComponentType::UnsignedShort);
+        REQUIRE(document.accessors[3].componentType == fx::gltf::Accessor::ComponentType::Short);
+
+        std::vector<float> decoded(Count * 3);
+        fx::gltf::ConvertToFloat(document, position, { decoded.data(), decoded.size() });
+        for (std::size_t i = 0; i < decoded.size(); i++)
+        {
+            REQUIRE(std::fabs(decoded[i] * scale + transform.translation[i % 3] - positions[i]) <= scale * 0.51f);
+        }
+
+        fx::gltf::ConvertToFloat(document, document.accessors[3], { decoded.data(), decoded.size() });
+        for (std::size_t i = 0; i < decoded.size(); i++)
+        {
+            REQUIRE(std::fabs(decoded[i] * scale - deltas[i]) <= scale * 0.51f);
+        }
+
+        fx::gltf::ConvertToFloat(document, document.accessors[1], { decoded.data(), decoded.size() });
+        for (std::size_t i = 0; i < decoded.size(); i++)
+        {
+            REQUIRE(std::fabs(decoded[i] - normals[i]) <= 0.51f / 127);
+        }
+
+        fx::gltf::ConvertToFloat(document, document.accessors[2], { decoded.data(), Count * 2 });
+        for (std::size_t i = 0; i < Count * 2; i++)
+        {
+            REQUIRE(std::fabs(decoded[i] - texCoords[i]) <= 0.51f / 65535);
+        }
+
+        // The vector kernel rounds exactly like the scalar path
+        const std::array<float, 3> offsets = { 0.25f, -1.0f, 3.0f };
+        std::vector<int32_t> kernel(positions.size());
+        fx::gltf::detail::QuantizeComponents(positions.data(), positions.size(), 3, offsets.data(), 1000.0f, -32767.0f, 32767.0f, kernel.data());
+        for (std::size_t i = 0; i < positions.size(); i++)
+        {
+            REQUIRE(kernel[i] == fx::gltf::detail::QuantizeComponent(positions[i], offsets[i % 3], 1000.0f, -32767.0f, 32767.0f));
+        }
+    }
+
+    SECTION("bounds - kernels, chunks and save")
+    {
+        // Enough elements for several chunks plus a partial one, over every value of each component type...
+        fx::gltf::Document document = CreatePackedDocument(3 * 4 * 40001);
+
+        fx::gltf::Accessor accessor{};
+        accessor.bufferView = 0;
+        accessor.type = fx::gltf::Accessor::Type::Vec3;
+        accessor.normalized = true;
+
+        for (fx::gltf::Accessor::ComponentType componentType : { fx::gltf::Accessor::ComponentType::Byte,
+                 fx::gltf::Accessor::ComponentType::UnsignedByte,
+                 fx::gltf::Accessor::ComponentType::Short,
+                 fx::gltf::Accessor::ComponentType::UnsignedShort,
+                 fx::gltf::Accessor::ComponentType::UnsignedInt,
+                 fx::gltf::Accessor::ComponentType::Float })
+        {
+            accessor.componentType = componentType;
+            accessor.count = 4 * 40001 / fx::gltf::GetComponentSize(componentType);
+
+            // Bounds are over the stored values; normalized is ignored
+            fx::gltf::Accessor stored = accessor;
+            stored.normalized = false;
+
+            std::vector<float> expectedMin(3, (std::numeric_limits<float>::max)());
+            std::vector<float> expectedMax(3, std::numeric_limits<float>::lowest());
+            for (std::array<float, 3> const & element : fx::gltf::AccessorView<std::array<float, 3>>(document, stored))
+            {
+                for (std::size_t c = 0; c < 3; c++)
+                {
+                    expectedMin[c] = (std::min)(expectedMin[c], element[c]);
+                    expectedMax[c] = (std::max)(expectedMax[c], element[c]);
+                }
+            }
+
+            for (uint32_t threadCount : { 1u, 3u, 0u })
+            {
+                const fx::gltf::AccessorBounds bounds = fx::gltf::ComputeBounds(document, accessor, threadCount);
+                REQUIRE(bounds.min == expectedMin);
+                REQUIRE(bounds.max == expectedMax);
+            }
+        }
+
+        // Strided elements with a sparse override of the element holding the smallest x...
+        const std::vector<Vertex> vertices = CreateVertices(8);
+        document = CreateInterleavedDocument(vertices, { 0, 1, 2 });
+
+        const std::vector<float> sparseValue = { 3, 100, -3 };
+        fx::gltf::Buffer & buffer = document.buffers[0];
+        const uint32_t valuesOffset = buffer.byteLength;
+        buffer.data.resize(buffer.data.size() + 16);
+        std::memcpy(&buffer.data[valuesOffset], sparseValue.data(), sparseValue.size() * sizeof(float));
+        buffer.byteLength = static_cast<uint32_t>(buffer.data.size());
+
+        document.bufferViews.push_back({});
+        document.bufferViews[2].buffer = 0;
+        document.bufferViews[2].byteOffset = valuesOffset;
+        document.bufferViews[2].byteLength = 16;
+
+        // ...whose single UnsignedByte index 0 is the last byte of that view
+        document.accessors[0].sparse.count = 1;
+        document.accessors[0].sparse.indices.bufferView = 2;
+        document.accessors[0].sparse.indices.byteOffset = 15;
+        document.accessors[0].sparse.indices.componentType = fx::gltf::Accessor::ComponentType::UnsignedByte;
+        document.accessors[0].sparse.values.bufferView = 2;
+
+        fx::gltf::AccessorBounds bounds = fx::gltf::ComputeBounds(document, document.accessors[0]);
+        REQUIRE(bounds.min == std::vector<float>{ 1, 2, -7 });
+        REQUIRE(bounds.max == std::vector<float>{ 7, 100, -1 });
+
+        bounds = fx::gltf::ComputeBounds(document, document.accessors[1]);
+        REQUIRE(bounds.min == std::vector<float>{ 0, 0, 128, 255 });
+        REQUIRE(bounds.max == std::vector<float>{ 7, 0, 128, 255 });
+
+        // Saving with RefreshBounds writes computed bounds but leaves the document as it was
+        document.accessors[2].min = { 5, 5 };
+        document.accessors[2].max = { 5, 5 };
+        document.buffers[0].SetEmbeddedResource();
+
+        fx::gltf::SaveOptions saveOptions{};
+        saveOptions.RefreshBounds = true;
+        saveOptions.MaxThreadCount = 0;
+        std::stringstream output{};
+        fx::gltf::Save(document, output, {}, false, saveOptions);
+
+        const nlohmann::json json = nlohmann::json::parse(output.str());
+        REQUIRE(json["accessors"][0]["max"] == nlohmann::json{ 7, 100, -1 });
+        REQUIRE(json["accessors"][2]["min"] == nlohmann::json{ 0, 65535 });
+        REQUIRE(json["accessors"][2]["max"] == nlohmann::json{ 700, 65535 });
+        REQUIRE(json["accessors"][3]["min"] == nlohmann::json{ 0 });
+        REQUIRE(json["accessors"][3]["max"] == nlohmann::json{ 2 });
+        REQUIRE(document.accessors[0].min.empty());
+        REQUIRE(document.accessors[2].min == std::vector<float>{ 5, 5 });
+
+        fx::gltf::RefreshBounds(document);
+        REQUIRE(document.accessors[2].max == std::vector<float>{ 700, 65535 });
+        REQUIRE(document.accessors[3].max == std::vector<float>{ 2 });
+    }
+
+    SECTION("sparse - materialize")
+    {
+        const std::vector<Vertex> vertices = CreateVertices(8);
+        fx::gltf::Document document = CreateInterleavedDocument(vertices, { 0, 1, 2 });
+
+        // Append the sparse indices and values: elements 1, 4 and 7 are overridden...
+        const std::vector<uint8_t> sparseIndices = { 1, 4, 7, 0 };
+        const std::vector<float> sparseValues = { 10, 11, 12, 40, 41, 42, 70, 71, 72 };
+
+        fx::gltf::Buffer & buffer = document.buffers[0];
+        const uint32_t indicesOffset = buffer.byteLength;
+        buffer.data.insert(buffer.data.end(), sparseIndices.begin(), sparseIndices.end());
+        const uint32_t valuesOffset = static_cast<uint32_t>(buffer.data.size());
+        buffer.data.resize(buffer.data.size() + sparseValues.size() * sizeof(float));
+        std::memcpy(&buffer.data[valuesOffset], sparseValues.data(), sparseValues.size() * sizeof(float));
+        buffer.byteLength = static_cast<uint32_t>(buffer.data.size());
+
+        document.bufferViews.push_back({});
+        document.bufferViews[2].buffer = 0;
+        document.bufferViews[2].byteOffset = indicesOffset;
+        document.bufferViews[2].byteLength = static_cast<uint32_t>(sparseIndices.size());
+        document.bufferViews.push_back({});
+        document.bufferViews[3].buffer = 0;
+        document.bufferViews[3].byteOffset = valuesOffset;
+        document.bufferViews[3].byteLength = static_cast<uint32_t>(sparseValues.size() * sizeof(float));
+
+        fx::gltf::Accessor accessor = document.accessors[0];
+        accessor.sparse.count = 3;
+        accessor.sparse.indices.bufferView = 2;
+        accessor.sparse.indices.componentType = fx::gltf::Accessor::ComponentType::UnsignedByte;
+        accessor.sparse.values.bufferView = 3;
+
+        using Float3 = std::array<float, 3>;
+        fx::gltf::SparseAccessorView<Float3> view(document, accessor);
+        REQUIRE(view.size() == vertices.size());
+        REQUIRE(view.indices().size() == 3);
+        REQUIRE(view[0] == vertices[0].position);
+        REQUIRE(view[1] == Float3{ 10, 11, 12 });
+        REQUIRE(view[6] == vertices[6].position);
+        REQUIRE(view[7] == Float3{ 70, 71, 72 });
+
+        std::vector<Float3> materialized(vertices.size());
+        fx::gltf::MaterializeAccessor<Float3>(document, accessor, { materialized.data(), materialized.size() });
+        for (std::size_t i = 0; i < materialized.size(); i++)
+        {
+            REQUIRE(materialized[i] == view[i]);
+        }
+
+        // Morph target style: no base data, only deltas...
+        accessor.bufferView = -1;
+        fx::gltf::MaterializeAccessor<Float3>(document, accessor, { materialized.data(), materialized.size() });
+        REQUIRE(materialized[0] == Float3{ 0, 0, 0 });
+        REQUIRE(materialized[4] == Float3{ 40, 41, 42 });
+
+        // Unordered indices are sorted...
+        buffer.data[indicesOffset] = 7;
+        buffer.data[indicesOffset + 2] = 1;
+        fx::gltf::SparseAccessorView<Float3> unordered(document, accessor);
+        REQUIRE(unordered.indices()[0] == 1);
+        REQUIRE(unordered[1] == Float3{ 70, 71, 72 });
+        REQUIRE(unordered[7] == Float3{ 10, 11, 12 });
+
+        // ...but duplicates and out of range indices are rejected
+        buffer.data[indicesOffset + 2] = 4;
+        REQUIRE_THROWS_AS(fx::gltf::SparseAccessorView<Float3>(document, accessor), fx::gltf::invalid_gltf_document);
+        buffer.data[indicesOffset + 2] = 8;
+        REQUIRE_THROWS_AS(fx::gltf::SparseAccessorView<Float3>(document, accessor), fx::gltf::invalid_gltf_document);
+
+        accessor.sparse.count = 9;
+        REQUIRE_THROWS_AS(fx::gltf::SparseAccessorView<Float3>(document, accessor), fx::gltf::invalid_gltf_document);
+    }
+}
@@ -8,6 +8,7 @@
 #include <fx/gltf.h>
 #include <nlohmann/json.hpp>
 #include <random>
+#include <sstream>
 #include <string>
 #include <vector>
 
@@ -154,4 +155,83 @@ TEST_CASE("base64")
         REQUIRE_FALSE(fx::base64::TryDecode(base64Text, bytes));
         REQUIRE(bytes.empty());
     }
-}
\ No newline at end of file
+
+    SECTION("pre-sized output")
+    {
+        const std::string base64Text = "YW55IGNhcm5hbCBwbGVhcw==";
+        REQUIRE(fx::base64::GetDecodedLength(base64Text) == 16);
+        REQUIRE(fx::base64::GetDecodedLength("YW55IGNhcm5hbCBwbGVhcw") == 0);
+        REQUIRE(fx::base64::GetDecodedLength("TEST") == 3);
+
+        std::vector<uint8_t> bytes(16);
+        REQUIRE(fx::base64::TryDecode(base64Text, bytes.data(), bytes.size()));
+        REQUIRE(bytes == std::vector<uint8_t>{ 97, 110, 121, 32, 99, 97, 114, 110, 97, 108, 32, 112, 108, 101, 97, 115 });
+
+        // Output too small...
+        REQUIRE_FALSE(fx::base64::TryDecode(base64Text, bytes.data(), bytes.size() - 1));
+    }
+
+    SECTION("streamed encode")
+    {
+        std::mt19937 gen(37);
+        std::uniform_int_distribution<> dist(0, 255);
+
+        // Spans several of the internal chunks...
+        std::vector<uint8_t> bytes(100000);
+        std::generate(bytes.begin(), bytes.end(), [&dist, &gen] { return static_cast<uint8_t>(dist(gen)); });
+
+        std::ostringstream stream{};
+        fx::base64::Encode(bytes.data(), bytes.size(), stream);
+        REQUIRE(stream.str() == fx::base64::Encode(bytes));
+        REQUIRE(stream.str().length() == fx::base64::GetEncodedLength(bytes.size()));
+
+        // The vector paths must agree with encoding one group at a time...
+        const std::string text = stream.str();
+        for (std::size_t group = 0; group < 256; group++)
+        {
+            REQUIRE(fx::base64::Encode(&bytes[group * 3], 3) == text.substr(group * 4, 4));
+        }
+    }
+
+    SECTION("large buffers")
+    {
+        std::mt19937 gen(31);
+        std::uniform_int_distribution<> dist(0, 255);
+
+        // Long enough for the vector paths, with every tail length...
+        for (std::size_t length = 4096; length < 4096 + 96; length++)
+        {
+            std::vector<uint8_t> bytes(length);
+            std::generate(bytes.begin(), bytes.end(), [&dist, &gen] { return static_cast<uint8_t>(dist(gen)); });
+
+            const std::string encoded = fx::base64::Encode(bytes);
+            std::vector<uint8_t> decoded(fx::base64::GetDecodedLength(encoded));
+            REQUIRE(fx::base64::TryDecode(encoded, decoded.data(), decoded.size()));
+            REQUIRE(decoded == bytes);
+        }
+
+        // Every byte value at every position of the first few blocks must be classified correctly...
+        std::vector<uint8_t> bytes(96);
+        std::generate(bytes.begin(), bytes.end(), [&dist, &gen] { return static_cast<uint8_t>(dist(gen)); });
+        const std::string encoded = fx::base64::Encode(bytes);
+
+        std::vector<uint8_t> decoded(bytes.size());
+        for (std::size_t position = 0; position < 80; position++)
+        {
+            for (int c = 0; c < 256; c++)
+            {
+                std::string mutated = encoded;
+                mutated[position] = static_cast<char>(c);
+
+                const bool valid = fx::base64::detail::DecodeMap[c] != -1;
+                REQUIRE(fx::base64::TryDecode(mutated, decoded.data(), decoded.size()) == valid);
+                if (valid)
+                {
+                    std::vector<uint8_t> expected{};
+                    REQUIRE(fx::base64::TryDecode(mutated.substr(position / 4 * 4, 4), expected));
+                    REQUIRE(std::equal(expected.begin(), expected.end(), decoded.begin() + static_cast<std::ptrdiff_t>(position / 4 * 3)));
+                }
+            }
+        }
+    }
+}
@@ -6,6 +6,7 @@
 
 #include <catch2/catch.hpp>
 #include <fx/gltf.h>
+#include <memory>
 #include <nlohmann/json.hpp>
 #include <sstream>
 #include <string>
@@ -53,6 +54,10 @@ void Mutate(nlohmann::json const & incoming, TMutator && mutator, std::string co
     INFO("Mutated json : " << mutated.dump(2));
 
     REQUIRE_THROWS_MATCHES(fx::gltf::detail::Create(mutated, {}), fx::gltf::invalid_gltf_document, ExceptionContainsMatcher(text, shouldBeNested));
+
+    // The same errors must come out of the sax parser used by the loaders
+    std::istringstream input(mutated.dump());
+    REQUIRE_THROWS_MATCHES(fx::gltf::LoadFromText(input, {}), fx::gltf::invalid_gltf_document, ExceptionContainsMatcher(text, shouldBeNested));
 }
 
 TEST_CASE("exceptions")
@@ -173,6 +178,26 @@ TEST_CASE("exceptions")
 
         std::vector<uint8_t> data{};
         REQUIRE_THROWS_MATCHES(mainDocument.images[0].MaterializeData(data), fx::gltf::invalid_gltf_document, ExceptionContainsMatcher("malformed base64"));
+
+        // Allocated storage spans byteLength, so a payload shorter than byteLength cannot fill it
+        fx::gltf::ReadOptions readOptions{};
+        readOptions.BufferAllocator = [](std::size_t byteLength) { return std::shared_ptr<uint8_t>(new uint8_t[byteLength], std::default_delete<uint8_t[]>()); };
+        std::istringstream input(json.dump());
+        REQUIRE_THROWS_MATCHES(fx::gltf::LoadFromText(input, {}, {}, readOptions), fx::gltf::invalid_gltf_document, ExceptionContainsMatcher("malformed base64"));
+    }
+
+    SECTION("data : invalid ranges")
+    {
+        fx::gltf::Document doc = json;
+        doc.buffers[0].data.resize(doc.buffers[0].byteLength);
+
+        doc.bufferViews[0].byteOffset = 4;
+        REQUIRE_THROWS_MATCHES(fx::gltf::GetData(doc, doc.bufferViews[0]), fx::gltf::invalid_gltf_document, ExceptionContainsMatcher("bufferView.byteLength"));
+
+        doc.bufferViews[0].buffer = 1;
+        REQUIRE_THROWS_MATCHES(fx::gltf::GetData(doc, doc.bufferViews[0]), fx::gltf::invalid_gltf_document, ExceptionContainsMatcher("bufferView.buffer"));
+
+        REQUIRE_THROWS_MATCHES(fx::gltf::GetData(doc, doc.accessors[0]), fx::gltf::invalid_gltf_document, ExceptionContainsMatcher("accessor.bufferView"));
     }
 
     SECTION("load : quotas")
@@ -196,6 +221,9 @@ TEST_CASE("exceptions")
 
     SECTION("load : mismatched")
     {
+        std::istringstream truncated(R"({ "asset": { "version": "2.0" }, "nodes": [ )");
+        REQUIRE_THROWS_MATCHES(fx::gltf::LoadFromText(truncated, ""), fx::gltf::invalid_gltf_document, ExceptionContainsMatcher("json.exception.parse_error", true));
+
         REQUIRE_THROWS_MATCHES(fx::gltf::LoadFromText("data/glTF-Sample-Models/2.0/Box/glTF-Binary/Box.glb"), fx::gltf::invalid_gltf_document, ExceptionContainsMatcher("json.exception", true));
         REQUIRE_THROWS_MATCHES(fx::gltf::LoadFromBinary("data/glTF-Sample-Models/2.0/Box/glTF/Box.gltf"), fx::gltf::invalid_gltf_document, ExceptionContainsMatcher("GLB header"));
     }
@@ -4,14 +4,58 @@
 // See the LICENSE file in the repo root for full license information.
 // ------------------------------------------------------------
 
+#include <algorithm>
+#include <array>
 #include <catch2/catch.hpp>
+#include <chrono>
+#include <cstring>
+#include <fstream>
+#include <future>
 #include <fx/gltf.h>
+#include <iterator>
+#include <map>
 #include <nlohmann/json.hpp>
+#include <numeric>
 #include <sstream>
 #include <string>
 
 #include "utility.h"
 
+namespace
+{
+    // Keeps "files" in memory. Reads are deferred until waited on so the tests can observe how they are issued.
+    class MemoryResolver : public fx::gltf::ResourceResolver
+    {
+    public:
+        std::map<std::string, std::vector<uint8_t>> files{};
+        std::vector<std::string> events{};
+        std::vector<std::array<uint64_t, 2>> ranges{};
+
+        std::future<void> Read(std::string const & uri, std::vector<fx::gltf::ResourceRange> const & requested) override
+        {
+            events.push_back("read " + uri);
+            for (fx::gltf::ResourceRange const & range : requested)
+            {
+                ranges.push_back({ range.offset, range.target.size() });
+            }
+
+            return std::async(std::launch::deferred, [this, uri, requested]() {
+                events.push_back("done " + uri);
+                std::vector<uint8_t> const & file = files.at(uri);
+                for (fx::gltf::ResourceRange const & range : requested)
+                {
+                    std::memcpy(range.target.data(), &file[static_cast<std::size_t>(range.offset)], range.target.size());
+                }
+            });
+        }
+
+        void Write(std::string const & uri, fx::gltf::Span<uint8_t const> data) override
+        {
+            files[uri].assign(data.begin(), data.end());
+        }
+    };
+} // namespace
+
 TEST_CASE("saveload")
 {
     utility::CleanupTestOutputDir();
@@ -161,6 +205,881 @@ TEST_CASE("saveload")
         REQUIRE(newDocument.buffers.back().IsEmbeddedResource());
     }
 
+    SECTION("load binary - buffer data trimmed to byteLength")
+    {
+        FX_GLTF_FILESYSTEM::path newFile{ utility::GetTestOutputDir() / "test9.glb" };
+
+        // A byteLength which is not a multiple of 4 forces padding inside the BIN chunk...
+        std::vector<uint8_t> newBytes = { 0, 1, 2, 3, 4, 5, 6, 7, 8, 9 };
+        fx::gltf::Document originalDocument{};
+        originalDocument.buffers.push_back(fx::gltf::Buffer{});
+        originalDocument.buffers.back().byteLength = static_cast<uint32_t>(newBytes.size());
+        originalDocument.buffers.back().data = newBytes;
+
+        fx::gltf::Save(originalDocument, newFile, true);
+
+        fx::gltf::Document newDocument = fx::gltf::LoadFromBinary(newFile);
+
+        REQUIRE(newDocument.buffers.front().data.size() == newBytes.size());
+        REQUIRE(newDocument.buffers.front().data == newBytes);
+    }
+
+    SECTION("load mapped - save binary")
+    {
+#ifdef __cpp_lib_char8_t
+        FX_GLTF_FILESYSTEM::path originalFile{ "data/unιcode-ρath/Box.gltf" };
+#else
+        FX_GLTF_FILESYSTEM::path originalFile{ FX_GLTF_FILESYSTEM::u8path("data/unιcode-ρath/Box.gltf") };
+#endif
+        FX_GLTF_FILESYSTEM::path newFile{ utility::GetTestOutputDir() / "test10.glb" };
+
+        fx::gltf::Document originalDocument = fx::gltf::LoadFromText(originalFile);
+        fx::gltf::Document mappedDocument = fx::gltf::LoadFromTextMapped(originalFile);
+
+        REQUIRE(mappedDocument.buffers.front().externalData != nullptr);
+        REQUIRE(mappedDocument.buffers.front().data.empty());
+
+        fx::gltf::Span<uint8_t const> mappedData = mappedDocument.buffers.front().GetData();
+        REQUIRE(std::vector<uint8_t>(mappedData.begin(), mappedData.end()) == originalDocument.buffers.front().data);
+
+        mappedDocument.buffers.front().uri.clear();
+        fx::gltf::Save(mappedDocument, newFile, true);
+
+        fx::gltf::Document newDocument = fx::gltf::LoadFromBinaryMapped(newFile);
+        REQUIRE(newDocument.buffers.front().externalData != nullptr);
+
+        fx::gltf::Span<uint8_t const> newData = newDocument.buffers.front().GetData();
+        REQUIRE(std::vector<uint8_t>(newData.begin(), newData.end()) == originalDocument.buffers.front().data);
+        REQUIRE(fx::gltf::LoadFromBinary(newFile).buffers.front().data == originalDocument.buffers.front().data);
+
+        REQUIRE_THROWS_AS(fx::gltf::LoadFromTextMapped("not-exist"), std::system_error);
+        REQUIRE_THROWS_AS(fx::gltf::LoadFromBinaryMapped("not-exist"), std::system_error);
+        REQUIRE_THROWS_AS(fx::gltf::LoadFromBinaryMapped(originalFile), fx::gltf::invalid_gltf_document);
+    }
+
+    SECTION("load with buffer allocator - save binary")
+    {
+#ifdef __cpp_lib_char8_t
+        FX_GLTF_FILESYSTEM::path originalFile{ "data/unιcode-ρath/Box.gltf" };
+#else
+        FX_GLTF_FILESYSTEM::path originalFile{ FX_GLTF_FILESYSTEM::u8path("data/unιcode-ρath/Box.gltf") };
+#endif
+        FX_GLTF_FILESYSTEM::path newFile{ utility::GetTestOutputDir() / "test11.glb" };
+
+        // A simple arena standing in for application owned memory...
+        std::vector<uint8_t> arena(4096);
+        std::size_t arenaUsed = 0;
+        std::size_t releaseCount = 0;
+        fx::gltf::ReadOptions readOptions{};
+        readOptions.BufferAllocator = [&arena, &arenaUsed, &releaseCount](std::size_t byteLength) {
+            uint8_t * storage = &arena[arenaUsed];
+            arenaUsed += (byteLength + 3) & ~static_cast<std::size_t>(3);
+            return std::shared_ptr<uint8_t>(storage, [&releaseCount](uint8_t *) { releaseCount++; });
+        };
+
+        fx::gltf::Document originalDocument = fx::gltf::LoadFromText(originalFile);
+        {
+            fx::gltf::Document allocatedDocument = fx::gltf::LoadFromText(originalFile, {}, readOptions);
+
+            fx::gltf::Span<uint8_t const> allocatedData = allocatedDocument.buffers.front().GetData();
+            REQUIRE(allocatedData.data() == &arena[0]);
+            REQUIRE(allocatedDocument.buffers.front().data.empty());
+            REQUIRE(std::vector<uint8_t>(allocatedData.begin(), allocatedData.end()) == originalDocument.buffers.front().data);
+
+            allocatedDocument.buffers.front().uri.clear();
+            fx::gltf::Save(allocatedDocument, newFile, true);
+
+            fx::gltf::Document binaryDocument = fx::gltf::LoadFromBinary(newFile, {}, readOptions);
+            fx::gltf::Span<uint8_t const> binaryData = binaryDocument.buffers.front().GetData();
+            REQUIRE(binaryData.data() == &arena[allocatedData.size()]);
+            REQUIRE(std::vector<uint8_t>(binaryData.begin(), binaryData.end()) == originalDocument.buffers.front().data);
+
+            fx::gltf::BufferView const & bufferView = binaryDocument.bufferViews[1];
+            fx::gltf::Span<uint8_t const> bufferViewData = fx::gltf::GetData(binaryDocument, bufferView);
+            REQUIRE(bufferViewData.data() == binaryData.data() + bufferView.byteOffset);
+            REQUIRE(bufferViewData.size() == bufferView.byteLength);
+
+            fx::gltf::Accessor const & accessor = binaryDocument.accessors[1];
+            REQUIRE(fx::gltf::GetData(binaryDocument, accessor).data() == bufferViewData.data() + accessor.byteOffset);
+        }
+
+        REQUIRE(releaseCount == 2);
+    }
+
+    SECTION("load text - save embedded on save")
+    {
+#ifdef __cpp_lib_char8_t
+        FX_GLTF_FILESYSTEM::path originalFile{ "data/unιcode-ρath/Box.gltf" };
+#else
+        FX_GLTF_FILESYSTEM::path originalFile{ FX_GLTF_FILESYSTEM::u8path("data/unιcode-ρath/Box.gltf") };
+#endif
+
+        fx::gltf::Document embeddedDocument = fx::gltf::LoadFromText(originalFile);
+        fx::gltf::Document streamedDocument = embeddedDocument;
+
+        embeddedDocument.buffers.front().SetEmbeddedResource();
+        streamedDocument.buffers.front().SetEmbeddedResourceOnSave();
+        REQUIRE(streamedDocument.buffers.front().IsEmbeddedResource());
+        REQUIRE(streamedDocument.buffers.front().IsEmbeddedResourceOnSave());
+        REQUIRE_FALSE(embeddedDocument.buffers.front().IsEmbeddedResourceOnSave());
+
+        // Streaming the payload produces exactly the same text...
+        std::stringstream embedded{};
+        std::stringstream streamed{};
+        fx::gltf::Save(embeddedDocument, embedded, utility::GetTestOutputDir(), false);
+        fx::gltf::Save(streamedDocument, streamed, utility::GetTestOutputDir(), false);
+        REQUIRE(streamed.str() == embedded.str());
+
+        // ...and works for the additional buffers of a .glb
+        streamedDocument.buffers.push_back(streamedDocument.buffers.front());
+        streamedDocument.buffers.front().uri.clear();
+
+        std::stringstream binary{};
+        fx::gltf::Save(streamedDocument, binary, "", true);
+        binary.seekg(0, std::stringstream::beg);
+
+        fx::gltf::Document newDocument = fx::gltf::LoadFromBinary(binary, "");
+        REQUIRE(newDocument.buffers.size() == 2);
+        REQUIRE(newDocument.buffers.back().IsEmbeddedResource());
+        REQUIRE(newDocument.buffers.back().data == embeddedDocument.buffers.front().data);
+        REQUIRE(newDocument.buffers.front().data == embeddedDocument.buffers.front().data);
+    }
+
+    SECTION("save text - matches json tree")
+    {
+#ifdef __cpp_lib_char8_t
+        FX_GLTF_FILESYSTEM::path originalFile{ "data/unιcode-ρath/Box.gltf" };
+#else
+        FX_GLTF_FILESYSTEM::path originalFile{ FX_GLTF_FILESYSTEM::u8path("data/unιcode-ρath/Box.gltf") };
+#endif
+
+        fx::gltf::Document document = fx::gltf::LoadFromText(originalFile);
+        document.accessors[0].min = { 0 };
+        document.accessors[0].max = { 23 };
+        document.asset.extensionsAndExtras["extras"] = { { "text", "quote \" slash \\ tab \t control \x01 unιcode" }, { "values", { 1, -2, 0.1, true, nullptr } } };
+        document.materials[0].normalTexture.index = 0;
+        document.materials[0].normalTexture.scale = 0.5f;
+        document.materials[0].normalTexture.extensionsAndExtras["extensions"]["EXT_test"] = nlohmann::json::object();
+        document.samplers.push_back({});
+        document.nodes[0].rotation = { 0.1f, 0.2f, 0.3f, 1.0f };
+        document.meshes[0].weights = { 1e-7f, 3.4e38f };
+        document.nodes[0].children = { 1 };
+        document.nodes[1].name = "child";
+
+        // Numbers are laid out as dump does...
+        for (double value : { 0.0, -0.0, 1.0, -2.5, 0.1, 1e-4, 1e-5, 123456.789, 1e15, 1e16, 3.4e38, -1e-7 })
+        {
+            std::array<char, 32> formatted{};
+            char const * end = fx::gltf::detail::FormatDouble(formatted.data(), value);
+            REQUIRE(std::string(formatted.data(), static_cast<std::size_t>(end - formatted.data())) == nlohmann::json(value).dump());
+        }
+
+        // Keys are written sorted, as the json tree keeps them...
+        document.extensionsUsed = { "EXT_test" };
+        document.extensionsRequired = { "EXT_test" };
+        document.extensionsAndExtras["extensions"]["EXT_test"] = nlohmann::json::object();
+        document.extensionsAndExtras["extras"] = { { "a", 1 } };
+        document.cameras.push_back({});
+        document.cameras.back().name = "camera";
+        document.cameras.back().type = fx::gltf::Camera::Type::Orthographic;
+        document.cameras.back().orthographic.xmag = 1.0f;
+        document.cameras.back().orthographic.ymag = 1.0f;
+        document.cameras.back().orthographic.zfar = 100.0f;
+        document.cameras.back().orthographic.znear = 0.01f;
+        document.skins.push_back({});
+        document.skins.back().name = "skin";
+        document.skins.back().joints = { 0 };
+        document.skins.back().skeleton = 0;
+
+        std::stringstream text{};
+        fx::gltf::Save(document, text, utility::GetTestOutputDir(), false);
+        REQUIRE(nlohmann::json::parse(text.str()) == nlohmann::json(document));
+        REQUIRE(text.str() == nlohmann::json(document).dump(2));
+
+        std::stringstream binary{};
+        document.buffers.front().uri.clear();
+        fx::gltf::Save(document, binary, "", true);
+        binary.seekg(0, std::stringstream::beg);
+        fx::gltf::Document binaryDocument = fx::gltf::LoadFromBinary(binary, "");
+        REQUIRE(nlohmann::json(binaryDocument) == nlohmann::json(document));
+
+        // ...and so is the formatting of escaped strings and embedded buffers
+        fx::gltf::Document sorted{};
+        sorted.asset.generator = "fx-gltf";
+        sorted.buffers.push_back(document.buffers.front());
+        sorted.buffers.front().name = "\n";
+        sorted.buffers.front().SetEmbeddedResource();
+        sorted.nodes = document.nodes;
+        sorted.scene = 0;
+        sorted.scenes.push_back({});
+        sorted.scenes.front().nodes = { 0 };
+
+        std::stringstream sortedText{};
+        fx::gltf::Save(sorted, sortedText, "", false);
+        REQUIRE(sortedText.str() == nlohmann::json(sorted).dump(2));
+    }
+
+    SECTION("load text - sax parser matches json tree")
+    {
+        const nlohmann::json json = R"(
+            {
+              "extensionsUsed": [ "EXT_a" ], "extensionsRequired": [ "EXT_a" ],
+              "unknown": { "nested": [ 1, { "deep": [ [], {} ] } ] },
+              "accessors": [ {
+                  "bufferView": 0, "byteOffset": 4, "componentType": 5126, "count": 2, "type": "VEC3", "normalized": true,
+                  "min": [ -1, -2.5, 3 ], "max": [ 1, 2.5, 4e10 ], "name": "p\u00e9",
+                  "sparse": { "count": 1, "indices": { "bufferView": 0, "componentType": 5123, "extras": 5 }, "values": { "bufferView": 0, "byteOffset": 2 } }
+              } ],
+              "animations": [ {
+                  "channels": [ { "sampler": 0, "target": { "node": 1, "path": "rotation" } } ],
+                  "samplers": [ { "input": 0, "interpolation": "CUBICSPLINE", "output": 0 } ]
+              } ],
+              "asset": { "version": "2.0", "generator": "gen", "extensions": { "EXT_a": { "v": [ null, true, -3, 18446744073709551615, 0.5, "s" ] } } },
+              "buffers": [ { "byteLength": 10, "uri": "data:application/octet-stream;base64,AAAAAAAAAAAAAA==", "name": "b" } ],
+              "bufferViews": [ { "buffer": 0, "byteLength": 10, "byteStride": 4, "target": 34962 } ],
+              "cameras": [ { "type": "perspective", "perspective": { "yfov": 0.6, "znear": 1.0 } }, { "orthographic": { "xmag": 1, "ymag": 2, "zfar": 3, "znear": 0 }, "type": "orthographic" } ],
+              "images": [ { "bufferView": 0, "mimeType": "image/png" } ],
+              "materials": [ {
+                  "alphaMode": "MASK", "alphaCutoff": 0.25, "doubleSided": true, "emissiveFactor": [ 1, 0.5, 0 ],
+                  "pbrMetallicRoughness": { "baseColorFactor": [ 1, 0, 0, 1 ], "baseColorTexture": { "index": 0, "texCoord": 1 }, "metallicFactor": 0 },
+                  "normalTexture": { "index": 0, "scale": 2 }, "occlusionTexture": { "index": 0, "strength": 0.5, "extras": [ 1 ] }
+              } ],
+              "meshes": [ { "primitives": [ { "attributes": { "NORMAL": 1, "POSITION": 0 }, "indices": 0, "material": 0, "mode": 1, "targets": [ { "POSITION": 0 } ] } ], "weights": [ 0.5 ] } ],
+              "nodes": [ { "children": [ 1 ], "mesh": 0, "matrix": [ 2, 0, 0, 0, 0, 2, 0, 0, 0, 0, 2, 0, 0, 0, 0, 1 ] }, { "rotation": [ 0, 1, 0, 0 ], "scale": [ 2, 2, 2 ], "translation": [ 1, 2, 3 ], "camera": 0, "skin": 0, "weights": [ 1 ] } ],
+              "samplers": [ { "magFilter": 9728, "minFilter": 9987, "wrapS": 33071, "wrapT": 33648 } ],
+              "scene": 0,
+              "scenes": [ { "name": "s", "nodes": [ 0 ] } ],
+              "skins": [ { "joints": [ 1 ], "inverseBindMatrices": 0, "skeleton": 1 } ],
+              "textures": [ { "sampler": 0, "source": 0 } ],
+              "extras": { "key": "value" }
+            }
+        )"_json;
+
+        const fx::gltf::Document treeDocument = json;
+
+        std::istringstream input(json.dump());
+        const fx::gltf::Document saxDocument = fx::gltf::LoadFromText(input, "");
+
+        REQUIRE(nlohmann::json(saxDocument) == nlohmann::json(treeDocument));
+        REQUIRE(saxDocument.buffers.front().data == std::vector<uint8_t>(10));
+    }
+
+    SECTION("load text - external buffers in parallel")
+    {
+        FX_GLTF_FILESYSTEM::path documentFile{ utility::GetTestOutputDir() / "parallel.gltf" };
+
+        fx::gltf::Document document{};
+        for (uint32_t i = 0; i < 6; i++)
+        {
+            fx::gltf::Buffer buffer{};
+            buffer.byteLength = 1000 + i;
+            buffer.data.resize(buffer.byteLength);
+            std::iota(buffer.data.begin(), buffer.data.end(), static_cast<uint8_t>(i));
+            buffer.uri = "parallel" + std::to_string(i) + ".bin";
+            if (i == 4)
+            {
+                buffer.SetEmbeddedResource();
+            }
+
+            document.buffers.push_back(buffer);
+        }
+
+        fx::gltf::Save(document, documentFile, false);
+
+        fx::gltf::ReadOptions readOptions{};
+        readOptions.MaxThreadCount = 4;
+        fx::gltf::Document loaded = fx::gltf::LoadFromText(documentFile, {}, readOptions);
+        fx::gltf::Document mapped = fx::gltf::LoadFromTextMapped(documentFile, {}, readOptions);
+        for (std::size_t i = 0; i < document.buffers.size(); i++)
+        {
+            REQUIRE(loaded.buffers[i].data == document.buffers[i].data);
+            REQUIRE(std::equal(document.buffers[i].data.begin(), document.buffers[i].data.end(), mapped.buffers[i].GetData().begin()));
+        }
+
+        // A failing buffer is reported by its uri even though the others still load
+        FX_GLTF_FILESYSTEM::remove(utility::GetTestOutputDir() / "parallel3.bin");
+        readOptions.MaxThreadCount = 0;
+        REQUIRE_THROWS_WITH(fx::gltf::LoadFromText(documentFile, {}, readOptions), Catch::Contains("parallel3.bin"));
+    }
+
+    SECTION("load async - buffers complete in the background")
+    {
+        FX_GLTF_FILESYSTEM::path textFile{ utility::GetTestOutputDir() / "async.gltf" };
+        FX_GLTF_FILESYSTEM::path binaryFile{ utility::GetTestOutputDir() / "async.glb" };
+
+        fx::gltf::Document document{};
+        for (uint32_t i = 0; i < 4; i++)
+        {
+            fx::gltf::Buffer buffer{};
+            buffer.byteLength = 2000 + i;
+            buffer.data.resize(buffer.byteLength);
+            std::iota(buffer.data.begin(), buffer.data.end(), static_cast<uint8_t>(i));
+            buffer.uri = i == 0 ? "" : "async" + std::to_string(i) + ".bin";
+
+            document.buffers.push_back(buffer);
+        }
+
+        fx::gltf::Save(document, binaryFile, true);
+        document.buffers[0].uri = "async0.bin";
+        fx::gltf::Save(document, textFile, false);
+
+        fx::gltf::ReadOptions readOptions{};
+        readOptions.MaxThreadCount = 2;
+        fx::gltf::AsyncDocument text = fx::gltf::LoadFromTextAsync(textFile, {}, readOptions);
+        REQUIRE(text.GetDocument().buffers.size() == 4);
+        REQUIRE(text.WaitForBuffer(2).data == document.buffers[2].data);
+
+        fx::gltf::AsyncDocument binary = fx::gltf::LoadFromBinaryAsync(binaryFile, {}, readOptions);
+        REQUIRE(binary.IsBufferReady(0));
+        REQUIRE(binary.GetDocument().buffers[0].data == document.buffers[0].data);
+
+        fx::gltf::Document loadedText = text.Release();
+        fx::gltf::Document loadedBinary = binary.Release();
+        for (std::size_t i = 0; i < document.buffers.size(); i++)
+        {
+            REQUIRE(loadedText.buffers[i].data == document.buffers[i].data);
+            REQUIRE(loadedBinary.buffers[i].data == document.buffers[i].data);
+        }
+
+        // Moving the AsyncDocument while a large buffer is still loading keeps the load going into the new owner
+        FX_GLTF_FILESYSTEM::path largeFile{ utility::GetTestOutputDir() / "async-large.gltf" };
+        fx::gltf::Document large = document;
+        large.buffers[3].byteLength = 24 * 1024 * 1024;
+        large.buffers[3].data.resize(large.buffers[3].byteLength, 7);
+        large.buffers[3].uri = "async-large.bin";
+        fx::gltf::Save(large, largeFile, false);
+
+        fx::gltf::AsyncDocument moving = fx::gltf::LoadFromTextAsync(largeFile, {}, readOptions);
+        fx::gltf::AsyncDocument moved = std::move(moving);
+        fx::gltf::AsyncDocument assigned{};
+        assigned = std::move(moved);
+        REQUIRE(assigned.Release().buffers[3].data == large.buffers[3].data);
+
+        // A failing buffer only fails its own future
+        FX_GLTF_FILESYSTEM::remove(utility::GetTestOutputDir() / "async2.bin");
+        fx::gltf::AsyncDocument failing = fx::gltf::LoadFromBinaryAsync(binaryFile, {}, readOptions);
+        REQUIRE(failing.WaitForBuffer(3).data == document.buffers[3].data);
+        REQUIRE_THROWS_WITH(failing.WaitForBuffer(2), Catch::Contains("async2.bin"));
+        REQUIRE_THROWS_WITH(failing.WaitAll(), Catch::Contains("async2.bin"));
+    }
+
+    SECTION("load deferred - buffers read on first use")
+    {
+        FX_GLTF_FILESYSTEM::path textFile{ utility::GetTestOutputDir() / "deferred.gltf" };
+        FX_GLTF_FILESYSTEM::path binaryFile{ utility::GetTestOutputDir() / "deferred.glb" };
+
+        fx::gltf::Document document{};
+        for (uint32_t i = 0; i < 3; i++)
+        {
+            fx::gltf::Buffer buffer{};
+            buffer.byteLength = 500 + i;
+            buffer.data.resize(buffer.byteLength);
+            std::iota(buffer.data.begin(), buffer.data.end(), static_cast<uint8_t>(i));
+            buffer.uri = i == 0 ? "" : "deferred" + std::to_string(i) + ".bin";
+            if (i == 2)
+            {
+                buffer.SetEmbeddedResource();
+            }
+
+            document.buffers.push_back(buffer);
+        }
+
+        fx::gltf::BufferView bufferView{};
+        bufferView.buffer = 0;
+        bufferView.byteOffset = 100;
+        bufferView.byteLength = 200;
+        document.bufferViews.push_back(bufferView);
+
+        fx::gltf::Save(document, binaryFile, true);
+
+        fx::gltf::ReadOptions readOptions{};
+        readOptions.DeferBufferData = true;
+        fx::gltf::Document loaded = fx::gltf::LoadFromBinary(binaryFile, {}, readOptions);
+        for (fx::gltf::Buffer const & buffer : loaded.buffers)
+        {
+            REQUIRE(buffer.data.empty());
+            REQUIRE(buffer.deferredData != nullptr);
+        }
+
+        const fx::gltf::Span<uint8_t const> view = fx::gltf::GetData(loaded, loaded.bufferViews[0]);
+        REQUIRE(std::equal(view.begin(), view.end(), document.buffers[0].data.begin() + 100));
+
+        fx::gltf::Document copy = loaded;
+        for (std::size_t i = 0; i < document.buffers.size(); i++)
+        {
+            REQUIRE(std::equal(document.buffers[i].data.begin(), document.buffers[i].data.end(), copy.buffers[i].GetData().begin()));
+            REQUIRE(copy.buffers[i].GetData().data() == loaded.buffers[i].GetData().data());
+        }
+
+        // Missing files only surface once the buffer is requested
+        document.buffers[0].uri = "deferred0.bin";
+        fx::gltf::Save(document, textFile, false);
+        FX_GLTF_FILESYSTEM::remove(utility::GetTestOutputDir() / "deferred1.bin");
+
+        fx::gltf::Document partial = fx::gltf::LoadFromText(textFile, {}, readOptions);
+        REQUIRE(partial.buffers[0].GetData().size() == document.buffers[0].byteLength);
+        REQUIRE_THROWS_WITH(partial.buffers[1].GetData(), Catch::Contains("deferred1.bin"));
+        REQUIRE(partial.buffers[2].GetData().size() == document.buffers[2].byteLength);
+    }
+
+    SECTION("load header only - buffers are not read")
+    {
+        FX_GLTF_FILESYSTEM::path textFile{ utility::GetTestOutputDir() / "header.gltf" };
+        FX_GLTF_FILESYSTEM::path binaryFile{ utility::GetTestOutputDir() / "header.glb" };
+
+        fx::gltf::Document document{};
+        for (uint32_t i = 0; i < 2; i++)
+        {
+            fx::gltf::Buffer buffer{};
+            buffer.byteLength = 300 + i;
+            buffer.data.resize(buffer.byteLength);
+            std::iota(buffer.data.begin(), buffer.data.end(), static_cast<uint8_t>(i));
+            buffer.uri = i == 0 ? "" : "header1.bin";
+
+            document.buffers.push_back(buffer);
+        }
+
+        document.materials.resize(1);
+        document.materials[0].name = "header";
+
+        fx::gltf::Save(document, binaryFile, true);
+        document.buffers[0].uri = "header0.bin";
+        fx::gltf::Save(document, textFile, false);
+        FX_GLTF_FILESYSTEM::remove(utility::GetTestOutputDir() / "header1.bin");
+
+        std::ifstream file(binaryFile, std::ios::binary);
+        const std::string glb{ std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>() };
+
+        fx::gltf::DocumentHeader header = fx::gltf::LoadFromBinaryHeaderOnly(binaryFile);
+        REQUIRE(header.document.materials[0].name == "header");
+        REQUIRE(header.document.buffers[0].data.empty());
+        REQUIRE(header.binaryChunkLength >= document.buffers[0].byteLength);
+        REQUIRE(std::equal(document.buffers[0].data.begin(), document.buffers[0].data.end(), reinterpret_cast<uint8_t const *>(&glb[header.binaryChunkOffset])));
+
+        // Nothing past the BIN chunk header is needed
+        std::istringstream truncated(glb.substr(0, header.binaryChunkOffset));
+        REQUIRE(fx::gltf::LoadFromBinaryHeaderOnly(truncated).binaryChunkOffset == header.binaryChunkOffset);
+
+        fx::gltf::DocumentHeader text = fx::gltf::LoadFromTextHeaderOnly(textFile);
+        REQUIRE(text.document.buffers.size() == 2);
+        REQUIRE(text.document.buffers[1].uri == "header1.bin");
+        REQUIRE(text.binaryChunkLength == 0);
+
+        fx::gltf::ReadQuotas readQuotas{};
+        readQuotas.MaxBufferByteLength = 300;
+        REQUIRE_THROWS_WITH(fx::gltf::LoadFromTextHeaderOnly(textFile, readQuotas), Catch::Contains("MaxBufferByteLength"));
+    }
+
+    SECTION("load partial - only ranges used by the scene are read")
+    {
+        FX_GLTF_FILESYSTEM::path documentFile{ utility::GetTestOutputDir() / "partial.gltf" };
+
+        fx::gltf::Document document{};
+        document.buffers.resize(1);
+        document.buffers[0].byteLength = 10000;
+        document.buffers[0].data.resize(10000);
+        std::iota(document.buffers[0].data.begin(), document.buffers[0].data.end(), static_cast<uint8_t>(1));
+        document.buffers[0].uri = "partial.bin";
+
+        const std::array<std::array<uint32_t, 2>, 4> views{ { { 0, 100 }, { 150, 100 }, { 5000, 100 }, { 9000, 500 } } };
+        for (std::array<uint32_t, 2> const & view : views)
+        {
+            fx::gltf::BufferView bufferView{};
+            bufferView.buffer = 0;
+            bufferView.byteOffset = view[0];
+            bufferView.byteLength = view[1];
+            document.bufferViews.push_back(bufferView);
+
+            fx::gltf::Accessor accessor{};
+            accessor.bufferView = static_cast<int32_t>(document.accessors.size());
+            accessor.componentType = fx::gltf::Accessor::ComponentType::UnsignedByte;
+            accessor.type = fx::gltf::Accessor::Type::Scalar;
+            accessor.count = view[1];
+            document.accessors.push_back(accessor);
+        }
+
+        // Scene 0: node 0 (mesh 0, textured through bufferView 3) with child node 1. Scene 1: node 2 (mesh 1)
+        document.images.resize(1);
+        document.images[0].bufferView = 3;
+        document.images[0].mimeType = "image/png";
+        document.textures.resize(1);
+        document.textures[0].source = 0;
+        document.materials.resize(1);
+        document.materials[0].pbrMetallicRoughness.baseColorTexture.index = 0;
+
+        document.meshes.resize(2);
+        document.meshes[0].primitives.resize(1);
+        document.meshes[0].primitives[0].attributes["POSITION"] = 0;
+        document.meshes[0].primitives[0].indices = 1;
+        document.meshes[0].primitives[0].material = 0;
+        document.meshes[1].primitives.resize(1);
+        document.meshes[1].primitives[0].attributes["POSITION"] = 2;
+
+        document.nodes.resize(3);
+        document.nodes[0].mesh = 0;
+        document.nodes[0].children.push_back(1);
+        document.nodes[2].mesh = 1;
+        document.scenes.resize(2);
+        document.scenes[0].nodes.push_back(0);
+        document.scenes[1].nodes.push_back(2);
+
+        fx::gltf::Save(document, documentFile, false);
+
+        fx::gltf::ReadQuotas readQuotas{};
+        fx::gltf::ReadOptions readOptions{};
+        readOptions.PartialLoadScene = 0;
+        readOptions.PartialLoadMaxGap = 100;
+
+        fx::gltf::Document loaded = fx::gltf::LoadFromText(documentFile, readQuotas, readOptions);
+        REQUIRE(loaded.buffers[0].data.size() == 10000);
+        for (std::size_t view : { 0, 1, 3 })
+        {
+            const fx::gltf::Span<uint8_t const> expected = fx::gltf::GetData(document, document.bufferViews[view]);
+            const fx::gltf::Span<uint8_t const> actual = fx::gltf::GetData(loaded, loaded.bufferViews[view]);
+            REQUIRE(std::equal(expected.begin(), expected.end(), actual.begin()));
+        }
+
+        const fx::gltf::Span<uint8_t const> unused = fx::gltf::GetData(loaded, loaded.bufferViews[2]);
+        REQUIRE(std::all_of(unused.begin(), unused.end(), [](uint8_t value) { return value == 0; }));
+
+        // Neighbours within the gap are read together
+        std::shared_ptr<MemoryResolver> resolver = std::make_shared<MemoryResolver>();
+        resolver->files["partial.bin"] = document.buffers[0].data;
+        readOptions.Resolver = resolver;
+
+        loaded = fx::gltf::LoadFromText(documentFile, readQuotas, readOptions);
+        REQUIRE(resolver->ranges == std::vector<std::array<uint64_t, 2>>{ { 0, 250 }, { 9000, 500 } });
+        REQUIRE(fx::gltf::GetData(loaded, loaded.bufferViews[3])[0] == document.buffers[0].data[9000]);
+
+        resolver->ranges.clear();
+        readOptions.PartialLoadScene = 1;
+        readOptions.PartialLoadMaxGap = 0;
+        loaded = fx::gltf::LoadFromText(documentFile, readQuotas, readOptions);
+        REQUIRE(resolver->ranges == std::vector<std::array<uint64_t, 2>>{ { 5000, 100 } });
+
+        readOptions.PartialLoadScene = 2;
+        REQUIRE_THROWS_WITH(fx::gltf::LoadFromText(documentFile, readQuotas, readOptions), Catch::Contains("scene"));
+    }
+
+    SECTION("load text - external buffers through a resolver")
+    {
+        FX_GLTF_FILESYSTEM::path documentFile{ utility::GetTestOutputDir() / "resolved.gltf" };
+
+        fx::gltf::Document document{};
+        for (uint32_t i = 0; i < 3; i++)
+        {
+            fx::gltf::Buffer buffer{};
+            buffer.byteLength = 700 + i;
+            buffer.data.resize(buffer.byteLength);
+            std::iota(buffer.data.begin(), buffer.data.end(), static_cast<uint8_t>(i));
+            buffer.uri = "blob/" + std::to_string(i);
+            if (i == 1)
+            {
+                buffer.SetEmbeddedResource();
+            }
+
+            document.buffers.push_back(buffer);
+        }
+
+        std::shared_ptr<MemoryResolver> resolver = std::make_shared<MemoryResolver>();
+        fx::gltf::SaveOptions saveOptions{};
+        saveOptions.Resolver = resolver;
+        fx::gltf::Save(document, documentFile, false, saveOptions);
+        REQUIRE(resolver->files.size() == 2);
+        REQUIRE(resolver->files["blob/2"] == document.buffers[2].data);
+        REQUIRE_FALSE(FX_GLTF_FILESYSTEM::exists(utility::GetTestOutputDir() / "blob"));
+
+        // Every read is issued before the first one is waited on
+        fx::gltf::ReadOptions readOptions{};
+        readOptions.Resolver = resolver;
+        fx::gltf::Document loaded = fx::gltf::LoadFromText(documentFile, {}, readOptions);
+        REQUIRE(resolver->events == std::vector<std::string>{ "read blob/0", "read blob/2", "done blob/0", "done blob/2" });
+        for (std::size_t i = 0; i < document.buffers.size(); i++)
+        {
+            REQUIRE(loaded.buffers[i].data == document.buffers[i].data);
+        }
+
+        readOptions.DeferBufferData = true;
+        fx::gltf::Document deferred = fx::gltf::LoadFromText(documentFile, {}, readOptions);
+        REQUIRE(std::equal(document.buffers[2].data.begin(), document.buffers[2].data.end(), deferred.buffers[2].GetData().begin()));
+
+        resolver->files.erase("blob/0");
+        readOptions.DeferBufferData = false;
+        REQUIRE_THROWS_WITH(fx::gltf::LoadFromText(documentFile, {}, readOptions), Catch::Contains("blob/0"));
+    }
+
+    SECTION("load text - external buffers shared through a cache")
+    {
+        FX_GLTF_FILESYSTEM::path firstFile{ utility::GetTestOutputDir() / "first.gltf" };
+        FX_GLTF_FILESYSTEM::path secondFile{ utility::GetTestOutputDir() / "second.gltf" };
+        FX_GLTF_FILESYSTEM::path sharedFile{ utility::GetTestOutputDir() / "shared.bin" };
+
+        fx::gltf::Document document{};
+        document.buffers.resize(1);
+        document.buffers[0].byteLength = 1000;
+        document.buffers[0].data.resize(1000);
+        std::iota(document.buffers[0].data.begin(), document.buffers[0].data.end(), static_cast<uint8_t>(0));
+        document.buffers[0].uri = "shared.bin";
+
+        fx::gltf::Save(document, firstFile, false);
+        document.materials.resize(1);
+        fx::gltf::Save(document, secondFile, false);
+
+        fx::gltf::ReadOptions readOptions{};
+        readOptions.BufferCache = std::make_shared<fx::gltf::SharedBufferCache>();
+        {
+            fx::gltf::Document first = fx::gltf::LoadFromText(firstFile, {}, readOptions);
+            fx::gltf::Document second = fx::gltf::LoadFromText(secondFile, {}, readOptions);
+            REQUIRE(first.buffers[0].GetData().data() == second.buffers[0].GetData().data());
+            REQUIRE(std::equal(document.buffers[0].data.begin(), document.buffers[0].data.end(), second.buffers[0].GetData().begin()));
+            REQUIRE(readOptions.BufferCache->size() == 1);
+        }
+
+        REQUIRE(readOptions.BufferCache->size() == 0);
+
+        // A rewritten file is read again
+        fx::gltf::Document first = fx::gltf::LoadFromText(firstFile, {}, readOptions);
+        std::reverse(document.buffers[0].data.begin(), document.buffers[0].data.end());
+        fx::gltf::Save(document, secondFile, false);
+        FX_GLTF_FILESYSTEM::last_write_time(sharedFile, FX_GLTF_FILESYSTEM::last_write_time(sharedFile) + std::chrono::hours(1));
+
+        fx::gltf::Document second = fx::gltf::LoadFromTextMapped(secondFile, {}, readOptions);
+        REQUIRE(first.buffers[0].GetData().data() != second.buffers[0].GetData().data());
+        REQUIRE(std::equal(document.buffers[0].data.begin(), document.buffers[0].data.end(), second.buffers[0].GetData().begin()));
+    }
+
+    SECTION("save binary - bin chunk streamed from parts")
+    {
+        FX_GLTF_FILESYSTEM::path streamedFile{ utility::GetTestOutputDir() / "streamed.glb" };
+        FX_GLTF_FILESYSTEM::path concatenatedFile{ utility::GetTestOutputDir() / "concatenated.glb" };
+
+        std::vector<uint8_t> first(100);
+        std::vector<uint8_t> last(7);
+        std::iota(first.begin(), first.end(), static_cast<uint8_t>(10));
+        std::iota(last.begin(), last.end(), static_cast<uint8_t>(200));
+
+        std::vector<uint8_t> generated(200);
+        std::iota(generated.begin(), generated.end(), static_cast<uint8_t>(50));
+
+        std::vector<fx::gltf::BinaryChunkPart> parts{};
+        parts.push_back({ { first.data(), first.size() } });
+        parts.push_back({ {}, generated.size(), [&generated](std::ostream & output) {
+                             // Written in small pieces, as an encoder producing output on the fly would
+                             for (std::size_t i = 0; i < generated.size(); i += 16)
+                             {
+                                 output.write(reinterpret_cast<char const *>(&generated[i]), static_cast<std::streamsize>(std::min<std::size_t>(16, generated.size() - i)));
+                             }
+                         } });
+        parts.push_back({ { last.data(), last.size() } });
+
+        fx::gltf::Document document{};
+        document.buffers.resize(1);
+        document.buffers[0].byteLength = first.size() + generated.size() + last.size();
+        fx::gltf::SaveBinary(document, parts, streamedFile);
+
+        document.buffers[0].data = first;
+        document.buffers[0].data.insert(document.buffers[0].data.end(), generated.begin(), generated.end());
+        document.buffers[0].data.insert(document.buffers[0].data.end(), last.begin(), last.end());
+        fx::gltf::Save(document, concatenatedFile, true);
+
+        std::ifstream streamed(streamedFile, std::ios::binary);
+        std::ifstream concatenated(concatenatedFile, std::ios::binary);
+        REQUIRE(std::string{ std::istreambuf_iterator<char>(streamed), std::istreambuf_iterator<char>() } ==
+                std::string{ std::istreambuf_iterator<char>(concatenated), std::istreambuf_iterator<char>() });
+        REQUIRE(fx::gltf::LoadFromBinary(streamedFile).buffers[0].data == document.buffers[0].data);
+
+        document.buffers[0].data.clear();
+        document.buffers[0].byteLength++;
+        REQUIRE_THROWS_WITH(fx::gltf::SaveBinary(document, parts, streamedFile), Catch::Contains("binary chunk size"));
+
+        // The callback writes one byte less than it announced
+        parts[1].byteLength++;
+        REQUIRE_THROWS_WITH(fx::gltf::SaveBinary(document, parts, streamedFile), Catch::Contains("binary chunk part"));
+    }
+
+    SECTION("save binary - unused data removed and buffers packed")
+    {
+        FX_GLTF_FILESYSTEM::path packedFile{ utility::GetTestOutputDir() / "packed.glb" };
+
+        fx::gltf::Document document{};
+        document.buffers.resize(2);
+        document.buffers[0].data.resize(64);
+        document.buffers[1].data.resize(30);
+        document.buffers[1].uri = "other.bin";
+        for (fx::gltf::Buffer & buffer : document.buffers)
+        {
+            std::iota(buffer.data.begin(), buffer.data.end(), static_cast<uint8_t>(buffer.data.size()));
+            buffer.byteLength = buffer.data.size();
+        }
+
+        // Positions, indices, an orphaned accessor's data and an image; only the orphan leaves bytes behind
+        document.bufferViews.resize(4);
+        document.bufferViews[0] = { "", 0, 0, 12 };
+        document.bufferViews[1] = { "", 1, 6, 6 };
+        document.bufferViews[2] = { "", 0, 40, 4 };
+        document.bufferViews[3] = { "", 1, 20, 4 };
+
+        document.accessors.resize(3);
+        document.accessors[0].bufferView = 0;
+        document.accessors[0].count = 1;
+        document.accessors[0].componentType = fx::gltf::Accessor::ComponentType::Float;
+        document.accessors[0].type = fx::gltf::Accessor::Type::Vec3;
+        document.accessors[1].bufferView = 1;
+        document.accessors[1].count = 3;
+        document.accessors[1].componentType = fx::gltf::Accessor::ComponentType::UnsignedShort;
+        document.accessors[1].type = fx::gltf::Accessor::Type::Scalar;
+        document.accessors[2] = document.accessors[0];
+        document.accessors[2].bufferView = 2;
+        document.accessors[2].componentType = fx::gltf::Accessor::ComponentType::UnsignedInt;
+        document.accessors[2].type = fx::gltf::Accessor::Type::Scalar;
+
+        document.images.resize(2);
+        document.images[0].uri = "unused.png";
+        document.images[1].bufferView = 3;
+        document.images[1].mimeType = "image/png";
+        document.textures.resize(1);
+        document.textures[0].source = 1;
+        document.materials.resize(2);
+        document.materials[1].pbrMetallicRoughness.baseColorTexture.index = 0;
+
+        document.meshes.resize(2);
+        document.meshes[0].primitives.resize(1);
+        document.meshes[0].primitives[0].attributes["POSITION"] = 0;
+        document.meshes[0].primitives[0].indices = 1;
+        document.meshes[0].primitives[0].material = 1;
+        document.meshes[1].primitives.resize(1);
+        document.meshes[1].primitives[0].attributes["POSITION"] = 2;
+        document.nodes.resize(1);
+        document.nodes[0].mesh = 0;
+        document.scenes.resize(1);
+        document.scenes[0].nodes.push_back(0);
+
+        auto bytes = [](fx::gltf::Span<uint8_t const> data) { return std::vector<uint8_t>(data.begin(), data.end()); };
+        const std::vector<uint8_t> positions = bytes(fx::gltf::GetData(static_cast<fx::gltf::Document const &>(document), document.accessors[0]));
+        const std::vector<uint8_t> indices = bytes(fx::gltf::GetData(static_cast<fx::gltf::Document const &>(document), document.accessors[1]));
+        const std::vector<uint8_t> image = bytes(fx::gltf::GetData(static_cast<fx::gltf::Document const &>(document), document.bufferViews[3]));
+
+        fx::gltf::Document packed = document;
+        fx::gltf::PackBuffers(packed, { true, true });
+        REQUIRE(packed.buffers.size() == 1);
+        REQUIRE(packed.buffers[0].uri.empty());
+        REQUIRE(packed.buffers[0].byteLength == 26);
+        REQUIRE(packed.bufferViews[1].byteOffset == 16);
+        REQUIRE(bytes(fx::gltf::GetData(static_cast<fx::gltf::Document const &>(packed), packed.accessors[1])) == indices);
+
+        fx::gltf::RemoveUnusedData(document);
+        REQUIRE(document.meshes.size() == 1);
+        REQUIRE(document.materials.size() == 1);
+        REQUIRE(document.meshes[0].primitives[0].material == 0);
+        REQUIRE(document.images.size() == 1);
+        REQUIRE(document.textures[0].source == 0);
+        REQUIRE(document.accessors.size() == 2);
+        REQUIRE(document.bufferViews.size() == 3);
+        REQUIRE(document.images[0].bufferView == 2);
+        REQUIRE(document.buffers.size() == 2);
+        REQUIRE(document.buffers[0].byteLength == 12);
+        REQUIRE(document.buffers[1].byteLength == 12);
+        REQUIRE(document.buffers[1].uri == "other.bin");
+
+        fx::gltf::PackBuffers(document);
+        fx::gltf::Save(document, packedFile, true);
+
+        fx::gltf::Document const loaded = fx::gltf::LoadFromBinary(packedFile);
+        REQUIRE(loaded.buffers.size() == 1);
+        REQUIRE(bytes(fx::gltf::GetData(loaded, loaded.accessors[0])) == positions);
+        REQUIRE(bytes(fx::gltf::GetData(loaded, loaded.accessors[1])) == indices);
+        REQUIRE(bytes(fx::gltf::GetData(loaded, loaded.bufferViews[loaded.images[0].bufferView])) == image);
+
+        document.nodes[0].mesh = 5;
+        REQUIRE_THROWS_WITH(fx::gltf::RemoveUnusedData(document), Catch::Contains("node.mesh"));
+    }
+
+    SECTION("save binary - duplicate bufferViews and accessors merged")
+    {
+        // Two views span several hash blocks and differ in their very last byte
+        constexpr std::size_t LargeSize = 3 * 1024 * 1024 + 100;
+
+        fx::gltf::Document document{};
+        document.buffers.resize(1);
+        document.buffers[0].data.resize(2 * LargeSize + 48);
+        for (std::size_t i = 0; i < document.buffers[0].data.size(); i++)
+        {
+            document.buffers[0].data[i] = static_cast<uint8_t>((i % LargeSize) * 7);
+        }
+
+        document.buffers[0].data[2 * LargeSize - 1]++;
+        document.buffers[0].data[2 * LargeSize + 24] = 1;
+        document.buffers[0].byteLength = document.buffers[0].data.size();
+
+        document.bufferViews.resize(5);
+        document.bufferViews[0] = { "", 0, 0, LargeSize };
+        document.bufferViews[1] = { "", 0, LargeSize, LargeSize };
+        document.bufferViews[2] = { "", 0, 2 * LargeSize, 24 };
+        document.bufferViews[3] = { "", 0, 2 * LargeSize + 24, 24 };
+        document.bufferViews[4] = { "", 0, 0, 24 };
+
+        document.accessors.resize(5);
+        for (std::size_t i = 0; i < document.accessors.size(); i++)
+        {
+            document.accessors[i].bufferView = static_cast<int32_t>(i);
+            document.accessors[i].count = 6;
+            document.accessors[i].componentType = fx::gltf::Accessor::ComponentType::Float;
+            document.accessors[i].type = fx::gltf::Accessor::Type::Scalar;
+        }
+
+        // bufferView 4 repeats the bytes of bufferView 2, accessor 5 repeats accessor 2
+        document.accessors.push_back(document.accessors[2]);
+
+        document.meshes.resize(1);
+        document.meshes[0].primitives.resize(2);
+        document.meshes[0].primitives[0].attributes["WEIGHTS_0"] = 4;
+        document.meshes[0].primitives[0].attributes["TEXCOORD_0"] = 3;
+        document.meshes[0].primitives[1].attributes["WEIGHTS_0"] = 2;
+        document.meshes[0].primitives[1].attributes["TEXCOORD_0"] = 5;
+        document.skins.resize(1);
+        document.skins[0].inverseBindMatrices = 1;
+
+        fx::gltf::DeduplicateData(document, 4);
+
+        REQUIRE(document.bufferViews.size() == 4);
+        REQUIRE(document.accessors.size() == 4);
+        REQUIRE(document.meshes[0].primitives[0].attributes["WEIGHTS_0"] == 2);
+        REQUIRE(document.meshes[0].primitives[0].attributes["TEXCOORD_0"] == 3);
+        REQUIRE(document.meshes[0].primitives[1].attributes["WEIGHTS_0"] == 2);
+        REQUIRE(document.meshes[0].primitives[1].attributes["TEXCOORD_0"] == 2);
+        REQUIRE(document.skins[0].inverseBindMatrices == 1);
+        REQUIRE(document.accessors[1].bufferView == 1);
+        REQUIRE(document.accessors[3].bufferView == 3);
+        REQUIRE(document.bufferViews[3].byteOffset == 2 * LargeSize + 24);
+    }
+
+    SECTION("load header only - 64-bit sizes and offsets")
+    {
+        const std::string text = R"({
+            "asset": { "version": "2.0" },
+            "buffers": [ { "byteLength": 6000000000, "uri": "terrain.bin" } ],
+            "bufferViews": [ { "buffer": 0, "byteOffset": 4500000000, "byteLength": 1200000000 } ],
+            "accessors": [ { "bufferView": 0, "byteOffset": 4294967300, "componentType": 5126, "count": 3, "type": "VEC3" } ]
+        })";
+
+        std::istringstream defaultQuotas(text);
+        REQUIRE_THROWS_WITH(fx::gltf::LoadFromTextHeaderOnly(defaultQuotas), Catch::Contains("MaxBufferByteLength"));
+
+        fx::gltf::ReadQuotas readQuotas{};
+        readQuotas.MaxBufferByteLength = 8ull * 1024 * 1024 * 1024;
+
+        std::istringstream input(text);
+        fx::gltf::DocumentHeader header = fx::gltf::LoadFromTextHeaderOnly(input, readQuotas);
+        REQUIRE(header.document.buffers[0].byteLength == 6000000000ull);
+        REQUIRE(header.document.bufferViews[0].byteOffset == 4500000000ull);
+        REQUIRE(header.document.bufferViews[0].byteLength == 1200000000ull);
+        REQUIRE(header.document.accessors[0].byteOffset == 4294967300ull);
+
+        const nlohmann::json json = header.document;
+        REQUIRE(json["bufferViews"][0]["byteOffset"].get<uint64_t>() == 4500000000ull);
+        REQUIRE(json["accessors"][0]["byteOffset"].get<uint64_t>() == 4294967300ull);
+    }
+
     SECTION("load text - save text streams")
     {
         FX_GLTF_FILESYSTEM::path originalFile1{ "data/glTF-Sample-Models/2.0/Box/glTF/Box.gltf" };